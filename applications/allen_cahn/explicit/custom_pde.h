@@ -29,11 +29,12 @@ public:
 
 private:
   void
-  set_initial_condition([[maybe_unused]] const unsigned int       &index,
-                        [[maybe_unused]] const unsigned int       &component,
-                        [[maybe_unused]] const dealii::Point<dim> &point,
-                        [[maybe_unused]] number                   &scalar_value,
-                        [[maybe_unused]] number &vector_component_value) const override
+  set_vectorized_initial_condition(
+    [[maybe_unused]] const unsigned int   &index,
+    [[maybe_unused]] const unsigned int   &component,
+    const dealii::Point<dim, ScalarValue> &points,
+    ScalarValue                           &scalar_value,
+    [[maybe_unused]] ScalarValue          &vector_component_value) const override
   {
     const dealii::Tensor<1, dim> &mesh_size =
       get_user_inputs().spatial_discretization.rectangular_mesh.size;
@@ -53,20 +54,23 @@ private:
       {0.7, 0.95, 0}
     };
     constexpr number rad[12] = {12, 14, 19, 16, 11, 12, 17, 15, 20, 10, 11, 14};
-    number           dist    = 0.0;
+    ScalarValue      dist    = 0.0;
     for (unsigned int i = 0; i < 12; i++)
       {
         dist = 0.0;
         for (unsigned int dir = 0; dir < dim; dir++)
           {
-            const number comp_diff = point[dir] - center[i][dir] * mesh_size[dir];
+            const ScalarValue comp_diff = points[dir] - center[i][dir] * mesh_size[dir];
             dist += comp_diff * comp_diff;
           }
         dist = std::sqrt(dist);
 
-        scalar_value += 0.5 * (1.0 - std::tanh((dist - rad[i]) / 1.5));
+        // 0.5 * (1 - tanh(x)) = 1 / (1 + exp(2x)), written with the functions that
+        // VectorizedArray provides
+        scalar_value +=
+          1.0 / (1.0 + std::exp((2.0 / 1.5) * (dist - ScalarValue(rad[i]))));
       }
-    scalar_value = std::min(scalar_value, number(1.0));
+    scalar_value = std::min(scalar_value, ScalarValue(1.0));
   }
 
   void
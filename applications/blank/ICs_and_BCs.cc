@@ -3,7 +3,6 @@
 
 #include "custom_pde.h"
 
-#include <prismspf/core/dirichlet.h>
 #include <prismspf/core/initial_conditions.h>
 
 #include <prismspf/user_inputs/user_input_parameters.h>
@@ -38,11 +38,15 @@ main(int argc, char *argv[])
   UserInputParameters<dim>       user_inputs(cli_options.get_parameters_filename());
   PhaseFieldTools<dim>           pf_tools;
   CustomPDE<dim, degree, double> pde_operator(user_inputs, pf_tools);
-  Problem<dim, degree, double>   problem(fields,
+  // The same PDE with linear elements. With the GMG preconditioner, it evaluates the
+  // p-multigrid levels below the active mesh.
+  CustomPDE<dim, 1, double>    coarse_pde_operator(user_inputs, pf_tools);
+  Problem<dim, degree, double> problem(fields,
                                        solve_blocks,
                                        user_inputs,
                                        pf_tools,
-                                       pde_operator);
+                                       pde_operator,
+                                       &coarse_pde_operator);
   problem.solve();
 
   return 0;
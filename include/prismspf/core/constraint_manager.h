@@ -4,10 +4,10 @@
 #pragma once
 
 #include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/point.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/lac/affine_constraints.h>
-#include <deal.II/multigrid/mg_constrained_dofs.h>
 
 #include <prismspf/core/dof_manager.h>
 #include <prismspf/core/field_attributes.h>
@@ -137,6 +137,13 @@ public:
   /**
    * @brief Update time-dependent constraints.
    * For now this only updates the Dirichlet constraints.
+   *
+   * The structure of the constraints (periodicity, hanging nodes, and which DoFs are
+   * Dirichlet) does not change between increments, so only the inhomogeneities of the
+   * cached Dirichlet DoFs are reevaluated. If a periodic or hanging node constraint
+   * depends on a Dirichlet DoF, the field constraint is rebuilt from the cached
+   * structural part so the inhomogeneity propagates through close(). The multigrid level
+   * constraints are homogeneous and are left untouched.
    */
   void
   update_time_dependent_constraints(const std::vector<FieldAttributes> &field_attributes);
@@ -160,17 +167,39 @@ private:
                                     unsigned int relative_level = -1);
 
   /**
-   * @brief Add boundary conditions to a single constraint.
+   * @brief Cache the Dirichlet DoFs and their support points of a single field. This
+   * follows dealii::VectorTools::interpolate_boundary_values in that DoFs that are
+   * already constrained, or claimed by an earlier boundary, are skipped.
+   */
+  void
+  make_dirichlet_dof_cache(const dealii::AffineConstraints<number> &structural_constraint,
+                           const dealii::DoFHandler<dim>           &dof_handler,
+                           const BoundaryConditionSet              &boundary_condition,
+                           TensorRank                               tensor_rank,
+                           Types::Index                             field_index);
+
+  /**
+   * @brief Evaluate the Dirichlet values of the cached DoFs of a field in vectorized
+   * batches and write them as inhomogeneities. If add_lines is true the constraint
+   * lines are created as well.
+   */
+  void
+  set_dirichlet_values(dealii::AffineConstraints<number> &constraint,
+                       TensorRank                         tensor_rank,
+                       Types::Index                       field_index,
+                       bool                               add_lines) const;
+
+  /**
+   * @brief Add homogeneous boundary conditions to a single multigrid level constraint.
    */
   void
   make_bc_constraints(dealii::AffineConstraints<number> &constraint,
                       const dealii::DoFHandler<dim>     &dof_handler,
                       const BoundaryConditionSet        &boundary_condition,
-                      TensorRank                         tensor_rank,
-                      Types::Index                       field_index);
+                      TensorRank                         tensor_rank);
 
   /**
-   * @brief Apply constraints for common boundary conditions.
+   * @brief Apply homogeneous constraints for common boundary conditions.
    */
   void
   make_one_boundary_constraint(dealii::AffineConstraints<number> &_constraints,
@@ -178,19 +207,16 @@ private:
                                unsigned int                       component,
                                Condition                          boundary_type,
                                const dealii::DoFHandler<dim>     &dof_handler,
-                               TensorRank                         tensor_rank,
-                               Types::Index                       field_index) const;
+                               TensorRank                         tensor_rank) const;
 
   /**
-   * @brief Make dirichlet constraints.
+   * @brief Make zero dirichlet constraints.
    */
   void
-  make_dirichlet_constraints(dealii::AffineConstraints<number> &_constraints,
-                             const dealii::DoFHandler<dim>     &dof_handler,
-                             const unsigned int                &boundary_id,
-                             const unsigned int                &field_index,
-                             const bool                        &is_vector_field,
-                             const dealii::ComponentMask       &mask) const;
+  make_zero_dirichlet_constraints(dealii::AffineConstraints<number> &_constraints,
+                                  const dealii::DoFHandler<dim>     &dof_handler,
+                                  const unsigned int                &boundary_id,
+                                  const dealii::ComponentMask       &mask) const;
 
   /**
    * @brief User-inputs constraint parameters.
@@ -222,14 +248,45 @@ private:
    */
   std::vector<dealii::AffineConstraints<number>> field_constraints;
 
+  /**
+   * @brief Dirichlet DoFs of a field that share a boundary id and component.
+   */
+  struct DirichletDoFs
+  {
+    unsigned int boundary_id = 0;
+
+    unsigned int component = 0;
+
+    std::vector<dealii::types::global_dof_index> dof_indices;
+
+    std::vector<dealii::Point<dim>> support_points;
+  };
+
+  /**
+   * @brief Cached Dirichlet DoFs. Outer vector is indexed by field index.
+   */
+  std::vector<std::vector<DirichletDoFs>> dirichlet_dofs;
+
+  /**
+   * @brief Periodicity and hanging node constraints, before closing, for fields with
+   * time-dependent boundary conditions. Indexed by field index.
+   */
+  std::vector<dealii::AffineConstraints<number>> structural_constraints;
+
+  /**
+   * @brief Whether a time-dependent update of a field only needs to overwrite the
+   * inhomogeneities, i.e., no structural constraint references a Dirichlet DoF.
+   */
+  std::vector<bool> inhomogeneity_only;
+
   /**
    * @brief Constraints not specific to any field. We need this for invm
    */
   std::array<dealii::AffineConstraints<number>, 2> generic_constraints;
 
   /**
-   * @brief Constraints. Outer vector is indexed by field index. Inner vector is indexed
-   * by relative mg level.
+   * @brief Constraints on the DoFHandlers of the coarsened triangulations. Outer vector
+   * is indexed by relative mg level. Inner vector is indexed by field index.
    */
   std::vector<std::vector<dealii::AffineConstraints<number>>> mg_field_constraints;
 
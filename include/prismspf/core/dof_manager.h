@@ -15,6 +15,9 @@
 
 #include <prismspf/config.h>
 
+#include <memory>
+#include <vector>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 /**
@@ -47,12 +50,28 @@ public:
   /**
    * @brief Reinitialize the DoFHandlers
    * @param triangulation_manager The triangulation manager.
-   * @param init_mg Whether to initialize the multigrid DoFHandlers.
-   * @pre init() must have been called with the correct number of levels.
+   * @param init_mg Whether to initialize the multigrid DoFHandlers. These are built on
+   * the coarsened triangulations of the triangulation manager, one per relative level,
+   * plus the linear level of the p-coarsening if it is enabled.
    */
   void
   reinit(const TriangulationManager<dim> &triangulation_manager, bool init_mg = false);
 
+  /**
+   * @brief Enable p-multigrid. Relative level 1 then has linear elements on the active
+   * mesh, and the geometric levels below it use linear elements too.
+   * @pre degree > 1.
+   */
+  void
+  set_p_coarsening(bool _p_coarsening);
+
+  /**
+   * @brief Release the multigrid DoFHandlers. This must happen before the coarsened
+   * triangulations they are attached to are rebuilt.
+   */
+  void
+  clear_mg();
+
   /**
    * @brief Reinitialize the DoFHandlers
    * @pre reinit() must have been called.
@@ -94,17 +113,50 @@ public:
   get_dof_handler(const unsigned int &rank) const;
 
   /**
-   * @brief Has distribute_mg_dofs() been called?
+   * @brief Getter function for all the DoFHandlers on a multigrid level.
+   * @pre reinit_mapping() must have been called.
+   */
+  [[nodiscard]] const std::vector<const dealii::DoFHandler<dim> *> &
+  get_mg_field_dof_handlers(unsigned int relative_level) const;
+
+  /**
+   * @brief Getter function for the DoFHandler of a field on a multigrid level.
+   * @pre reinit_mapping() must have been called.
+   */
+  [[nodiscard]] const dealii::DoFHandler<dim> &
+  get_mg_field_dof_handler(Types::Index field_index, unsigned int relative_level) const;
+
+  /**
+   * @brief Getter function for the scalar and vector DoFHandlers on a multigrid level.
+   * Relative level 0 is the active mesh and shares the DoFHandlers of get_dof_handlers().
+   */
+  [[nodiscard]] const std::array<dealii::DoFHandler<dim>, 2> &
+  get_mg_dof_handlers(unsigned int relative_level) const;
+
+  /**
+   * @brief Have the multigrid DoFHandlers been initialized?
    */
   [[nodiscard]] bool
   has_mg() const;
 
   /**
-   * @brief Get the total number of levels in the triangulation.
+   * @brief Get the total number of multigrid levels, including the active mesh.
    */
   [[nodiscard]] unsigned int
   num_levels() const;
 
+  /**
+   * @brief Whether the multigrid levels below the active mesh use linear elements.
+   */
+  [[nodiscard]] bool
+  has_p_coarsening() const;
+
+  /**
+   * @brief Get the element degree of a multigrid level.
+   */
+  [[nodiscard]] unsigned int
+  get_mg_degree(unsigned int relative_level) const;
+
   /**
    * @brief Get the total DoFs excluding multigrid DoFs.
    * @pre reinit_mapping() must have been called.
@@ -114,7 +166,13 @@ public:
 
 private:
   /**
-   * @brief Pointers to the dof handlers for each field on every mg level.
+   * @brief Rebuild the field pointers of the multigrid levels.
+   */
+  void
+  reinit_mg_mapping();
+
+  /**
+   * @brief Pointers to the dof handlers for each field on the active mesh.
    * Vector is indexed by field index.
    */
   std::vector<const dealii::DoFHandler<dim> *> field_dof_handlers;
@@ -123,6 +181,30 @@ private:
    * @brief A scalar and a vector dof handler
    */
   std::array<dealii::DoFHandler<dim>, 2> level_dof_handlers;
+
+  /**
+   * @brief Tensor rank of each field. Kept so the multigrid mapping can be rebuilt when
+   * the levels change.
+   */
+  std::vector<unsigned int> field_ranks;
+
+  /**
+   * @brief Whether the multigrid levels below the active mesh use linear elements.
+   */
+  bool p_coarsening = false;
+
+  /**
+   * @brief A scalar and a vector dof handler on each coarsened triangulation. Indexed by
+   * relative level. Relative level 0 is the active mesh, so its entry is empty. With
+   * p-coarsening, relative level r > 0 is on coarsened triangulation r - 1.
+   */
+  std::vector<std::unique_ptr<std::array<dealii::DoFHandler<dim>, 2>>> mg_dof_handlers;
+
+  /**
+   * @brief Pointers to the dof handlers for each field on every mg level. Outer vector
+   * is indexed by relative level, inner vector by field index.
+   */
+  std::vector<std::vector<const dealii::DoFHandler<dim> *>> mg_field_dof_handlers;
 };
 
 PRISMS_PF_END_NAMESPACE
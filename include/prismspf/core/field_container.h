@@ -21,6 +21,8 @@
 #include <prismspf/core/type_enums.h>
 #include <prismspf/core/types.h>
 
+#include <prismspf/utilities/dual_number.h>
+
 #include <prismspf/config.h>
 
 #include <utility>
@@ -67,6 +69,12 @@ public:
   template <TensorRank Rank>
   using Hessian = dealii::Tensor<int(Rank) + 2, dim, ScalarValue>;
 
+  template <TensorRank Rank>
+  using DualValue = DualNumber<Value<Rank>>;
+
+  template <TensorRank Rank>
+  using DualGradient = DualNumber<Gradient<Rank>>;
+
   template <TensorRank Rank>
   using FEEval =
     dealii::FEEvaluation<dim,
@@ -319,6 +327,26 @@ public:
   [[nodiscard]] Value<Rank>
   get_value(Types::Index field_index, DependencyType type) const;
 
+  /**
+   * @brief Return the value of the specified field as a dual number. If the container is
+   * linearized, the dual part of the current value of a field of the solve block is the
+   * value of its change. Otherwise, the dual part is zero.
+   */
+  template <TensorRank Rank>
+  [[nodiscard]] DualValue<Rank>
+  get_dual_value(Types::Index   field_index,
+                 DependencyType type = DependencyType::Current) const;
+
+  /**
+   * @brief Return the gradient of the specified field as a dual number. If the container
+   * is linearized, the dual part of the current gradient of a field of the solve block
+   * is the gradient of its change. Otherwise, the dual part is zero.
+   */
+  template <TensorRank Rank>
+  [[nodiscard]] DualGradient<Rank>
+  get_dual_gradient(Types::Index   field_index,
+                    DependencyType type = DependencyType::Current) const;
+
   /**
    * @brief Return the gradient of the specified field.
    */
@@ -449,6 +477,32 @@ public:
   void
   set_gradient_term(Types::Index field_index, const GradType &val);
 
+  /**
+   * @brief Set the value of the specified scalar/vector field from a dual number. If the
+   * container is linearized, the negated dual part is submitted, see jacobian_term(),
+   * otherwise the value.
+   */
+  template <typename ValType>
+  void
+  set_value_term(Types::Index field_index, const DualNumber<ValType> &val);
+
+  /**
+   * @brief Set the gradient of the specified scalar/vector field from a dual number. If
+   * the container is linearized, the negated dual part is submitted, see jacobian_term(),
+   * otherwise the value.
+   */
+  template <typename GradType>
+  void
+  set_gradient_term(Types::Index field_index, const DualNumber<GradType> &val);
+
+  /**
+   * @brief Set whether the dual numbers are seeded with the change of the fields of the
+   * solve block, so that equations written with dual numbers submit their linearization.
+   * @pre The change of each field of the solve block is evaluated like its current value.
+   */
+  void
+  set_linearize(bool _linearize);
+
   /**
    * @brief Get the dof values directly from a node.
    */
@@ -551,6 +605,17 @@ private:
    * @brief The quadrature point.
    */
   unsigned int q_point = 0;
+
+  /**
+   * @brief Whether the dual numbers are seeded with the change of the fields of the
+   * solve block.
+   */
+  bool linearize = false;
+
+  /**
+   * @brief Whether each field is linearized, indexed by field index.
+   */
+  std::vector<bool> linearized_fields;
 };
 
 inline static const std::map<DependencyType, std::string> dependency_type_to_string = {
@@ -1082,6 +1147,44 @@ inline DEAL_II_ALWAYS_INLINE
   ReturnGetter(get_value, Rank, field_index, type, GetterNoTempl);
 }
 
+template <unsigned int dim, unsigned int degree, typename number>
+template <TensorRank Rank>
+inline DEAL_II_ALWAYS_INLINE
+  typename FieldContainer<dim, degree, number>::template DualValue<Rank>
+  FieldContainer<dim, degree, number>::get_dual_value(Types::Index   field_index,
+                                                      DependencyType type) const
+{
+  const Value<Rank> value = get_value<Rank>(field_index, type);
+  if (linearize && type == DependencyType::Current && linearized_fields[field_index])
+    {
+      return DualValue<Rank>(value, get_value<Rank>(field_index, DependencyType::SRC));
+    }
+  if constexpr (std::is_same_v<Value<Rank>, ScalarValue>)
+    {
+      return DualValue<Rank>(value, ScalarValue(0.0));
+    }
+  else
+    {
+      return DualValue<Rank>(value, Value<Rank>());
+    }
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+template <TensorRank Rank>
+inline DEAL_II_ALWAYS_INLINE
+  typename FieldContainer<dim, degree, number>::template DualGradient<Rank>
+  FieldContainer<dim, degree, number>::get_dual_gradient(Types::Index   field_index,
+                                                         DependencyType type) const
+{
+  const Gradient<Rank> gradient = get_gradient<Rank>(field_index, type);
+  if (linearize && type == DependencyType::Current && linearized_fields[field_index])
+    {
+      return DualGradient<Rank>(gradient,
+                                get_gradient<Rank>(field_index, DependencyType::SRC));
+    }
+  return DualGradient<Rank>(gradient, Gradient<Rank>());
+}
+
 template <unsigned int dim, unsigned int degree, typename number>
 template <TensorRank Rank, DependencyType type>
 inline DEAL_II_ALWAYS_INLINE
@@ -1314,6 +1417,26 @@ FieldContainer<dim, degree, number>::set_gradient_term(Types::Index    field_ind
     }
 }
 
+template <unsigned int dim, unsigned int degree, typename number>
+template <typename ValType>
+inline DEAL_II_ALWAYS_INLINE void
+FieldContainer<dim, degree, number>::set_value_term(
+  Types::Index               field_index,
+  const DualNumber<ValType> &val)
+{
+  set_value_term(field_index, linearize ? jacobian_term(val) : val.value);
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+template <typename GradType>
+inline DEAL_II_ALWAYS_INLINE void
+FieldContainer<dim, degree, number>::set_gradient_term(
+  Types::Index                field_index,
+  const DualNumber<GradType> &val)
+{
+  set_gradient_term(field_index, linearize ? jacobian_term(val) : val.value);
+}
+
 template <unsigned int dim, unsigned int degree, typename number>
 template <typename ValType>
 inline DEAL_II_ALWAYS_INLINE void
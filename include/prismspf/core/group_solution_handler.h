@@ -23,6 +23,8 @@
 
 #include <prismspf/config.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 PRISMS_PF_BEGIN_NAMESPACE
@@ -61,6 +63,8 @@ public:
   using SolutionTransfer =
     dealii::parallel::distributed::SolutionTransfer<dim, SolutionVector<number>>;
 #endif
+  using MGTwoLevelTransfer = dealii::MGTwoLevelTransfer<dim, SolutionVector<number>>;
+  using MGTransfer = dealii::MGTransferGlobalCoarsening<dim, SolutionVector<number>>;
 
   /**
    * @brief Constructor.
@@ -119,6 +123,12 @@ public:
   [[nodiscard]] const SolutionVector<number> &
   get_old_solution_vector(unsigned int age, unsigned int global_index) const;
 
+  /**
+   * @brief Get a stage vector of a multi-stage time integrator.
+   */
+  [[nodiscard]] BlockVector<number> &
+  get_stage_vector(unsigned int stage);
+
   /**
    * @brief Get the solutions object at a level.
    */
@@ -187,6 +197,14 @@ public:
   void
   reinit();
 
+  /**
+   * @brief Allocate the stage vectors of a multi-stage time integrator. They have the
+   * shape of the solution vector and are reinitialized, but not transferred, when the
+   * mesh changes.
+   */
+  void
+  init_stage_vectors(unsigned int n_stages);
+
   /**
    * @brief Update the ghost values.
    */
@@ -231,29 +249,54 @@ public:
   update();
 
   /**
-   * @brief Reinit the solution transfer objects.
+   * @brief Copy the solutions and old solutions of every level, so that the increment
+   * can be rolled back.
    */
   void
-  init_solution_transfer();
+  save_snapshot();
 
   /**
-   * @brief Prepare for solution transfer
+   * @brief Roll back to the last snapshot. The snapshot is swapped in rather than copied,
+   * so it has to be saved again before the next roll back.
    */
   void
-  prepare_for_solution_transfer();
+  restore_snapshot();
 
   /**
-   * @brief Transfer solutions
+   * @brief Keep the first old solutions, i.e., the state at the start of the increment,
+   * before the solve block is subcycled.
    */
   void
-  execute_solution_transfer();
+  begin_substeps();
 
   /**
-   * @brief Reinit the solution transfer objects.
+   * @brief Make the current solutions the first old solutions for the next substep.
+   */
+  void
+  advance_substep();
+
+  /**
+   * @brief Restore the first old solutions kept by begin_substeps(), so that the ages of
+   * the old solutions count increments again.
+   */
+  void
+  end_substeps();
+
+  /**
+   * @brief Reinit the multigrid transfer objects. The levels are the DoFHandlers on the
+   * coarsened triangulations, so the transfer also works across hanging nodes.
    */
   template <unsigned int degree>
   void
-  reinit_mg_transfer(const DoFManager<dim, degree> &dof_manager);
+  reinit_mg_transfer(const DoFManager<dim, degree>                &dof_manager,
+                     const ConstraintManager<dim, degree, number> &constraint_manager);
+
+  /**
+   * @brief Release the multigrid transfer objects, e.g., before the levels are rebuilt
+   * after grid refinement.
+   */
+  void
+  clear_mg_transfer();
 
   /**
    * @brief Transfer solutions to mg levels
@@ -261,7 +304,6 @@ public:
   template <unsigned int degree>
   void
   mg_transfer_down(const DoFManager<dim, degree> &dof_manager,
-                   unsigned int                   finest_level,
                    bool                           transfer_old_solutions = false);
 
   /**
@@ -297,6 +339,22 @@ private:
    */
   SolutionLevel<dim, number> primary_solutions;
 
+  /**
+   * @brief Stage vectors of multi-stage time integrators.
+   */
+  std::vector<BlockVector<number>> stage_solutions;
+
+  /**
+   * @brief Snapshot of the primary solutions followed by the mg levels.
+   */
+  std::vector<SolutionLevel<dim, number>> snapshot;
+
+  /**
+   * @brief First old solutions of the primary solutions and each mg level at the start
+   * of a subcycled increment.
+   */
+  std::vector<BlockVector<number>> substep_start;
+
   /**
    * @brief Solutions projected to each mg level as dependencies.
    */
@@ -319,61 +377,100 @@ private:
   std::vector<SolutionTransfer> block_solution_transfer;
 
   /**
-   * @brief Constraints needed for mg transfer object.
+   * @brief Transfer between consecutive multigrid levels for each block. Level l maps
+   * from level l - 1 to level l, where the finest level is num_levels() - 1.
    */
-  std::vector<dealii::MGConstrainedDoFs> mg_constraints;
+  std::vector<dealii::MGLevelObject<MGTwoLevelTransfer>> mg_two_level_transfer;
 
   /**
    * @brief Utility object to transfer solutions between multigrid levels.
    */
-  std::vector<dealii::MGTransferMatrixFree<dim, number>> mg_transfer;
+  std::vector<std::unique_ptr<MGTransfer>> mg_transfer;
 };
 
 template <unsigned int dim, typename number>
 template <unsigned int degree>
 inline void
 GroupSolutionHandler<dim, number>::reinit_mg_transfer(
-  const DoFManager<dim, degree> &dof_manager)
+  const DoFManager<dim, degree>                &dof_manager,
+  const ConstraintManager<dim, degree, number> &constraint_manager)
 {
-  // 1. Initialize constraints
   const unsigned int num_blocks = solve_block.field_indices.size();
-  mg_constraints                = std::vector<dealii::MGConstrainedDoFs>(num_blocks);
-  mg_transfer = std::vector<dealii::MGTransferMatrixFree<dim, number>>(num_blocks);
+  const unsigned int n_levels   = solution_levels.size();
+  AssertThrow(n_levels <= dof_manager.num_levels(),
+              dealii::ExcMessage("The mg depth (" + std::to_string(n_levels) +
+                                 ") is larger than the number of levels in the "
+                                 "coarsening sequence (" +
+                                 std::to_string(dof_manager.num_levels()) + ")"));
+
+  // The transfers reference the two-level objects, so the latter are built in place.
+  mg_transfer.clear();
+  mg_two_level_transfer.clear();
+  mg_two_level_transfer.resize(num_blocks);
+  mg_transfer.resize(num_blocks);
   for (unsigned int block_index = 0; block_index < num_blocks; block_index++)
     {
-      unsigned int field_index = block_to_global_index[block_index];
-      mg_constraints[block_index].initialize(
-        dof_manager.get_field_dof_handler(field_index));
-      // 2. Initialize MG Transfer
-      mg_transfer[block_index].initialize_constraints(mg_constraints[block_index]);
-      mg_transfer[block_index].build(dof_manager.get_field_dof_handler(field_index));
+      const unsigned int field_index = block_to_global_index[block_index];
+
+      // 1. Two-level transfers. The level constraints carry the hanging nodes of the
+      // coarsened meshes.
+      auto &two_level_transfer = mg_two_level_transfer[block_index];
+      two_level_transfer.resize(0, n_levels - 1);
+      for (unsigned int level = 1; level < n_levels; ++level)
+        {
+          const unsigned int fine_relative_level = n_levels - 1 - level;
+          two_level_transfer[level].reinit(
+            dof_manager.get_mg_field_dof_handler(field_index, fine_relative_level),
+            dof_manager.get_mg_field_dof_handler(field_index, fine_relative_level + 1),
+            constraint_manager.get_mg_field_constraint(field_index, fine_relative_level),
+            constraint_manager.get_mg_field_constraint(field_index,
+                                                       fine_relative_level + 1));
+        }
+
+      // 2. Initialize MG Transfer. Level vectors share the partitioners of the level
+      // MatrixFree objects.
+      mg_transfer[block_index] = std::make_unique<MGTransfer>(
+        two_level_transfer,
+        [this, field_index, n_levels](const unsigned int      level,
+                                      SolutionVector<number> &vector)
+        {
+          const unsigned int relative_level = n_levels - 1 - level;
+          vector.reinit(matrix_free_manager->get_mg_shared_matrix_free(relative_level)
+                          .get_vector_partitioner(field_index));
+        });
     }
 }
 
+template <unsigned int dim, typename number>
+inline void
+GroupSolutionHandler<dim, number>::clear_mg_transfer()
+{
+  mg_transfer.clear();
+  mg_two_level_transfer.clear();
+}
+
 template <unsigned int dim, typename number>
 template <unsigned int degree>
 inline void
 GroupSolutionHandler<dim, number>::mg_transfer_down(
   const DoFManager<dim, degree> &dof_manager,
-  unsigned int                   finest_level,
   bool                           transfer_old_solutions)
 {
   Timer::start_section("MG Transfer LHS Dependencies");
-  const unsigned int num_blocks = solve_block.field_indices.size();
+  const unsigned int num_blocks   = solve_block.field_indices.size();
+  const unsigned int finest_level = solution_levels.size() - 1;
   for (unsigned int block_index = 0; block_index < num_blocks; block_index++)
     {
       unsigned int field_index = block_to_global_index[block_index];
-      dealii::MGLevelObject<SolutionVector<number>> temp_mg_solutions(
-        1 + finest_level - solution_levels.size(),
-        finest_level);
+      dealii::MGLevelObject<SolutionVector<number>> temp_mg_solutions(0, finest_level);
 
       const auto &dof_handler = dof_manager.get_field_dof_handler(field_index);
 
       // transfer regular solutions to mg levels
-      mg_transfer[block_index].interpolate_to_mg(dof_handler,
-                                                 temp_mg_solutions,
-                                                 primary_solutions.solutions.block(
-                                                   block_index));
+      mg_transfer[block_index]->interpolate_to_mg(dof_handler,
+                                                  temp_mg_solutions,
+                                                  primary_solutions.solutions.block(
+                                                    block_index));
       // swap to actual mg solution vectors
       for (unsigned int relative_level = 0; relative_level < solution_levels.size();
            ++relative_level)
@@ -389,18 +486,18 @@ GroupSolutionHandler<dim, number>::mg_transfer_down(
 
       if (!transfer_old_solutions)
         {
-          Timer::end_section("MG Transfer LHS Dependencies");
-          return;
+          continue;
         }
       // Transfer old solutions
       for (unsigned int age_index = 0;
-           age_index < solution_levels[0].old_solutions.size();
+           age_index < solution_levels[0].old_solutions.size() &&
+           age_index < primary_solutions.old_solutions.size();
            ++age_index)
         {
-          mg_transfer[block_index].interpolate_to_mg(
+          mg_transfer[block_index]->interpolate_to_mg(
             dof_handler,
             temp_mg_solutions,
-            solution_levels[0].old_solutions[age_index].block(block_index));
+            primary_solutions.old_solutions[age_index].block(block_index));
           for (unsigned int relative_level = 0; relative_level < solution_levels.size();
                ++relative_level)
             {
@@ -5,6 +5,8 @@
 
 #include <deal.II/base/function.h>
 #include <deal.II/base/point.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/vector.h>
 
 #include <prismspf/core/type_enums.h>
@@ -61,6 +63,43 @@ private:
   const PDEOperatorBase<dim, degree, number> *pde_operator;
 };
 
+/**
+ * @brief Batched evaluation of user-implemented initial conditions.
+ *
+ * Unlike InitialCondition, this does not go through dealii::VectorTools::interpolate. The
+ * support points of each locally owned cell are packed into VectorizedArray batches and
+ * handed to PDEOperatorBase::set_vectorized_initial_condition, so there is one virtual
+ * call per batch and component instead of one per support point. Cells are distributed
+ * across threads with WorkStream. Applications that only implement the pointwise
+ * set_initial_condition are evaluated one support point at a time on a single thread,
+ * because they may use shared state such as a random number generator.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class VectorizedInitialCondition
+{
+public:
+  /**
+   * @brief Constructor.
+   */
+  VectorizedInitialCondition(const unsigned int                         &_index,
+                             const TensorRank                           &_field_type,
+                             const PDEOperatorBase<dim, degree, number> &_pde_operator);
+
+  /**
+   * @brief Interpolate the initial condition into the locally owned entries of a vector.
+   */
+  void
+  interpolate(const dealii::DoFHandler<dim>                     &dof_handler,
+              dealii::LinearAlgebra::distributed::Vector<number> &dst) const;
+
+private:
+  unsigned int index;
+
+  TensorRank field_type;
+
+  const PDEOperatorBase<dim, degree, number> *pde_operator;
+};
+
 /**
  * @brief Function for read-in of initial conditions.
  */
@@ -123,7 +123,10 @@ private: // todo: move to outside class body
   compute_scalar_invm()
   {
     const MatrixFree<dim, number> &matrix_free = mf_manager().get_generic_matrix_free();
-    matrix_free.cell_loop(&InvMManager::compute_local_scalar, this, jxw_scalar, 0);
+    matrix_free.cell_loop(&InvMManager::compute_local_scalar<degree>,
+                          this,
+                          jxw_scalar,
+                          0);
     invert(invm_scalar, jxw_scalar);
     //
     sqrt(invm_sqrt_scalar, invm_scalar);
@@ -134,10 +137,21 @@ private: // todo: move to outside class body
       {
         const MatrixFree<dim, number> &mg_matrix_free =
           mf_manager().get_mg_generic_matrix_free(i);
-        mg_matrix_free.cell_loop(&InvMManager::compute_local_scalar,
-                                 this,
-                                 mg_jxw_scalar[i],
-                                 0);
+        // The p-multigrid levels have linear elements
+        if (mg_matrix_free.get_dof_handler(0).get_fe().degree == degree)
+          {
+            mg_matrix_free.cell_loop(&InvMManager::compute_local_scalar<degree>,
+                                     this,
+                                     mg_jxw_scalar[i],
+                                     0);
+          }
+        else
+          {
+            mg_matrix_free.cell_loop(&InvMManager::compute_local_scalar<1>,
+                                     this,
+                                     mg_jxw_scalar[i],
+                                     0);
+          }
         invert(mg_invm_scalar[i], mg_jxw_scalar[i]);
         //
         sqrt(mg_invm_sqrt_scalar[i], mg_invm_scalar[i]);
@@ -151,7 +165,10 @@ private: // todo: move to outside class body
   compute_vector_invm()
   {
     const MatrixFree<dim, number> &matrix_free = mf_manager().get_generic_matrix_free();
-    matrix_free.cell_loop(&InvMManager::compute_local_vector, this, jxw_vector, 0);
+    matrix_free.cell_loop(&InvMManager::compute_local_vector<degree>,
+                          this,
+                          jxw_vector,
+                          0);
     invert(invm_vector, jxw_vector);
     //
     sqrt(invm_sqrt_vector, invm_vector);
@@ -162,10 +179,21 @@ private: // todo: move to outside class body
       {
         const MatrixFree<dim, number> &mg_matrix_free =
           mf_manager().get_mg_generic_matrix_free(i);
-        mg_matrix_free.cell_loop(&InvMManager::compute_local_vector,
-                                 this,
-                                 mg_jxw_vector[i],
-                                 0);
+        // The p-multigrid levels have linear elements
+        if (mg_matrix_free.get_dof_handler(0).get_fe().degree == degree)
+          {
+            mg_matrix_free.cell_loop(&InvMManager::compute_local_vector<degree>,
+                                     this,
+                                     mg_jxw_vector[i],
+                                     0);
+          }
+        else
+          {
+            mg_matrix_free.cell_loop(&InvMManager::compute_local_vector<1>,
+                                     this,
+                                     mg_jxw_vector[i],
+                                     0);
+          }
         invert(mg_invm_vector[i], mg_jxw_vector[i]);
         //
         sqrt(mg_invm_sqrt_vector[i], mg_invm_vector[i]);
@@ -175,18 +203,18 @@ private: // todo: move to outside class body
       }
   }
 
+  template <unsigned int fe_degree>
   void
   compute_local_scalar(const MatrixFree<dim, number>               &_data,
                        SolutionVector<number>                      &dst,
                        [[maybe_unused]] const int                  &src,
                        const std::pair<unsigned int, unsigned int> &cell_range) const
   {
-    dealii::FEEvaluation<dim, degree, degree + 1, 1, number> fe_eval(_data, 0);
+    dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, number> fe_eval(_data, 0);
     for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
       {
         fe_eval.reinit(cell);
-        for (unsigned int quad = 0; quad < SystemWide<dim, degree>::quadrature.size();
-             ++quad)
+        for (unsigned int quad = 0; quad < fe_eval.n_q_points; ++quad)
           {
             fe_eval.submit_value(dealii::make_vectorized_array<number>(1.0), quad);
           }
@@ -194,18 +222,18 @@ private: // todo: move to outside class body
       }
   }
 
+  template <unsigned int fe_degree>
   void
   compute_local_vector(const MatrixFree<dim, number>               &_data,
                        SolutionVector<number>                      &dst,
                        [[maybe_unused]] const int                  &src,
                        const std::pair<unsigned int, unsigned int> &cell_range) const
   {
-    dealii::FEEvaluation<dim, degree, degree + 1, dim, number> fe_eval(_data, 1);
+    dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, dim, number> fe_eval(_data, 1);
     for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
       {
         fe_eval.reinit(cell);
-        for (unsigned int quad = 0; quad < SystemWide<dim, degree>::quadrature.size();
-             ++quad)
+        for (unsigned int quad = 0; quad < fe_eval.n_q_points; ++quad)
           {
             fe_eval.submit_value(one, quad);
           }
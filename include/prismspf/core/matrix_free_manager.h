@@ -61,6 +61,13 @@ public:
   reinit(const DoFManager<dim, degree>                &dof_manager,
          const ConstraintManager<dim, degree, number> &constraint_manager);
 
+  /**
+   * @brief Release the multigrid levels. This must happen before the DoFHandlers of the
+   * levels are destroyed.
+   */
+  void
+  clear_mg();
+
   [[nodiscard]] const MatrixFree<dim, number> &
   get_shared_matrix_free() const;
 
@@ -157,47 +164,52 @@ MatrixFreeManager<dim, number>::reinit(
                                dealii::QGaussLobatto<1>(degree +
                                                         1)); // should dim really be 1?
   }
-  const unsigned int num_levels = dof_manager.has_mg() ? dof_manager.num_levels() : 0;
+  // The multigrid levels are built from the DoFHandlers on the coarsened triangulations,
+  // so they are ordinary active-level MatrixFree objects.
+  const unsigned int num_levels = dof_manager.num_levels();
   shared_matrix_free_levels.resize(num_levels);
   generic_matrix_free_levels.resize(num_levels);
   for (unsigned int relative_level = 0; relative_level < num_levels; ++relative_level)
     {
-      const unsigned int       fine_level = num_levels - 1;
-      const unsigned int       level      = fine_level - relative_level;
       MatrixFree<dim, number> &shared_mg_matrix_free =
         shared_matrix_free_levels[relative_level];
       MatrixFree<dim, number> &generic_mg_matrix_free =
         generic_matrix_free_levels[relative_level];
 
+      const std::array<dealii::DoFHandler<dim>, 2> &mg_dof_handlers =
+        dof_manager.get_mg_dof_handlers(relative_level);
       const std::array<dealii::AffineConstraints<number>, 2> &generic_constraints =
         constraint_manager.get_mg_generic_constraints(relative_level);
-
-      AdditionalData shared_additional_data = additional_data;
-      shared_additional_data.mg_level       = level;
+      // The p-multigrid levels have linear elements
+      const unsigned int mg_degree = dof_manager.get_mg_degree(relative_level);
 
       // Reinit shared MatrixFree
       shared_mg_matrix_free.reinit(
         SystemWide<dim, degree>::mapping,
-        dof_manager.get_field_dof_handlers(),
+        dof_manager.get_mg_field_dof_handlers(relative_level),
         constraint_manager.get_mg_field_constraints(relative_level),
-        dealii::QGaussLobatto<1>(degree + 1), // should dim really be 1?
-        shared_additional_data);
-
-      AdditionalData generic_additional_data;
-      generic_additional_data.mg_level = level;
+        dealii::QGaussLobatto<1>(mg_degree + 1), // should dim really be 1?
+        additional_data);
 
       // Reinit generic MatrixFree
       generic_mg_matrix_free.reinit(
         SystemWide<dim, degree>::mapping,
         std::vector<const dealii::DoFHandler<dim> *>(
-          {&generic_dof_handlers[0], &generic_dof_handlers[1]}),
+          {&mg_dof_handlers[0], &mg_dof_handlers[1]}),
         std::vector<const dealii::AffineConstraints<number> *>(
           {&generic_constraints[0], &generic_constraints[1]}),
-        dealii::QGaussLobatto<1>(degree + 1), // should dim really be 1?
-        generic_additional_data);
+        dealii::QGaussLobatto<1>(mg_degree + 1)); // should dim really be 1?
     }
 }
 
+template <unsigned int dim, typename number>
+void
+MatrixFreeManager<dim, number>::clear_mg()
+{
+  shared_matrix_free_levels.clear();
+  generic_matrix_free_levels.clear();
+}
+
 template <unsigned int dim, typename number>
 const MatrixFree<dim, number> &
 MatrixFreeManager<dim, number>::get_shared_matrix_free() const
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/vectorization.h>
 
 #include <prismspf/core/field_container.h>
 #include <prismspf/core/phase_field_tools.h>
@@ -12,8 +14,12 @@
 
 #include <prismspf/user_inputs/user_input_parameters.h>
 
+#include <prismspf/utilities/dual_number.h>
+
 #include <prismspf/config.h>
 
+#include <vector>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -53,6 +59,70 @@ public:
                         [[maybe_unused]] number &vector_component_value) const
   {}
 
+  /**
+   * @brief User-implemented class for setting initial conditions on a batch of points.
+   * Each lane of the VectorizedArray is an independent support point. Override this when
+   * the initial condition can be evaluated with vectorized arithmetic. It is then called
+   * from several threads at once, so it must not modify shared state. Otherwise, the
+   * pointwise set_initial_condition is called one support point at a time on a single
+   * thread, so it may use shared state such as a random number generator. Default
+   * behavior is to call the pointwise version for each lane.
+   */
+  virtual void
+  set_vectorized_initial_condition(const unsigned int                 &index,
+                                   const unsigned int                 &component,
+                                   const dealii::Point<dim, SizeType> &points,
+                                   SizeType                           &scalar_value,
+                                   SizeType &vector_component_value) const
+  {
+    // Only record that this is not overridden, see has_vectorized_initial_condition()
+    if (probing_vectorized_initial_condition)
+      {
+        probing_vectorized_initial_condition = false;
+        return;
+      }
+    for (unsigned int lane = 0; lane < SizeType::size(); ++lane)
+      {
+        dealii::Point<dim> point;
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            point[d] = points[d][lane];
+          }
+        number lane_scalar_value           = scalar_value[lane];
+        number lane_vector_component_value = vector_component_value[lane];
+        this->set_initial_condition(index,
+                                    component,
+                                    point,
+                                    lane_scalar_value,
+                                    lane_vector_component_value);
+        scalar_value[lane]           = lane_scalar_value;
+        vector_component_value[lane] = lane_vector_component_value;
+      }
+  }
+
+  /**
+   * @brief Whether set_vectorized_initial_condition is overridden for the field with the
+   * given index. It is called once at the origin to find out, where the default
+   * implementation returns without evaluating the pointwise initial condition.
+   * @note This is not thread-safe.
+   */
+  [[nodiscard]] bool
+  has_vectorized_initial_condition(unsigned int index) const
+  {
+    const dealii::Point<dim, SizeType> origin;
+    SizeType                           scalar_value           = 0.0;
+    SizeType                           vector_component_value = 0.0;
+    probing_vectorized_initial_condition                      = true;
+    set_vectorized_initial_condition(index,
+                                     0,
+                                     origin,
+                                     scalar_value,
+                                     vector_component_value);
+    const bool overridden                = probing_vectorized_initial_condition;
+    probing_vectorized_initial_condition = false;
+    return overridden;
+  }
+
   /**
    * @brief User-implemented function for setting Dirichlet boundary conditions. Default
    * behavior is to call initial conditions.
@@ -73,6 +143,41 @@ public:
                                 vector_component_value);
   }
 
+  /**
+   * @brief User-implemented function for setting Dirichlet boundary conditions on a batch
+   * of boundary support points. Each lane of the VectorizedArray is an independent point.
+   * Default behavior is to call the pointwise version for each lane.
+   */
+  virtual void
+  set_vectorized_dirichlet(const unsigned int                 &index,
+                           const unsigned int                 &boundary_id,
+                           const unsigned int                 &component,
+                           const dealii::Point<dim, SizeType> &points,
+                           const SimulationTimer              &sim_timer,
+                           SizeType                           &scalar_value,
+                           SizeType                           &vector_component_value) const
+  {
+    for (unsigned int lane = 0; lane < SizeType::size(); ++lane)
+      {
+        dealii::Point<dim> point;
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            point[d] = points[d][lane];
+          }
+        number lane_scalar_value           = scalar_value[lane];
+        number lane_vector_component_value = vector_component_value[lane];
+        this->set_dirichlet(index,
+                            boundary_id,
+                            component,
+                            point,
+                            sim_timer,
+                            lane_scalar_value,
+                            lane_vector_component_value);
+        scalar_value[lane]           = lane_scalar_value;
+        vector_component_value[lane] = lane_vector_component_value;
+      }
+  }
+
   /**
    * @brief User-implemented class for the RHS of explicit equations.
    */
@@ -91,6 +196,21 @@ public:
               [[maybe_unused]] unsigned int                         solver_id) const
   {}
 
+  /**
+   * @brief User-implemented function for the local reaction of a solve block with
+   * operator splitting. The rates are the time derivatives of the fields of the solve
+   * block, in the order of their indices, at the given values. Each lane of the
+   * VectorizedArray is an independent DoF. The rates must be computed from the values
+   * with dual arithmetic, which gives the Jacobian for the implicit reaction integrators.
+   */
+  virtual void
+  compute_reaction(
+    [[maybe_unused]] std::vector<DualNumber<SizeType>>       &rates,
+    [[maybe_unused]] const std::vector<DualNumber<SizeType>> &values,
+    [[maybe_unused]] const SimulationTimer                   &sim_timer,
+    [[maybe_unused]] unsigned int                             solver_id) const
+  {}
+
   /**
    * @brief Function called right before a solve block. Gives access to all the internal
    * classes, so you can break things here.
@@ -162,6 +282,12 @@ private:
    * @brief User triggered stop.
    */
   bool user_stop = false;
+
+  /**
+   * @brief Whether has_vectorized_initial_condition is probing the vectorized initial
+   * condition. The default implementation clears it.
+   */
+  mutable bool probing_vectorized_initial_condition = false;
 };
 
 PRISMS_PF_END_NAMESPACE
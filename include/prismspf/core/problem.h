@@ -29,12 +29,16 @@ class Problem
 public:
   /**
    * @brief Constructor.
+   * @param _coarse_pde_operator Optional PDE operator with linear elements. If it is
+   * supplied and the element degree is above one, the geometric multigrid
+   * preconditioners coarsen to linear elements on the active mesh first.
    */
   Problem(const std::vector<FieldAttributes>   &field_attributes,
           const std::vector<SolveBlock>        &solve_blocks,
           const UserInputParameters<dim>       &_user_inputs,
           PhaseFieldTools<dim>                 &_pf_tools,
-          PDEOperatorBase<dim, degree, number> &_pde_operator);
+          PDEOperatorBase<dim, degree, number> &_pde_operator,
+          PDEOperatorBase<dim, 1, number>      *_coarse_pde_operator = nullptr);
 
   /**
    * @brief Main time-stepping loop that calls solve_increment, reinit_system,
@@ -63,6 +67,46 @@ public:
   get_solve_context() const;
 
 private:
+  /**
+   * @brief Assign the solve blocks to the coupling groups of the user inputs and check
+   * that each group is a consecutive range of solve blocks that can be iterated.
+   */
+  void
+  assign_coupling_groups();
+
+  /**
+   * @brief Solve the solvers in [begin, end), which form a coupling group, with
+   * fixed-point iterations over their fields until the change over one pass is below
+   * the coupling tolerance. The iterations are accelerated with Anderson acceleration.
+   * Returns whether any solve failed or the iterations did not converge.
+   */
+  bool
+  solve_coupled(unsigned int              begin,
+                unsigned int              end,
+                const CouplingParameters &coupling,
+                SimulationTimer          &sim_timer,
+                bool                      is_output_increment,
+                bool                      is_nucleation_increment);
+
+  /**
+   * @brief Solve the solvers in [begin, end), which share the same number of substeps,
+   * unless their solve timing skips this increment. The solvers are subcycled with the
+   * timestep divided by the number of substeps. Returns whether any solve failed.
+   */
+  bool
+  solve_solvers(unsigned int     begin,
+                unsigned int     end,
+                SimulationTimer &sim_timer,
+                bool             is_output_increment,
+                bool             is_nucleation_increment);
+
+  /**
+   * @brief Estimate the maximum stable timestep of the explicit solve blocks, report it,
+   * and limit the timestep if requested.
+   */
+  void
+  update_stable_timestep(SimulationTimer &sim_timer);
+
   /**
    * @brief Field attributes.
    */
@@ -117,6 +161,23 @@ private:
    * @brief Grid refiner.
    */
   RefinementManager<dim, degree, number> grid_refiner;
+
+  /**
+   * @brief Whether the stable timestep has to be estimated again, e.g., after remeshing.
+   */
+  bool stable_timestep_outdated = true;
+
+  /**
+   * @brief Largest timestep, which is the input timestep unless it is limited by the
+   * stable timestep.
+   */
+  double max_timestep = 0.0;
+
+  /**
+   * @brief Index of the coupling group of each solve block, or invalid_unsigned_int if
+   * the solve block is not coupled.
+   */
+  std::vector<unsigned int> coupling_group_indices;
 };
 
 PRISMS_PF_END_NAMESPACE
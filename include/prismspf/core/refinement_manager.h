@@ -446,12 +446,18 @@ private:
     // Execute grid refinement
     triangulation_manager.execute_grid_refinement();
 
-    // Redistribute DoFs and reinit the solvers
-    if (triangulation_manager.has_mg())
+    // Rebuild the multigrid coarsening sequence of the new mesh. Everything that refers
+    // to the old coarsened triangulations is released first.
+    const bool has_mg = triangulation_manager.has_mg();
+    if (has_mg)
       {
+        matrix_free_manager.clear_mg();
+        dof_manager.clear_mg();
         triangulation_manager.init_mg();
       }
-    dof_manager.reinit(triangulation_manager, dof_manager.has_mg());
+
+    // Redistribute DoFs and reinit the solvers
+    dof_manager.reinit(triangulation_manager, has_mg);
     constraint_manager.reinit(solve_context->get_field_attributes());
     matrix_free_manager.reinit(dof_manager, constraint_manager);
 
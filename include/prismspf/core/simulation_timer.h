@@ -3,10 +3,16 @@
 
 #pragma once
 
+#include <deal.II/base/exceptions.h>
+
 #include <prismspf/core/types.h>
 
 #include <prismspf/config.h>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 class SimulationTimer
@@ -37,11 +43,79 @@ public:
     return time_step_size;
   }
 
+  /**
+   * @brief Maximum number of previous step sizes that are kept.
+   */
+  static constexpr unsigned int max_step_history = 3;
+
   void
   increment(double step_size)
   {
     current_increment++;
     current_time += step_size;
+    for (unsigned int age = max_step_history - 1; age > 0; --age)
+      {
+        step_history[age] = step_history[age - 1];
+      }
+    step_history[0] = step_size;
+    n_steps         = std::min(n_steps + 1, max_step_history);
+  }
+
+  /**
+   * @brief Number of previous step sizes that are known.
+   */
+  [[nodiscard]] unsigned int
+  get_n_previous_timesteps() const
+  {
+    return n_steps;
+  }
+
+  /**
+   * @brief Size of a previous step. Age 0 is the step that led to the current time.
+   */
+  [[nodiscard]] double
+  get_previous_timestep(unsigned int age) const
+  {
+    Assert(age < n_steps, dealii::ExcIndexRange(age, 0, n_steps));
+    return step_history[age];
+  }
+
+  /**
+   * @brief Coefficients c_j of the variable-step BDF approximation of the time
+   * derivative at the current time, du/dt = sum_j c_j u_j, where u_0 is the current
+   * solution and u_j the j-th old solution. They are the derivatives of the Lagrange
+   * polynomials through the previous step sizes.
+   */
+  [[nodiscard]] std::vector<double>
+  get_bdf_coefficients(unsigned int order) const
+  {
+    Assert(order <= n_steps, dealii::ExcIndexRange(order, 0, n_steps + 1));
+
+    // Time of each solution relative to the current time
+    std::vector<double> nodes(order + 1, 0.0);
+    for (unsigned int j = 1; j <= order; ++j)
+      {
+        nodes[j] = nodes[j - 1] - step_history[j - 1];
+      }
+
+    std::vector<double> coefficients(order + 1, 0.0);
+    for (unsigned int m = 1; m <= order; ++m)
+      {
+        coefficients[0] -= 1.0 / nodes[m];
+      }
+    for (unsigned int j = 1; j <= order; ++j)
+      {
+        double coefficient = 1.0 / nodes[j];
+        for (unsigned int m = 1; m <= order; ++m)
+          {
+            if (m != j)
+              {
+                coefficient *= -nodes[m] / (nodes[j] - nodes[m]);
+              }
+          }
+        coefficients[j] = coefficient;
+      }
+    return coefficients;
   }
 
   void
@@ -56,6 +130,21 @@ public:
     time_step_size = step_size;
   }
 
+  /**
+   * @brief Change the size of the step that was last taken, which moves the current time
+   * and replaces the newest entry of the step history.
+   */
+  void
+  resize_last_step(double step_size)
+  {
+    if (n_steps > 0)
+      {
+        current_time    += step_size - step_history[0];
+        step_history[0]  = step_size;
+      }
+    time_step_size = step_size;
+  }
+
   void
   set_time(double time)
   {
@@ -73,12 +162,23 @@ public:
   {
     current_increment = 0;
     current_time      = 0.0;
+    n_steps           = 0;
   }
 
 private:
   unsigned int current_increment = 0;
   double       current_time      = 0.0;
   double       time_step_size    = 0.0;
+
+  /**
+   * @brief Previous step sizes, most recent first.
+   */
+  std::array<double, max_step_history> step_history = {};
+
+  /**
+   * @brief Number of valid entries of step_history.
+   */
+  unsigned int n_steps = 0;
 };
 
 PRISMS_PF_END_NAMESPACE
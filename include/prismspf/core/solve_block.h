@@ -105,6 +105,76 @@ public:
    */
   DependencyMap dependencies_lhs;
 
+  /**
+   * @brief Time integrator. Only used for explicit solve blocks. Except for
+   * UserDefinedUpdate, the RHS is the time derivative of the fields, and the state at
+   * each stage is read through old_1.
+   */
+  ExplicitIntegrator explicit_integrator = ExplicitIntegrator::UserDefinedUpdate;
+
+  /**
+   * @brief Time integrator. Only used for linear and newton solve blocks. With a BDF
+   * integrator, M du/dt = g(u) is integrated, where the RHS is the spatial part g and
+   * the LHS its negative derivative, i.e., the equations of the steady problem. The
+   * lumped mass time derivative is added by the solver.
+   */
+  ImplicitIntegrator implicit_integrator = ImplicitIntegrator::UserDefinedResidual;
+
+  /**
+   * @brief Number of substeps per increment. Consecutive solve blocks with the same
+   * number of substeps are solved together that many times per increment with the
+   * timestep divided by it, e.g., for a stiff field that is coupled to slow ones. Between
+   * substeps, old_1 of the subcycled fields is their previous substep. Before the next
+   * increment, it is reset so that the ages of old solutions count increments for every
+   * field.
+   */
+  unsigned int n_substeps = 1;
+
+  /**
+   * @brief When the solve block is solved, e.g., only occasionally for a quasi-static
+   * field that follows a slowly evolving microstructure.
+   */
+  SolvePolicy solve_policy = SolvePolicy::SolveEveryIncrement;
+
+  /**
+   * @brief Number of increments between solves of the SolveEveryNIncrements policy.
+   */
+  unsigned int solve_period = 1;
+
+  /**
+   * @brief Tolerance of the SolveOnFieldChange and SolveOnResidual policies.
+   */
+  double solve_tolerance = 0.0;
+
+  /**
+   * @brief Operator splitting of the local reaction from the equations of the solve
+   * block, e.g., for a stiff pointwise reaction coupled with non-stiff diffusion. The
+   * reaction is the user's compute_reaction, integrated at each DoF without global
+   * coupling. The equations then start from its result, which they read through old_1.
+   * Only for solve blocks of scalar fields.
+   */
+  SplittingScheme reaction_splitting = SplittingScheme::NoSplitting;
+
+  /**
+   * @brief Time integrator of the local reaction.
+   */
+  ReactionIntegrator reaction_integrator = ReactionIntegrator::ReactionSDIRK2;
+
+  /**
+   * @brief Number of steps of the reaction integrator per reaction substep.
+   */
+  unsigned int reaction_steps = 1;
+
+  /**
+   * @brief Whether the LHS of a newton solve block is the linearization of its RHS with
+   * dual numbers instead of compute_lhs. The RHS must then read the fields of the solve
+   * block with get_dual_value and get_dual_gradient, and submit the dual numbers that
+   * depend on them. Like a hand-written compute_lhs, the LHS is the Jacobian of the
+   * residual R(u) when the RHS submits -R(u). The LHS dependencies are derived from the
+   * RHS dependencies and must not be set.
+   */
+  bool automatic_jacobian = false;
+
   /**
    * @brief Linear solver parameters. Only used for linear and newton solve blocks.
    * @note May be overridden by user input parameters.
@@ -125,6 +195,29 @@ public:
 
   void
   validate() const;
+
+  /**
+   * @brief Whether a newton solve block needs the user's Jacobian (LHS). It is not
+   * needed with an automatic Jacobian, or when the solve is Jacobian-free and no
+   * preconditioner is built from the LHS.
+   */
+  [[nodiscard]] bool
+  needs_jacobian() const;
+
+  /**
+   * @brief Check that the LHS of a newton solve block contains a Delta term of every
+   * field if the Jacobian is needed. This depends on the solver parameters, so it is
+   * checked after they are overridden by the user inputs.
+   */
+  void
+  validate_jacobian() const;
+
+  /**
+   * @brief Dependencies of the linearization of the RHS: the RHS dependencies, where the
+   * change of each field of the solve block is evaluated like its current value.
+   */
+  [[nodiscard]] DependencyMap
+  automatic_jacobian_dependencies() const;
 };
 
 inline void
@@ -152,15 +245,6 @@ SolveBlock::validate() const
                           dealii::ExcMessage(
                             "Every field in a newton solve should appear "
                             "in the residual (RHS) expression.\n"));
-              const auto &dep_it_lhs = dependencies_lhs.find(field_index);
-              AssertThrow(dep_it_lhs != dependencies_lhs.end(),
-                          dealii::ExcMessage(
-                            "Every field in a newton solve should appear as a Delta term"
-                            "in the residual Jacobian (LHS) expression.\n"));
-              AssertThrow(dep_it_lhs->second.src_flag != EvalFlags::nothing,
-                          dealii::ExcMessage(
-                            "Every field in a newton solve should appear as a Delta term"
-                            "in the residual Jacobian (LHS) expression.\n"));
             }
         }
       else
@@ -204,6 +288,73 @@ SolveBlock::validate() const
                       dealii::ExcMessage("Constant \"solves\" do not have an RHS or LHS, "
                                          "and should have no dependencies.\n"));
         }
+      if (automatic_jacobian)
+        {
+          AssertThrow(solve_type == SolveType::Newton,
+                      dealii::ExcMessage(
+                        "Only newton solves have an automatic Jacobian.\n"));
+          AssertThrow(dependencies_lhs.empty(),
+                      dealii::ExcMessage(
+                        "The LHS dependencies of a solve block with an automatic "
+                        "Jacobian are derived from its RHS dependencies.\n"));
+        }
+      if (solve_type != SolveType::Linear && solve_type != SolveType::Newton)
+        {
+          AssertThrow(implicit_integrator == ImplicitIntegrator::UserDefinedResidual,
+                      dealii::ExcMessage(
+                        "Only linear and newton solves have a BDF integrator.\n"));
+        }
+      AssertThrow(n_substeps > 0,
+                  dealii::ExcMessage("The number of substeps must be positive.\n"));
+      if (n_substeps > 1)
+        {
+          AssertThrow(solve_type != SolveType::Constant &&
+                        (solve_timing == SolveTiming::Primary ||
+                         solve_timing == SolveTiming::Secondary),
+                      dealii::ExcMessage("Only primary and secondary solve blocks that "
+                                         "are not constant can be subcycled.\n"));
+          AssertThrow(implicit_integrator == ImplicitIntegrator::UserDefinedResidual,
+                      dealii::ExcMessage(
+                        "Solve blocks with a BDF integrator cannot be subcycled, "
+                        "because their step history counts increments.\n"));
+        }
+      if (solve_policy != SolvePolicy::SolveEveryIncrement)
+        {
+          AssertThrow(n_substeps == 1,
+                      dealii::ExcMessage(
+                        "Subcycled solve blocks must be solved every increment.\n"));
+          AssertThrow(solve_period > 0,
+                      dealii::ExcMessage("The solve period must be positive.\n"));
+          AssertThrow(solve_policy == SolvePolicy::SolveEveryNIncrements ||
+                        solve_tolerance > 0.0,
+                      dealii::ExcMessage("The solve tolerance must be positive.\n"));
+          AssertThrow(solve_policy != SolvePolicy::SolveOnResidual ||
+                        solve_type == SolveType::Linear ||
+                        solve_type == SolveType::Newton,
+                      dealii::ExcMessage("Only linear and newton solves can be solved "
+                                         "depending on their residual.\n"));
+        }
+      if (reaction_splitting != SplittingScheme::NoSplitting)
+        {
+          AssertThrow(solve_type != SolveType::Constant &&
+                        solve_timing == SolveTiming::Primary,
+                      dealii::ExcMessage("Only primary solve blocks that are not "
+                                         "constant can split off a reaction.\n"));
+          AssertThrow(implicit_integrator == ImplicitIntegrator::UserDefinedResidual ||
+                        implicit_integrator == ImplicitIntegrator::BDF1,
+                      dealii::ExcMessage(
+                        "Solve blocks with a multistep BDF integrator cannot split off "
+                        "a reaction, because their step history skips the reaction.\n"));
+          AssertThrow(reaction_steps > 0,
+                      dealii::ExcMessage(
+                        "The number of reaction steps must be positive.\n"));
+        }
+      if (solve_type != SolveType::Explicit)
+        {
+          AssertThrow(explicit_integrator == ExplicitIntegrator::UserDefinedUpdate,
+                      dealii::ExcMessage(
+                        "Only explicit solves have a time integrator.\n"));
+        }
       for (const auto &[field_index, dependency] : dependencies_rhs)
         {
           AssertThrow(dependency.src_flag == EvalFlags::nothing,
@@ -219,6 +370,47 @@ SolveBlock::validate() const
     }
 }
 
+inline bool
+SolveBlock::needs_jacobian() const
+{
+  return solve_type == SolveType::Newton && !automatic_jacobian &&
+         (!nonlinear_solver_parameters.jacobian_free ||
+          linear_solver_parameters.preconditioner != PreconditionerType::None ||
+          linear_solver_parameters.autotune);
+}
+
+inline void
+SolveBlock::validate_jacobian() const
+{
+  if (!needs_jacobian())
+    {
+      return;
+    }
+  for (unsigned int field_index : field_indices)
+    {
+      const auto &dep_it_lhs = dependencies_lhs.find(field_index);
+      AssertThrow(dep_it_lhs != dependencies_lhs.end() &&
+                    dep_it_lhs->second.src_flag != EvalFlags::nothing,
+                  dealii::ExcMessage(
+                    "Every field in the newton solve with id " + std::to_string(id) +
+                    " should appear as a Delta term in the residual Jacobian (LHS) "
+                    "expression, unless the solve is Jacobian-free without a "
+                    "preconditioner.\n"));
+    }
+}
+
+inline DependencyMap
+SolveBlock::automatic_jacobian_dependencies() const
+{
+  DependencyMap dependencies = dependencies_rhs;
+  for (unsigned int field_index : field_indices)
+    {
+      Dependency &dependency = dependencies[field_index];
+      dependency.src_flag |= dependency.flag;
+    }
+  return dependencies;
+}
+
 inline const std::vector<SolveBlock> &
 validate_solve_blocks(const std::vector<SolveBlock>      &solve_blocks,
                       const std::vector<FieldAttributes> &field_attributes)
@@ -238,6 +430,24 @@ validate_solve_blocks(const std::vector<SolveBlock>      &solve_blocks,
     {
       solve_block.validate();
     }
+  // Check that the reaction of solve blocks with operator splitting only acts on scalar
+  // fields, which share their DoFs
+  for (const auto &solve_block : solve_blocks)
+    {
+      if (solve_block.reaction_splitting == SplittingScheme::NoSplitting)
+        {
+          continue;
+        }
+      for (unsigned int field_index : solve_block.field_indices)
+        {
+          AssertThrow(field_index < field_attributes.size() &&
+                        field_attributes[field_index].field_type == TensorRank::Scalar,
+                      dealii::ExcMessage("The solve block with id " +
+                                         std::to_string(solve_block.id) +
+                                         " splits off a reaction, so all its fields "
+                                         "must be scalar.\n"));
+        }
+    }
   // Check for duplicate solve block ids
   {
     std::set<int> ids;
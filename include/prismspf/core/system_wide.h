@@ -4,6 +4,7 @@
 #pragma once
 
 #include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/quadrature.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/fe/fe_q.h>
 #include <deal.II/fe/fe_system.h>
@@ -40,6 +41,21 @@ public:
    */
   inline static const dealii::QGaussLobatto<dim> quadrature =
     dealii::QGaussLobatto<dim>(degree + 1);
+
+  /**
+   * @brief Unit support points of the scalar FE as a quadrature rule. Every component of
+   * the vector FE shares these points.
+   *
+   * This is a function-local static so it is built the first time it is used, after the
+   * FE systems exist.
+   */
+  static const dealii::Quadrature<dim> &
+  get_support_point_quadrature()
+  {
+    static const dealii::Quadrature<dim> support_point_quadrature(
+      fe_systems[0].get_unit_support_points());
+    return support_point_quadrature;
+  }
 };
 
 PRISMS_PF_END_NAMESPACE
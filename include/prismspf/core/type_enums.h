@@ -143,7 +143,265 @@ enum PreconditionerType : std::uint8_t
 {
   None,
   Chebyshev,
-  GMG
+  GMG,
+  Block
+};
+
+/**
+ * @brief Form of the block preconditioner for solve blocks with several fields.
+ */
+enum BlockPreconditionerForm : std::uint8_t
+{
+  /**
+   * @brief Invert the diagonal blocks independently.
+   */
+  BlockDiagonal,
+  /**
+   * @brief Forward substitution with the lower block triangle.
+   */
+  BlockLowerTriangular,
+  /**
+   * @brief Backward substitution with the upper block triangle.
+   */
+  BlockUpperTriangular,
+  /**
+   * @brief Block factorization with an approximate Schur complement.
+   */
+  BlockSchurComplement
+};
+
+/**
+ * @brief Approximate inverse of the diagonal blocks of the block preconditioner.
+ */
+enum BlockInnerSolveType : std::uint8_t
+{
+  /**
+   * @brief Chebyshev iteration on the diagonal of the block.
+   */
+  BlockInnerChebyshev,
+  /**
+   * @brief One geometric multigrid V-cycle on the block.
+   */
+  BlockInnerGMG
+};
+
+/**
+ * @brief Coarse grid solver of the geometric multigrid preconditioner.
+ */
+enum MGCoarseSolverType : std::uint8_t
+{
+  /**
+   * @brief Apply the level smoother once.
+   */
+  CoarseSmoother,
+  /**
+   * @brief Chebyshev-preconditioned CG, iterated to a relative tolerance.
+   */
+  CoarseChebyshevCG,
+  /**
+   * @brief LU factorization of the assembled coarse matrix.
+   */
+  CoarseDirect
+};
+
+/**
+ * @brief Level smoother of the geometric multigrid preconditioner.
+ */
+enum MGSmootherType : std::uint8_t
+{
+  /**
+   * @brief Chebyshev iteration preconditioned by the inverse diagonal.
+   */
+  SmootherJacobiChebyshev,
+  /**
+   * @brief Chebyshev iteration preconditioned by cell-wise fast diagonalization.
+   */
+  SmootherFDMChebyshev,
+  /**
+   * @brief Damped additive Schwarz iteration with cell-wise fast diagonalization.
+   */
+  SmootherFDMSchwarz
+};
+
+/**
+ * @brief Time integrator of an explicit solve block.
+ */
+enum ExplicitIntegrator : std::uint8_t
+{
+  /**
+   * @brief The RHS is the new value of the fields, e.g., old_1 + dt * f for forward
+   * Euler written out by the user.
+   */
+  UserDefinedUpdate,
+  /**
+   * @brief The RHS is the time derivative, integrated with forward Euler.
+   */
+  ForwardEuler,
+  /**
+   * @brief The RHS is the time derivative, integrated with the three-stage, third-order
+   * strong stability preserving Runge-Kutta method of Shu and Osher.
+   */
+  SSPRK3,
+  /**
+   * @brief The RHS is the time derivative, integrated with the five-stage, fourth-order
+   * low-storage (2N) Runge-Kutta method of Carpenter and Kennedy.
+   */
+  LowStorageRK4
+};
+
+/**
+ * @brief Time integrator of a linear or newton solve block.
+ */
+enum ImplicitIntegrator : std::uint8_t
+{
+  /**
+   * @brief The equations contain the time discretization written out by the user, e.g.,
+   * backward Euler with old_1.
+   */
+  UserDefinedResidual = 0,
+  /**
+   * @brief The equations are the spatial residual, integrated with backward Euler.
+   */
+  BDF1 = 1,
+  /**
+   * @brief The equations are the spatial residual, integrated with variable-step BDF2.
+   */
+  BDF2 = 2,
+  /**
+   * @brief The equations are the spatial residual, integrated with variable-step BDF3.
+   */
+  BDF3 = 3
+};
+
+/**
+ * @brief Operator splitting of the local reaction of a solve block from its equations.
+ */
+enum SplittingScheme : std::uint8_t
+{
+  /**
+   * @brief The equations of the solve block contain the whole time derivative.
+   */
+  NoSplitting,
+  /**
+   * @brief First-order Lie splitting: the reaction over the whole timestep, then the
+   * equations of the solve block.
+   */
+  LieSplitting,
+  /**
+   * @brief Second-order Strang splitting: the reaction over half the timestep, the
+   * equations of the solve block, and the reaction over the other half.
+   */
+  StrangSplitting
+};
+
+/**
+ * @brief Time integrator of the local reaction of a solve block with operator splitting.
+ */
+enum ReactionIntegrator : std::uint8_t
+{
+  /**
+   * @brief Backward Euler, with Newton iterations at each DoF.
+   */
+  ReactionBackwardEuler,
+  /**
+   * @brief Two-stage, second-order, L-stable singly diagonally implicit Runge-Kutta
+   * method of Alexander, with Newton iterations at each DoF.
+   */
+  ReactionSDIRK2,
+  /**
+   * @brief Classical four-stage, fourth-order explicit Runge-Kutta method.
+   */
+  ReactionRK4
+};
+
+/**
+ * @brief When a solve block is solved. On the increments it is skipped, the fields keep
+ * the solution of the last solve.
+ */
+enum SolvePolicy : std::uint8_t
+{
+  /**
+   * @brief Solve every increment.
+   */
+  SolveEveryIncrement,
+  /**
+   * @brief Solve every solve_period increments.
+   */
+  SolveEveryNIncrements,
+  /**
+   * @brief Solve when the relative change in the l2-norm of a field that the equations
+   * depend on, since the last solve, exceeds the solve tolerance.
+   */
+  SolveOnFieldChange,
+  /**
+   * @brief Solve when the normalized residual of the last solution exceeds the solve
+   * tolerance. Only for linear and newton solve blocks.
+   */
+  SolveOnResidual
+};
+
+/**
+ * @brief Use of the estimated maximum stable timestep of the explicit solve blocks.
+ */
+enum StableTimestepMode : std::uint8_t
+{
+  /**
+   * @brief No estimate.
+   */
+  StableTimestepOff,
+  /**
+   * @brief The estimate is written to the summary.
+   */
+  StableTimestepReport,
+  /**
+   * @brief The estimate is reported and the timestep is limited to a fraction of it.
+   */
+  StableTimestepLimit
+};
+
+/**
+ * @brief How the LHS operator of a linear solve is applied.
+ */
+enum OperatorBackend : std::uint8_t
+{
+  /**
+   * @brief On-the-fly evaluation of the user-defined operator in a cell loop.
+   */
+  BackendMatrixFree,
+  /**
+   * @brief Multiplication with a sparse matrix that is assembled from the operator.
+   */
+  BackendAssembled,
+  /**
+   * @brief The faster of the two, chosen by timing both once per mesh.
+   */
+  BackendAuto
+};
+
+/**
+ * @brief Globalization strategy of the Newton solver.
+ */
+enum NewtonGlobalization : std::uint8_t
+{
+  /**
+   * @brief Every update is damped by the constant step size.
+   */
+  FixedStep,
+  /**
+   * @brief The step size is reduced until the residual norm decreases sufficiently
+   * (Armijo condition).
+   */
+  Backtracking,
+  /**
+   * @brief The step size is a critical point of the squared residual norm along the
+   * Newton direction, found by secant iterations.
+   */
+  CriticalPoint,
+  /**
+   * @brief The update is a dogleg step between the steepest descent and Newton
+   * directions, restricted to a trust region.
+   */
+  TrustRegion
 };
 
 PRISMS_PF_END_NAMESPACE
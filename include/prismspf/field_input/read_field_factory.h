@@ -16,6 +16,8 @@
 
 #ifdef PRISMS_PF_WITH_VTK
 #  include <prismspf/field_input/read_vtk.h>
+#  include <prismspf/field_input/read_vtk_image_data.h>
+#  include <prismspf/field_input/read_vtk_xml.h>
 #endif
 
 PRISMS_PF_BEGIN_NAMESPACE
@@ -25,35 +27,47 @@ PRISMS_PF_BEGIN_NAMESPACE
  * not a member of ReadFieldBase to avoid redundant template instantiations
  */
 
-enum class Type
-{
-  ReadUnstructuredVTK,
-  ReadBinary
-};
-
 template <unsigned int dim, typename number>
 std::shared_ptr<ReadFieldBase<dim, number>>
 create_reader(const InitialConditionFile       &ic_file,
               const SpatialDiscretization<dim> &spatial_discretization)
 {
+#ifndef PRISMS_PF_WITH_VTK
+  AssertThrow(ic_file.format == InitialConditionFile::DataFormatType::FlatBinary,
+              dealii::ExcMessage(
+                "You are trying to read a VTK file as an input; however, PRISMS-PF "
+                "was not built with VTK. Please reconfig PRISMS-PF with VTK using "
+                "-D PRISMS_PF_WITH_VTK=ON"));
+#endif
+
   switch (ic_file.format)
     {
-      case InitialConditionFile::DataFormatType::VTKUnstructuredGrid:
 #ifdef PRISMS_PF_WITH_VTK
+      case InitialConditionFile::DataFormatType::VTKUnstructuredGrid:
+        // Legacy vtk files may also hold structured points, which we can index directly
+        if (ReadImageDataVTK<dim, number>::is_structured_points(ic_file.file_name))
+          {
+            return std::make_shared<ReadImageDataVTK<dim, number>>(
+              ic_file,
+              spatial_discretization);
+          }
         return std::make_shared<ReadUnstructuredVTK<dim, number>>(ic_file,
                                                                   spatial_discretization);
-#else
-        AssertThrow(false,
-                    dealii::ExcMessage(
-                      "You are trying to read a VTK file as an input; however, PRISMS-PF "
-                      "was not built with VTK. Please reconfig PRISMS-PF with VTK using "
-                      "-D PRISMS_PF_WITH_VTK=ON"));
+      case InitialConditionFile::DataFormatType::VTKXMLUnstructuredGrid:
+      case InitialConditionFile::DataFormatType::VTKPXMLUnstructuredGrid:
+        return std::make_shared<ReadXMLUnstructuredVTK<dim, number>>(
+          ic_file,
+          spatial_discretization);
+      case InitialConditionFile::DataFormatType::VTKXMLImageData:
+        return std::make_shared<ReadImageDataVTK<dim, number>>(ic_file,
+                                                               spatial_discretization);
 #endif
       case InitialConditionFile::DataFormatType::FlatBinary:
         return std::make_shared<ReadBinary<dim, number>>(ic_file, spatial_discretization);
       default:
         AssertThrow(false, UnreachableCode());
     }
+  return nullptr;
 }
 
 PRISMS_PF_END_NAMESPACE
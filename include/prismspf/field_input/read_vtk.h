@@ -125,7 +125,7 @@ ReadUnstructuredVTK<dim, number>::ReadUnstructuredVTK(
   // Create a reader for the vtk file and update it
   // vtkNew is a smart pointer so we don't need to manage it with delete
   reader = vtkNew<vtkUnstructuredGridReader>();
-  reader->SetFileName(this->ic_file.filename.c_str());
+  reader->SetFileName(this->ic_file.file_name.c_str());
   reader->Update();
 
   // Check that the file is an unstructured grid
@@ -0,0 +1,341 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/lac/vector.h>
+
+#include <prismspf/core/types.h>
+
+#include <prismspf/field_input/read_field_base.h>
+
+#include <prismspf/utilities/utilities.h>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix3x3.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredPointsReader.h>
+#include <vtkXMLImageDataReader.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Class to read in VTK image data (.vti or legacy STRUCTURED_POINTS .vtk) and
+ * provide values at given points.
+ *
+ * Image data lives on an axis-aligned grid with a fixed origin and spacing, so the
+ * enclosing voxel and the multilinear weights of a point are computed directly from its
+ * coordinates. No cell locator is needed. The point with structured index i has the
+ * coordinate origin + i * spacing, where i runs over the extent of the image, which
+ * need not start at zero. Images with a direction matrix other than the identity are
+ * rejected. The point data arrays are copied into flat
+ * vectors the first time they are requested.
+ */
+template <unsigned int dim, typename number>
+class ReadImageDataVTK : public ReadFieldBase<dim, number>
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  ReadImageDataVTK(const InitialConditionFile       &_ic_file,
+                   const SpatialDiscretization<dim> &_spatial_discretization);
+
+  /**
+   * @brief Print the vtk file for debugging
+   */
+  void
+  print_file() override;
+
+  /**
+   * @brief Get scalar value for a given point
+   */
+  number
+  get_scalar_value(const dealii::Point<dim> &point,
+                   const std::string        &scalar_name) override;
+
+  /**
+   * @brief Get vector value for a given point
+   */
+  dealii::Vector<number>
+  get_vector_value(const dealii::Point<dim> &point,
+                   const std::string        &vector_name) override;
+
+  /**
+   * @brief Whether a legacy vtk file holds structured points.
+   */
+  static bool
+  is_structured_points(const std::string &file_name);
+
+private:
+  /**
+   * @brief Get the cached values for the point data array with the given name.
+   */
+  const std::vector<number> &
+  get_data(const std::string &array_name, unsigned int n_components);
+
+  /**
+   * @brief Multilinear interpolation of a cached array at a point.
+   */
+  dealii::Vector<number>
+  interpolate(const dealii::Point<dim>  &point,
+              const std::vector<number> &values,
+              unsigned int               n_components) const;
+
+  /**
+   * @brief Image data read from file.
+   */
+  vtkSmartPointer<vtkImageData> image;
+
+  /**
+   * @brief Origin of the image.
+   */
+  std::array<double, dim> origin {};
+
+  /**
+   * @brief Spacing of the image in each direction.
+   */
+  std::array<double, dim> spacing {};
+
+  /**
+   * @brief Lower bound of the extent of the image in each direction, i.e., the
+   * structured index of the first point.
+   */
+  std::array<double, dim> first_index {};
+
+  /**
+   * @brief Number of points in each direction.
+   */
+  std::array<dealii::types::global_dof_index, dim> n_points {};
+
+  /**
+   * @brief Stride of the flattened point index in each direction.
+   */
+  std::array<dealii::types::global_dof_index, dim> stride {};
+
+  /**
+   * @brief Point data arrays that have been requested so far, flattened by point and
+   * then component.
+   */
+  std::map<std::string, std::vector<number>> data;
+};
+
+template <unsigned int dim, typename number>
+inline ReadImageDataVTK<dim, number>::ReadImageDataVTK(
+  const InitialConditionFile       &_ic_file,
+  const SpatialDiscretization<dim> &_spatial_discretization)
+  : ReadFieldBase<dim, number>(_ic_file, _spatial_discretization)
+{
+  // Read the file with either the XML or the legacy reader. We keep a reference to the
+  // output so it outlives the reader.
+  if (this->ic_file.format == InitialConditionFile::DataFormatType::VTKXMLImageData)
+    {
+      vtkNew<vtkXMLImageDataReader> reader;
+      reader->SetFileName(this->ic_file.file_name.c_str());
+      reader->Update();
+      image = reader->GetOutput();
+    }
+  else
+    {
+      vtkNew<vtkStructuredPointsReader> reader;
+      reader->SetFileName(this->ic_file.file_name.c_str());
+      AssertThrow(reader->IsFileStructuredPoints(),
+                  dealii::ExcMessage("The vtk file must contain structured points"));
+      reader->Update();
+      image = reader->GetOutput();
+    }
+  AssertThrow(image != nullptr && image->GetNumberOfPoints() > 0,
+              dealii::ExcMessage("Could not read any points from the vtk file: " +
+                                 this->ic_file.file_name));
+
+  // Cache the grid description
+  const double *image_origin  = image->GetOrigin();
+  const double *image_spacing = image->GetSpacing();
+  const int    *image_dims    = image->GetDimensions();
+  const int    *image_extent  = image->GetExtent();
+
+  // The interpolation assumes that the image axes are the coordinate axes
+  AssertThrow(image->GetDirectionMatrix()->IsIdentity() != 0,
+              dealii::ExcMessage("The image data must have the identity as its "
+                                 "direction matrix"));
+
+  // Points in higher dimensions than the simulation would be ambiguous
+  for (unsigned int d = dim; d < 3; ++d)
+    {
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      AssertThrow(image_dims[d] == 1,
+                  dealii::ExcMessage("The image data has more dimensions than the "
+                                     "simulation"));
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+  dealii::types::global_dof_index current_stride = 1;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      origin[d]      = image_origin[d];
+      spacing[d]     = image_spacing[d];
+      first_index[d] = static_cast<double>(image_extent[2 * d]);
+      n_points[d]    = static_cast<dealii::types::global_dof_index>(image_dims[d]);
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      stride[d] = current_stride;
+      current_stride *= n_points[d];
+
+      AssertThrow(n_points[d] == 1 || spacing[d] > 0.0,
+                  dealii::ExcMessage("The image data must have positive spacing"));
+    }
+}
+
+template <unsigned int dim, typename number>
+inline bool
+ReadImageDataVTK<dim, number>::is_structured_points(const std::string &file_name)
+{
+  vtkNew<vtkStructuredPointsReader> reader;
+  reader->SetFileName(file_name.c_str());
+  return reader->IsFileStructuredPoints() != 0;
+}
+
+template <unsigned int dim, typename number>
+inline void
+ReadImageDataVTK<dim, number>::print_file()
+{
+  image->PrintSelf(std::cout, vtkIndent());
+}
+
+template <unsigned int dim, typename number>
+inline const std::vector<number> &
+ReadImageDataVTK<dim, number>::get_data(const std::string &array_name,
+                                        unsigned int       n_components)
+{
+  auto iter = data.find(array_name);
+  if (iter != data.end())
+    {
+      AssertThrow(iter->second.size() == n_components * image->GetNumberOfPoints(),
+                  dealii::ExcMessage("The field " + array_name +
+                                     " was previously read with a different number "
+                                     "of components"));
+      return iter->second;
+    }
+
+  vtkDataArray *data_array = image->GetPointData()->GetArray(array_name.c_str());
+  AssertThrow(data_array != nullptr,
+              dealii::ExcMessage(
+                "The provided vtk dataset does not contain a field named " +
+                array_name));
+  AssertThrow(static_cast<unsigned int>(data_array->GetNumberOfComponents()) >=
+                n_components,
+              dealii::ExcMessage("The field " + array_name + " has fewer than " +
+                                 std::to_string(n_components) + " components"));
+
+  // Copy the requested components into a flat vector so lookups avoid the virtual
+  // GetComponent call
+  const vtkIdType     n_tuples = data_array->GetNumberOfTuples();
+  std::vector<number> values(n_tuples * n_components);
+  for (vtkIdType i = 0; i < n_tuples; ++i)
+    {
+      for (unsigned int c = 0; c < n_components; ++c)
+        {
+          values[(i * n_components) + c] =
+            static_cast<number>(data_array->GetComponent(i, static_cast<int>(c)));
+        }
+    }
+
+  return data.emplace(array_name, std::move(values)).first->second;
+}
+
+template <unsigned int dim, typename number>
+inline dealii::Vector<number>
+ReadImageDataVTK<dim, number>::interpolate(const dealii::Point<dim>  &point,
+                                           const std::vector<number> &values,
+                                           unsigned int               n_components) const
+{
+  // Compute the lower corner of the enclosing voxel and the local coordinate in each
+  // direction
+  std::array<dealii::types::global_dof_index, dim> lower_indices {};
+  std::array<double, dim>                          weights {};
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      if (n_points[d] == 1)
+        {
+          continue;
+        }
+      const double coordinate = ((point[d] - origin[d]) / spacing[d]) - first_index[d];
+      const double tolerance  = Defaults::mesh_tolerance / spacing[d];
+      AssertThrow(coordinate >= -tolerance &&
+                    coordinate <= static_cast<double>(n_points[d] - 1) + tolerance,
+                  dealii::ExcMessage("Point is outside of the image data bounds"));
+
+      // Clamp the lower index so the upper node is always in bounds
+      const double floored = std::floor(std::max(coordinate, 0.0));
+      lower_indices[d] =
+        std::min(static_cast<dealii::types::global_dof_index>(floored), n_points[d] - 2);
+      weights[d] =
+        std::clamp(coordinate - static_cast<double>(lower_indices[d]), 0.0, 1.0);
+    }
+
+  dealii::types::global_dof_index lower_index = 0;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      lower_index += lower_indices[d] * stride[d];
+    }
+
+  // Loop over the 2^dim corners of the voxel. Bit d of the corner selects the upper
+  // node in direction d.
+  dealii::Vector<number> value(n_components);
+  for (unsigned int corner = 0; corner < (1U << dim); ++corner)
+    {
+      double                          weight = 1.0;
+      dealii::types::global_dof_index index  = lower_index;
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          const bool upper = ((corner >> d) & 1U) != 0U;
+          if (upper && n_points[d] == 1)
+            {
+              weight = 0.0;
+              break;
+            }
+          weight *= upper ? weights[d] : 1.0 - weights[d];
+          index += upper ? stride[d] : 0;
+        }
+      if (weight == 0.0)
+        {
+          continue;
+        }
+      for (unsigned int c = 0; c < n_components; ++c)
+        {
+          value[c] += static_cast<number>(weight) * values[(index * n_components) + c];
+        }
+    }
+
+  return value;
+}
+
+template <unsigned int dim, typename number>
+inline number
+ReadImageDataVTK<dim, number>::get_scalar_value(const dealii::Point<dim> &point,
+                                                const std::string        &scalar_name)
+{
+  return interpolate(point, get_data(scalar_name, 1), 1)[0];
+}
+
+template <unsigned int dim, typename number>
+inline dealii::Vector<number>
+ReadImageDataVTK<dim, number>::get_vector_value(const dealii::Point<dim> &point,
+                                                const std::string        &vector_name)
+{
+  return interpolate(point, get_data(vector_name, dim), dim);
+}
+
+PRISMS_PF_END_NAMESPACE
@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/lac/vector.h>
+
+#include <prismspf/core/types.h>
+
+#include <prismspf/field_input/read_field_base.h>
+
+#include <prismspf/utilities/utilities.h>
+
+#include <vtkCellLocator.h>
+#include <vtkDataArray.h>
+#include <vtkGenericCell.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLPUnstructuredGridReader.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <string>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Class to read in an XML unstructured grid (.vtu or .pvtu) and provide values
+ * at given points.
+ *
+ * Unlike the legacy reader, the XML readers expose all point data arrays at once, so we
+ * look arrays up by name and build a single cell locator that is reused for every point.
+ */
+template <unsigned int dim, typename number>
+class ReadXMLUnstructuredVTK : public ReadFieldBase<dim, number>
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  ReadXMLUnstructuredVTK(const InitialConditionFile       &_ic_file,
+                         const SpatialDiscretization<dim> &_spatial_discretization);
+
+  /**
+   * @brief Print the vtk file for debugging
+   */
+  void
+  print_file() override;
+
+  /**
+   * @brief Get the names of the point data arrays in the vtk file.
+   */
+  [[nodiscard]] std::vector<std::string>
+  get_array_names() const;
+
+  /**
+   * @brief Get scalar value for a given point
+   */
+  number
+  get_scalar_value(const dealii::Point<dim> &point,
+                   const std::string        &scalar_name) override;
+
+  /**
+   * @brief Get vector value for a given point
+   */
+  dealii::Vector<number>
+  get_vector_value(const dealii::Point<dim> &point,
+                   const std::string        &vector_name) override;
+
+private:
+  /**
+   * @brief Get the point data array with the given name and check the number of
+   * components.
+   */
+  vtkDataArray *
+  get_data_array(const std::string &array_name, unsigned int n_components) const;
+
+  /**
+   * @brief Interpolate the given point data array at a point.
+   */
+  dealii::Vector<number>
+  interpolate(const dealii::Point<dim> &point,
+              vtkDataArray             *data_array,
+              unsigned int              n_components);
+
+  /**
+   * @brief Unstructured grid read from file.
+   */
+  vtkSmartPointer<vtkUnstructuredGrid> output;
+
+  /**
+   * @brief Cell locator built once for the whole grid.
+   */
+  vtkNew<vtkCellLocator> cell_locator;
+
+  /**
+   * @brief Scratch cell for the cell locator.
+   */
+  vtkNew<vtkGenericCell> cell;
+
+  /**
+   * @brief Number of points in a hex cell.
+   */
+  static constexpr unsigned int n_points_per_hex_cell = 8;
+
+  /**
+   * @brief Number of space coordinates in a point.
+   */
+  static constexpr unsigned int n_space_coordinates = 3;
+};
+
+template <unsigned int dim, typename number>
+inline ReadXMLUnstructuredVTK<dim, number>::ReadXMLUnstructuredVTK(
+  const InitialConditionFile       &_ic_file,
+  const SpatialDiscretization<dim> &_spatial_discretization)
+  : ReadFieldBase<dim, number>(_ic_file, _spatial_discretization)
+{
+  AssertThrow(dim != 1,
+              dealii::ExcMessage("File read-in is not supported for 1D meshes"));
+
+  // Read the file with the serial or parallel XML reader. We keep a reference to the
+  // output so it outlives the reader.
+  if (this->ic_file.format == InitialConditionFile::DataFormatType::VTKXMLUnstructuredGrid)
+    {
+      vtkNew<vtkXMLUnstructuredGridReader> reader;
+      reader->SetFileName(this->ic_file.file_name.c_str());
+      reader->Update();
+      output = reader->GetOutput();
+    }
+  else if (this->ic_file.format ==
+           InitialConditionFile::DataFormatType::VTKPXMLUnstructuredGrid)
+    {
+      vtkNew<vtkXMLPUnstructuredGridReader> reader;
+      reader->SetFileName(this->ic_file.file_name.c_str());
+      reader->Update();
+      output = reader->GetOutput();
+    }
+  else
+    {
+      AssertThrow(false,
+                  dealii::ExcMessage(
+                    "Dataset format must be VTKXMLUnstructuredGrid or "
+                    "VTKPXMLUnstructuredGrid"));
+    }
+
+  AssertThrow(output != nullptr && output->GetNumberOfCells() > 0,
+              dealii::ExcMessage("Could not read any cells from the vtk file: " +
+                                 this->ic_file.file_name));
+
+  // Check that we only have one cell type and that it is a hex or quad
+  AssertThrow(
+    output->IsHomogeneous(),
+    dealii::ExcMessage(
+      "The vtk file must have homogeneous cells of type VTK_HEXAHEDRON or VTK_QUAD"));
+  if constexpr (dim == 3)
+    {
+      AssertThrow(output->GetCellType(0) == VTK_HEXAHEDRON,
+                  dealii::ExcMessage(
+                    "For 3D meshes, the cells must be of type VTK_HEXAHEDRON "));
+    }
+  else if constexpr (dim == 2)
+    {
+      AssertThrow(output->GetCellType(0) == VTK_QUAD,
+                  dealii::ExcMessage(
+                    "For 2D meshes, the cells must be of type VTK_QUAD"));
+    }
+
+  // Build the locator once. Each point query is then a tree search rather than a
+  // rebuild of the locator.
+  cell_locator->SetDataSet(output);
+  cell_locator->BuildLocator();
+}
+
+template <unsigned int dim, typename number>
+inline void
+ReadXMLUnstructuredVTK<dim, number>::print_file()
+{
+  output->PrintSelf(std::cout, vtkIndent());
+}
+
+template <unsigned int dim, typename number>
+inline std::vector<std::string>
+ReadXMLUnstructuredVTK<dim, number>::get_array_names() const
+{
+  vtkPointData *point_data = output->GetPointData();
+  const int     n_arrays   = point_data->GetNumberOfArrays();
+
+  std::vector<std::string> array_names;
+  array_names.reserve(n_arrays);
+  for (int i = 0; i < n_arrays; ++i)
+    {
+      const char *name = point_data->GetArrayName(i);
+      array_names.emplace_back(name != nullptr ? name : "");
+    }
+  return array_names;
+}
+
+template <unsigned int dim, typename number>
+inline vtkDataArray *
+ReadXMLUnstructuredVTK<dim, number>::get_data_array(const std::string &array_name,
+                                                    unsigned int n_components) const
+{
+  vtkDataArray *data_array = output->GetPointData()->GetArray(array_name.c_str());
+  AssertThrow(data_array != nullptr,
+              dealii::ExcMessage(
+                "The provided vtk dataset does not contain a field named " +
+                array_name));
+  AssertThrow(static_cast<unsigned int>(data_array->GetNumberOfComponents()) >=
+                n_components,
+              dealii::ExcMessage("The field " + array_name + " has fewer than " +
+                                 std::to_string(n_components) + " components"));
+  return data_array;
+}
+
+template <unsigned int dim, typename number>
+inline dealii::Vector<number>
+ReadXMLUnstructuredVTK<dim, number>::interpolate(const dealii::Point<dim> &point,
+                                                 vtkDataArray             *data_array,
+                                                 unsigned int              n_components)
+{
+  // Convert the dealii point to a vector
+  std::vector<double> point_vector = dealii_point_to_vector<dim, double>(point);
+
+  std::vector<double> pcoords(n_space_coordinates);
+  std::vector<double> weights(n_points_per_hex_cell);
+  int                 sub_id = 0;
+
+  const vtkIdType cell_id = cell_locator->FindCell(point_vector.data(),
+                                                   Defaults::mesh_tolerance,
+                                                   cell,
+                                                   sub_id,
+                                                   pcoords.data(),
+                                                   weights.data());
+  AssertThrow(cell_id >= 0,
+              dealii::ExcMessage("Point not inside any cell for interpolation"));
+
+  // Interpolate using the weights and nodal values
+  dealii::Vector<number> value(n_components);
+  vtkIdList             *point_ids = cell->GetPointIds();
+  for (vtkIdType id = 0; id < point_ids->GetNumberOfIds(); ++id)
+    {
+      const vtkIdType pt_id = point_ids->GetId(id);
+      for (unsigned int c = 0; c < n_components; ++c)
+        {
+          // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+          value[c] += static_cast<number>(
+            weights[id] * data_array->GetComponent(pt_id, static_cast<int>(c)));
+          // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+    }
+
+  return value;
+}
+
+template <unsigned int dim, typename number>
+inline number
+ReadXMLUnstructuredVTK<dim, number>::get_scalar_value(const dealii::Point<dim> &point,
+                                                      const std::string &scalar_name)
+{
+  return interpolate(point, get_data_array(scalar_name, 1), 1)[0];
+}
+
+template <unsigned int dim, typename number>
+inline dealii::Vector<number>
+ReadXMLUnstructuredVTK<dim, number>::get_vector_value(const dealii::Point<dim> &point,
+                                                      const std::string &vector_name)
+{
+  return interpolate(point, get_data_array(vector_name, dim), dim);
+}
+
+PRISMS_PF_END_NAMESPACE
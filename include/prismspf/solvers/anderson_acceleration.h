@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <prismspf/config.h>
+
+#include <deque>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Anderson acceleration (DIIS) of a fixed-point iteration x = G(x).
+ *
+ * This is the formulation of Walker and Ni with differences of the residuals f = G(x) - x
+ * and of the images G(x) of the last iterates. The next iterate is the relaxed image of
+ * the combination of the last iterates whose residual has the smallest norm. The small
+ * least-squares problem is solved through its normal equations with a truncated
+ * pseudo-inverse, so nearly dependent differences are ignored. With a depth of zero, the
+ * iteration is a relaxed fixed-point iteration.
+ */
+template <typename VectorType>
+class AndersonAcceleration
+{
+public:
+  /**
+   * @brief Constructor.
+   */
+  explicit AndersonAcceleration(unsigned int _depth = 5, double _relaxation = 1.0)
+    : depth(_depth)
+    , relaxation(_relaxation)
+  {}
+
+  /**
+   * @brief Drop the history, e.g., at the start of a new fixed-point iteration.
+   */
+  void
+  clear()
+  {
+    residual_differences.clear();
+    image_differences.clear();
+    has_previous = false;
+  }
+
+  /**
+   * @brief Replace the iterate x with the next iterate, given the image G(x).
+   */
+  void
+  update(VectorType &iterate, const VectorType &image)
+  {
+    VectorType residual;
+    residual.reinit(image, true);
+    residual = image;
+    residual -= iterate;
+
+    // Differences to the previous residual and image
+    if (has_previous && depth > 0)
+      {
+        if (residual_differences.size() == depth)
+          {
+            residual_differences.pop_front();
+            image_differences.pop_front();
+          }
+        residual_differences.emplace_back(residual);
+        residual_differences.back() -= previous_residual;
+        image_differences.emplace_back(image);
+        image_differences.back() -= previous_image;
+      }
+    previous_residual.reinit(image, true);
+    previous_residual = residual;
+    previous_image.reinit(image, true);
+    previous_image = image;
+    has_previous   = true;
+
+    // x = G(x) - (1 - beta) f - sum_i gamma_i (dG_i - (1 - beta) dF_i)
+    const unsigned int n_history = residual_differences.size();
+    iterate                      = image;
+    iterate.add(relaxation - 1.0, residual);
+    if (n_history == 0)
+      {
+        return;
+      }
+
+    dealii::LAPACKFullMatrix<double> gram(n_history, n_history);
+    dealii::Vector<double>           projection(n_history);
+    for (unsigned int i = 0; i < n_history; ++i)
+      {
+        for (unsigned int j = i; j < n_history; ++j)
+          {
+            const double entry = residual_differences[i] * residual_differences[j];
+            gram(i, j)         = entry;
+            gram(j, i)         = entry;
+          }
+        projection(i) = residual_differences[i] * residual;
+      }
+    gram.compute_inverse_svd(singular_value_threshold);
+    dealii::Vector<double> coefficients(n_history);
+    gram.vmult(coefficients, projection);
+
+    for (unsigned int i = 0; i < n_history; ++i)
+      {
+        iterate.add(-coefficients(i),
+                    image_differences[i],
+                    (1.0 - relaxation) * coefficients(i),
+                    residual_differences[i]);
+      }
+  }
+
+private:
+  /**
+   * @brief Relative threshold below which singular values of the normal equations are
+   * dropped.
+   */
+  static constexpr double singular_value_threshold = 1.0e-12;
+
+  /**
+   * @brief Maximum number of differences that are kept.
+   */
+  unsigned int depth;
+
+  /**
+   * @brief Relaxation (damping) of the image.
+   */
+  double relaxation;
+
+  /**
+   * @brief Whether the residual and image of a previous iterate are stored.
+   */
+  bool has_previous = false;
+
+  /**
+   * @brief Residual and image of the previous iterate.
+   */
+  VectorType previous_residual;
+
+  VectorType previous_image;
+
+  /**
+   * @brief Differences of consecutive residuals and images, oldest first.
+   */
+  std::deque<VectorType> residual_differences;
+
+  std::deque<VectorType> image_differences;
+};
+
+PRISMS_PF_END_NAMESPACE
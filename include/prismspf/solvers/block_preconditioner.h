@@ -0,0 +1,691 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <prismspf/core/matrix_free_manager.h>
+#include <prismspf/core/timer.h>
+#include <prismspf/core/type_enums.h>
+
+#include <prismspf/solvers/mf_operator.h>
+
+#include <prismspf/user_inputs/solve_parameters.h>
+
+#include <prismspf/config.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Zero the blocks of a vector that are not selected by the mask.
+ */
+template <typename number>
+inline void
+restrict_to_blocks(BlockVector<number> &vector, const std::vector<bool> &mask)
+{
+  for (unsigned int block = 0; block < vector.n_blocks(); ++block)
+    {
+      if (!mask[block])
+        {
+          vector.block(block) = 0.0;
+        }
+    }
+}
+
+/**
+ * @brief A diagonal block of the lhs operator of a solve block.
+ *
+ * The user's compute_lhs evaluates every field of the solve block at once, so a diagonal
+ * block is applied by evaluating the whole operator on an input that is zero outside the
+ * selected fields. The other blocks are padded with the identity, which keeps the
+ * operator invertible on the full BlockVector so that it can be used with Chebyshev and
+ * Krylov methods directly.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class DiagonalBlockOperator : public MATRIX_FREE_OPERATOR_BASE
+{
+public:
+  /**
+   * @brief Initialize.
+   *
+   * @param _mask Which blocks of the solve block belong to this diagonal block.
+   */
+  void
+  init(const MFOperator<dim, degree, number> &_lhs_operator, std::vector<bool> _mask)
+  {
+    lhs_operator = &_lhs_operator;
+    mask         = std::move(_mask);
+  }
+
+  /**
+   * @brief Copy the inverse diagonal of the lhs operator, padded with ones.
+   * @pre The diagonal of the lhs operator has been evaluated.
+   */
+  void
+  reinit_diagonal()
+  {
+    Assert(lhs_operator != nullptr, dealii::ExcNotInitialized());
+    const BlockVector<number> &lhs_inverse_diagonal =
+      lhs_operator->get_matrix_diagonal_inverse()->get_vector();
+    BlockVector<number> &block_inverse_diagonal = inverse_diagonal->get_vector();
+    block_inverse_diagonal.reinit(lhs_inverse_diagonal, true);
+    block_inverse_diagonal = lhs_inverse_diagonal;
+    for (unsigned int block = 0; block < mask.size(); ++block)
+      {
+        if (!mask[block])
+          {
+            block_inverse_diagonal.block(block) = 1.0;
+          }
+      }
+    masked_src.reinit(lhs_inverse_diagonal, true);
+  }
+
+  /**
+   * @brief Matrix-vector multiplication.
+   * @note requires dst is not ghosted
+   */
+  void
+  vmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    masked_src = src;
+    restrict_to_blocks(masked_src, mask);
+    lhs_operator->vmult(dst, masked_src);
+    for (unsigned int block = 0; block < mask.size(); ++block)
+      {
+        if (!mask[block])
+          {
+            dst.block(block) = src.block(block);
+          }
+      }
+  }
+
+  // NOLINTBEGIN(readability-identifier-naming)
+
+  /**
+   * @brief Transpose matrix-vector multiplication.
+   */
+  void
+  Tvmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    vmult(dst, src);
+  }
+
+  // NOLINTEND(readability-identifier-naming)
+
+  /**
+   * @brief Return the number of DoFs.
+   */
+  [[nodiscard]] dealii::types::global_dof_index
+  m() const
+  {
+    return lhs_operator->m();
+  }
+
+  /**
+   * @brief Only used so that we may compile. See MFOperator::el().
+   */
+  number
+  el(const unsigned int &row, const unsigned int &col) const
+  {
+    return lhs_operator->el(row, col);
+  }
+
+  /**
+   * @brief Get read access to the padded inverse diagonal.
+   */
+  [[nodiscard]] const std::shared_ptr<dealii::DiagonalMatrix<BlockVector<number>>> &
+  get_matrix_diagonal_inverse() const
+  {
+    return inverse_diagonal;
+  }
+
+private:
+  /**
+   * @brief The lhs operator of the whole solve block.
+   */
+  const MFOperator<dim, degree, number> *lhs_operator = nullptr;
+
+  /**
+   * @brief Which blocks belong to this diagonal block.
+   */
+  std::vector<bool> mask;
+
+  /**
+   * @brief Input restricted to the selected blocks.
+   */
+  mutable BlockVector<number> masked_src;
+
+  /**
+   * @brief Inverse diagonal padded with ones.
+   */
+  std::shared_ptr<dealii::DiagonalMatrix<BlockVector<number>>> inverse_diagonal =
+    std::make_shared<dealii::DiagonalMatrix<BlockVector<number>>>();
+};
+
+/**
+ * @brief Approximate inverse of a diagonal block of the lhs operator.
+ *
+ * By default, this is a Chebyshev iteration on the diagonal of the block. Once a
+ * multigrid hierarchy is set, it is one V-cycle on the diagonal blocks of the level
+ * operators instead, with the Chebyshev iteration as the smoother of every level and
+ * the block transfer of the GMG preconditioner. The coarsest level is only smoothed.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class DiagonalBlockSolve
+{
+public:
+  using BlockOperator = DiagonalBlockOperator<dim, degree, number>;
+  using Chebyshev =
+    dealii::PreconditionChebyshev<BlockOperator,
+                                  BlockVector<number>,
+                                  dealii::DiagonalMatrix<BlockVector<number>>>;
+  using Smoother =
+    dealii::MGSmootherPrecondition<BlockOperator, Chebyshev, BlockVector<number>>;
+  using MGTransferType =
+    dealii::MGTransferBlockGlobalCoarsening<dim, SolutionVector<number>>;
+  using PreconditionMG = dealii::PreconditionMG<dim, BlockVector<number>, MGTransferType>;
+
+  /**
+   * @brief Initialize.
+   *
+   * @param _mask Which blocks of the solve block belong to this diagonal block.
+   */
+  void
+  init(std::vector<bool> _mask)
+  {
+    clear();
+    mask               = std::move(_mask);
+    mg_level_operators = nullptr;
+    mg_transfer        = nullptr;
+    mg_dof_handlers.clear();
+  }
+
+  /**
+   * @brief Use V-cycles on the given hierarchy instead of the Chebyshev iteration.
+   */
+  void
+  set_multigrid(
+    const dealii::MGLevelObject<MFOperator<dim, degree, number>> &level_operators,
+    const MGTransferType                                         &transfer,
+    std::vector<const dealii::DoFHandler<dim> *>                  dof_handlers)
+  {
+    clear();
+    mg_level_operators = &level_operators;
+    mg_transfer        = &transfer;
+    mg_dof_handlers    = std::move(dof_handlers);
+  }
+
+  /**
+   * @brief Rebuild the inner solve for the current lhs operator. Re-initializing the
+   * Chebyshev iterations also redoes their eigenvalue estimates, because the operator
+   * changes between solves.
+   * @pre The diagonal of lhs_operator, or of the level operators with a multigrid
+   * hierarchy, has been evaluated.
+   */
+  void
+  reinit(const MFOperator<dim, degree, number> &lhs_operator,
+         const LinearSolverParameters          &lin_params)
+  {
+    const auto &chebyshev_params = lin_params.chebyshev_parameters;
+    typename Chebyshev::AdditionalData chebyshev_data;
+    chebyshev_data.degree              = chebyshev_params.degree;
+    chebyshev_data.smoothing_range     = chebyshev_params.smoothing_range;
+    chebyshev_data.eig_cg_n_iterations = chebyshev_params.eig_cg_n_iterations;
+
+    if (mg_level_operators == nullptr)
+      {
+        block_operator.init(lhs_operator, mask);
+        block_operator.reinit_diagonal();
+        chebyshev_data.preconditioner = block_operator.get_matrix_diagonal_inverse();
+        chebyshev.initialize(block_operator, chebyshev_data);
+        return;
+      }
+
+    // The multigrid objects refer to each other, so they are rebuilt together
+    clear();
+    const unsigned int min_level = mg_level_operators->min_level();
+    const unsigned int max_level = mg_level_operators->max_level();
+    level_operators.resize(min_level, max_level);
+    dealii::MGLevelObject<typename Chebyshev::AdditionalData> smoother_data(min_level,
+                                                                            max_level);
+    for (unsigned int level = min_level; level <= max_level; ++level)
+      {
+        level_operators[level].init((*mg_level_operators)[level], mask);
+        level_operators[level].reinit_diagonal();
+        smoother_data[level] = chebyshev_data;
+        smoother_data[level].preconditioner =
+          level_operators[level].get_matrix_diagonal_inverse();
+      }
+    smoother.initialize(level_operators, smoother_data);
+    coarse_solver.initialize(smoother);
+    mg_matrix = dealii::mg::Matrix<BlockVector<number>>(level_operators);
+    multigrid = std::make_unique<dealii::Multigrid<BlockVector<number>>>(
+      mg_matrix,
+      coarse_solver,
+      *mg_transfer,
+      smoother,
+      smoother,
+      min_level,
+      max_level,
+      dealii::Multigrid<BlockVector<number>>::Cycle::v_cycle);
+    preconditioner =
+      std::make_unique<PreconditionMG>(mg_dof_handlers, *multigrid, *mg_transfer);
+  }
+
+  /**
+   * @brief Release the multigrid objects, which refer to the transfer of the hierarchy
+   * and to the level operators.
+   */
+  void
+  clear()
+  {
+    preconditioner.reset();
+    multigrid.reset();
+    coarse_solver.clear();
+    smoother.clear();
+  }
+
+  /**
+   * @brief Apply the inner solve.
+   */
+  void
+  vmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    if (preconditioner != nullptr)
+      {
+        preconditioner->vmult(dst, src);
+      }
+    else
+      {
+        chebyshev.vmult(dst, src);
+      }
+  }
+
+private:
+  /**
+   * @brief Which blocks belong to this diagonal block.
+   */
+  std::vector<bool> mask;
+
+  /**
+   * @brief Diagonal block on the active mesh and its Chebyshev iteration.
+   */
+  BlockOperator block_operator;
+  Chebyshev     chebyshev;
+
+  /**
+   * @brief Multigrid hierarchy of the lhs operator, owned by the linear solver.
+   */
+  const dealii::MGLevelObject<MFOperator<dim, degree, number>> *mg_level_operators =
+    nullptr;
+  const MGTransferType                        *mg_transfer = nullptr;
+  std::vector<const dealii::DoFHandler<dim> *> mg_dof_handlers;
+
+  /**
+   * @brief Diagonal blocks of the level operators and the V-cycle on them.
+   */
+  dealii::MGLevelObject<BlockOperator>                    level_operators;
+  Smoother                                                smoother;
+  dealii::MGCoarseGridApplySmoother<BlockVector<number>>  coarse_solver;
+  dealii::mg::Matrix<BlockVector<number>>                 mg_matrix;
+  std::unique_ptr<dealii::Multigrid<BlockVector<number>>> multigrid;
+  std::unique_ptr<PreconditionMG>                         preconditioner;
+};
+
+/**
+ * @brief Approximate Schur complement S = D - C A^{-1} B of the 2x2 partition
+ *
+ *   [A B]
+ *   [C D]
+ *
+ * of the lhs operator, where A^{-1} is replaced by the inner solve of the first diagonal
+ * block. Like DiagonalBlockOperator, it acts on the second block and is padded
+ * with the identity on the first.
+ */
+template <unsigned int dim, unsigned int degree, typename number, typename InnerSolve>
+class SchurComplementOperator : public MATRIX_FREE_OPERATOR_BASE
+{
+public:
+  /**
+   * @brief Initialize.
+   */
+  void
+  init(const MFOperator<dim, degree, number> &_lhs_operator,
+       const InnerSolve                      &_first_solve,
+       std::vector<bool>                      _first_mask)
+  {
+    lhs_operator = &_lhs_operator;
+    first_solve  = &_first_solve;
+    first_mask   = std::move(_first_mask);
+  }
+
+  /**
+   * @brief Matrix-vector multiplication.
+   * @note requires dst is not ghosted
+   */
+  void
+  vmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    if (masked.size() != src.size())
+      {
+        masked.reinit(src, true);
+        first_block.reinit(src, true);
+        coupling.reinit(src, true);
+      }
+
+    // B v in the first rows and D v in the second rows
+    masked = src;
+    invert_restrict(masked);
+    lhs_operator->vmult(dst, masked);
+
+    // C A^{-1} B v
+    masked = dst;
+    restrict_to_blocks(masked, first_mask);
+    first_solve->vmult(first_block, masked);
+    restrict_to_blocks(first_block, first_mask);
+    lhs_operator->vmult(coupling, first_block);
+
+    dst -= coupling;
+    for (unsigned int block = 0; block < first_mask.size(); ++block)
+      {
+        if (first_mask[block])
+          {
+            dst.block(block) = src.block(block);
+          }
+      }
+  }
+
+private:
+  /**
+   * @brief Zero the blocks of the first diagonal block.
+   */
+  void
+  invert_restrict(BlockVector<number> &vector) const
+  {
+    for (unsigned int block = 0; block < first_mask.size(); ++block)
+      {
+        if (first_mask[block])
+          {
+            vector.block(block) = 0.0;
+          }
+      }
+  }
+
+  /**
+   * @brief The lhs operator of the whole solve block.
+   */
+  const MFOperator<dim, degree, number> *lhs_operator = nullptr;
+
+  /**
+   * @brief Approximate inverse of the first diagonal block.
+   */
+  const InnerSolve *first_solve = nullptr;
+
+  /**
+   * @brief Which blocks belong to the first diagonal block.
+   */
+  std::vector<bool> first_mask;
+
+  /**
+   * @brief Scratch vectors.
+   */
+  mutable BlockVector<number> masked;
+  mutable BlockVector<number> first_block;
+  mutable BlockVector<number> coupling;
+};
+
+/**
+ * @brief Block preconditioners for solve blocks with several coupled fields.
+ *
+ * The fields of the solve block, ordered by field index, are split into a leading group
+ * of "block split" fields and the remaining fields, which gives the 2x2 partition
+ *
+ *   [A B]
+ *   [C D]
+ *
+ * of the lhs operator. All sub-blocks are applied through the user's compute_lhs by
+ * masking its input, and each diagonal block is approximately inverted with a Chebyshev
+ * iteration on its diagonal or a multigrid V-cycle, see DiagonalBlockSolve. The available
+ * forms are
+ *
+ *   - block diagonal: diag(A, D)^{-1},
+ *   - block lower triangular: [A 0; C D]^{-1},
+ *   - block upper triangular: [A B; 0 D]^{-1},
+ *   - Schur complement: the full block factorization with S = D - C A^{-1} B, which is
+ *     solved with a few GMRES iterations preconditioned by the inner solve of D.
+ *
+ * Unlike the block diagonal preconditioners, the triangular and Schur forms account for
+ * the off-diagonal coupling, e.g., the c/mu coupling of an implicit Cahn-Hilliard solve.
+ * The Schur complement form is a variable preconditioner, so it should be paired with
+ * FGMRES.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class BlockPreconditioner
+{
+public:
+  using InnerSolve = DiagonalBlockSolve<dim, degree, number>;
+
+  /**
+   * @brief Initialize.
+   *
+   * @param n_blocks Number of fields in the solve block.
+   */
+  void
+  init(unsigned int n_blocks, const LinearSolverParameters &_lin_params)
+  {
+    lin_params = &_lin_params;
+    AssertThrow(lin_params->block_split > 0 && lin_params->block_split < n_blocks,
+                dealii::ExcMessage("The block split (" +
+                                   std::to_string(lin_params->block_split) +
+                                   ") must be between 1 and the number of fields in the "
+                                   "solve block minus one (" +
+                                   std::to_string(n_blocks - 1) + ")"));
+    first_mask.assign(n_blocks, false);
+    second_mask.assign(n_blocks, true);
+    for (unsigned int block = 0; block < lin_params->block_split; ++block)
+      {
+        first_mask[block]  = true;
+        second_mask[block] = false;
+      }
+    first_solve.init(first_mask);
+    second_solve.init(second_mask);
+  }
+
+  /**
+   * @brief Use multigrid V-cycles as the inner solves of the diagonal blocks.
+   *
+   * @param level_operators Level operators of the whole solve block.
+   * @param transfer Block transfer between the levels.
+   * @param dof_handlers DoFHandlers of the fields of the solve block.
+   */
+  void
+  set_multigrid(
+    const dealii::MGLevelObject<MFOperator<dim, degree, number>> &level_operators,
+    const typename InnerSolve::MGTransferType                    &transfer,
+    const std::vector<const dealii::DoFHandler<dim> *>           &dof_handlers)
+  {
+    first_solve.set_multigrid(level_operators, transfer, dof_handlers);
+    second_solve.set_multigrid(level_operators, transfer, dof_handlers);
+  }
+
+  /**
+   * @brief Release the multigrid inner solves, e.g., before the hierarchy is rebuilt.
+   */
+  void
+  clear()
+  {
+    first_solve.clear();
+    second_solve.clear();
+  }
+
+  /**
+   * @brief Rebuild the inner solves for the current lhs operator.
+   * @pre The diagonal of lhs_operator, or of the level operators with multigrid inner
+   * solves, has been evaluated.
+   */
+  void
+  reinit(const MFOperator<dim, degree, number> &_lhs_operator)
+  {
+    Assert(lin_params != nullptr, dealii::ExcNotInitialized());
+    lhs_operator = &_lhs_operator;
+
+    schur_operator.init(*lhs_operator, first_solve, first_mask);
+    first_solve.reinit(*lhs_operator, *lin_params);
+    second_solve.reinit(*lhs_operator, *lin_params);
+
+    const BlockVector<number> &layout =
+      lhs_operator->get_matrix_diagonal_inverse()->get_vector();
+    rhs.reinit(layout, true);
+    tmp.reinit(layout, true);
+    first_block.reinit(layout, true);
+    second_block.reinit(layout, true);
+  }
+
+  /**
+   * @brief Apply the preconditioner.
+   */
+  void
+  vmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    Timer::start_section("Block preconditioner");
+    switch (lin_params->block_form)
+      {
+        case BlockDiagonal:
+          {
+            solve_first(first_block, src);
+            solve_second(second_block, src);
+            break;
+          }
+        case BlockLowerTriangular:
+          {
+            // y = A^{-1} b_A, z = D^{-1} (b_D - C y)
+            solve_first(first_block, src);
+            lhs_operator->vmult(tmp, first_block);
+            rhs = src;
+            rhs -= tmp;
+            solve_second(second_block, rhs);
+            break;
+          }
+        case BlockUpperTriangular:
+          {
+            // z = D^{-1} b_D, y = A^{-1} (b_A - B z)
+            solve_second(second_block, src);
+            lhs_operator->vmult(tmp, second_block);
+            rhs = src;
+            rhs -= tmp;
+            solve_first(first_block, rhs);
+            break;
+          }
+        case BlockSchurComplement:
+          {
+            // y = A^{-1} b_A, S z = b_D - C y, y = A^{-1} (b_A - B z)
+            solve_first(first_block, src);
+            lhs_operator->vmult(tmp, first_block);
+            rhs = src;
+            rhs -= tmp;
+            restrict_to_blocks(rhs, second_mask);
+
+            dealii::IterationNumberControl schur_control(
+              lin_params->schur_inner_iterations,
+              0.0,
+              false,
+              false);
+            dealii::SolverGMRES<BlockVector<number>> schur_solver(schur_control);
+            second_block = 0.0;
+            schur_solver.solve(schur_operator, second_block, rhs, second_solve);
+            restrict_to_blocks(second_block, second_mask);
+
+            lhs_operator->vmult(tmp, second_block);
+            rhs = src;
+            rhs -= tmp;
+            solve_first(first_block, rhs);
+            break;
+          }
+        default:
+          {
+            AssertThrow(false, UnreachableCode());
+          }
+      }
+    dst = first_block;
+    dst += second_block;
+    Timer::end_section("Block preconditioner");
+  }
+
+private:
+  /**
+   * @brief Apply the inner solve of the first diagonal block to the first rows of src.
+   */
+  void
+  solve_first(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    rhs = src;
+    restrict_to_blocks(rhs, first_mask);
+    first_solve.vmult(dst, rhs);
+    restrict_to_blocks(dst, first_mask);
+  }
+
+  /**
+   * @brief Apply the inner solve of the second diagonal block to the second rows of src.
+   */
+  void
+  solve_second(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    rhs = src;
+    restrict_to_blocks(rhs, second_mask);
+    second_solve.vmult(dst, rhs);
+    restrict_to_blocks(dst, second_mask);
+  }
+
+  /**
+   * @brief Linear solver parameters.
+   */
+  const LinearSolverParameters *lin_params = nullptr;
+
+  /**
+   * @brief The lhs operator of the whole solve block.
+   */
+  const MFOperator<dim, degree, number> *lhs_operator = nullptr;
+
+  /**
+   * @brief Which blocks belong to the first and second diagonal block.
+   */
+  std::vector<bool> first_mask;
+  std::vector<bool> second_mask;
+
+  /**
+   * @brief Inner solves of the diagonal blocks.
+   */
+  InnerSolve first_solve;
+  InnerSolve second_solve;
+
+  /**
+   * @brief Approximate Schur complement of the first diagonal block.
+   */
+  SchurComplementOperator<dim, degree, number, InnerSolve> schur_operator;
+
+  /**
+   * @brief Scratch vectors.
+   */
+  mutable BlockVector<number> rhs;
+  mutable BlockVector<number> tmp;
+  mutable BlockVector<number> first_block;
+  mutable BlockVector<number> second_block;
+};
+
+PRISMS_PF_END_NAMESPACE
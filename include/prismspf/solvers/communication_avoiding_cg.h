@@ -0,0 +1,384 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <prismspf/config.h>
+
+#include <array>
+#include <cmath>
+#include <mpi.h>
+#include <utility>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Sum of the products of the locally owned entries of two block vectors.
+ *
+ * This is the process-local part of a dot product, so that several of them can be
+ * reduced in a single message.
+ */
+template <typename VectorType>
+inline double
+local_dot(const VectorType &vector_a, const VectorType &vector_b)
+{
+  double sum = 0.0;
+  for (unsigned int block = 0; block < vector_a.n_blocks(); ++block)
+    {
+      const auto &block_a = vector_a.block(block);
+      const auto &block_b = vector_b.block(block);
+      for (unsigned int i = 0; i < block_a.locally_owned_size(); ++i)
+        {
+          sum += double(block_a.local_element(i)) * double(block_b.local_element(i));
+        }
+    }
+  return sum;
+}
+
+/**
+ * @brief Pipelined preconditioned conjugate gradient method of Ghysels and Vanroose.
+ *
+ * Each iteration needs the three dot products (r, u), (w, u), and (r, r), which are
+ * reduced in a single non-blocking MPI_Iallreduce. The reduction is overlapped with the
+ * preconditioner and operator application of the same iteration. In exact arithmetic the
+ * iterates are the same as those of CG, at the cost of four additional vectors and a
+ * somewhat larger rounding error in the recursively updated residual. The stopping
+ * criterion uses the l2 norm of the unpreconditioned residual, like dealii::SolverCG.
+ */
+template <typename VectorType>
+class SolverPipelinedCG : public dealii::SolverBase<VectorType>
+{
+public:
+  /**
+   * @brief There are no additional parameters.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * @brief Constructor.
+   */
+  explicit SolverPipelinedCG(dealii::SolverControl &solver_control,
+                             const AdditionalData  &data = AdditionalData())
+    : dealii::SolverBase<VectorType>(solver_control)
+  {
+    (void) data;
+  }
+
+  /**
+   * @brief Solve A x = b.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType         &matrix,
+        VectorType               &x_vector,
+        const VectorType         &b_vector,
+        const PreconditionerType &preconditioner)
+  {
+    const MPI_Comm communicator = x_vector.block(0).get_mpi_communicator();
+
+    // Residual r, preconditioned residual u, and w = A u. The remaining vectors are the
+    // search direction p and its recurrences s = A p, q = M s, and z = A q.
+    VectorType r_vector;
+    VectorType u_vector;
+    VectorType w_vector;
+    VectorType m_vector;
+    VectorType n_vector;
+    VectorType p_vector;
+    VectorType s_vector;
+    VectorType q_vector;
+    VectorType z_vector;
+    for (VectorType *vector : {&r_vector,
+                               &u_vector,
+                               &w_vector,
+                               &m_vector,
+                               &n_vector,
+                               &p_vector,
+                               &s_vector,
+                               &q_vector,
+                               &z_vector})
+      {
+        vector->reinit(x_vector, false);
+      }
+
+    matrix.vmult(r_vector, x_vector);
+    r_vector.sadd(-1.0, 1.0, b_vector);
+    preconditioner.vmult(u_vector, r_vector);
+    matrix.vmult(w_vector, u_vector);
+
+    double gamma_old = 0.0;
+    double alpha_old = 0.0;
+
+    dealii::SolverControl::State state         = dealii::SolverControl::iterate;
+    unsigned int                 step          = 0;
+    double                       residual_norm = 0.0;
+    while (state == dealii::SolverControl::iterate)
+      {
+        std::array<double, 3> dots = {local_dot(r_vector, u_vector),
+                                      local_dot(w_vector, u_vector),
+                                      local_dot(r_vector, r_vector)};
+        MPI_Request           request {};
+        MPI_Iallreduce(MPI_IN_PLACE,
+                       dots.data(),
+                       int(dots.size()),
+                       MPI_DOUBLE,
+                       MPI_SUM,
+                       communicator,
+                       &request);
+
+        // Overlap the reduction with m = M w and n = A m
+        preconditioner.vmult(m_vector, w_vector);
+        matrix.vmult(n_vector, m_vector);
+
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+        residual_norm = std::sqrt(dots[2]);
+        state         = this->iteration_status(step, residual_norm, x_vector);
+        if (state != dealii::SolverControl::iterate)
+          {
+            break;
+          }
+
+        const double gamma = dots[0];
+        const double delta = dots[1];
+        double       beta  = 0.0;
+        double       alpha = 0.0;
+        if (step == 0)
+          {
+            Assert(delta != 0.0, dealii::ExcDivideByZero());
+            alpha = gamma / delta;
+          }
+        else
+          {
+            beta                     = gamma / gamma_old;
+            const double denominator = delta - (beta * gamma / alpha_old);
+            Assert(denominator != 0.0, dealii::ExcDivideByZero());
+            alpha = gamma / denominator;
+          }
+
+        z_vector.sadd(beta, 1.0, n_vector);
+        q_vector.sadd(beta, 1.0, m_vector);
+        s_vector.sadd(beta, 1.0, w_vector);
+        p_vector.sadd(beta, 1.0, u_vector);
+
+        x_vector.add(alpha, p_vector);
+        r_vector.add(-alpha, s_vector);
+        u_vector.add(-alpha, q_vector);
+        w_vector.add(-alpha, z_vector);
+
+        gamma_old = gamma;
+        alpha_old = alpha;
+        ++step;
+      }
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(step, residual_norm));
+  }
+};
+
+/**
+ * @brief s-step preconditioned conjugate gradient method of Chronopoulos and Gear.
+ *
+ * Every outer iteration builds the basis [z, MAz, ..., (MA)^{s-1} z] of the
+ * preconditioned Krylov space from the preconditioned residual z = M r with s operator
+ * applications, makes it A-conjugate to the previous basis, and minimizes the A-norm of
+ * the error over it. All dot products of an outer iteration, including the residual
+ * norm, are reduced in one message, so there is one global reduction per s CG steps
+ * instead of two per step.
+ *
+ * The monomial basis becomes ill-conditioned as s grows. Each basis vector is rescaled
+ * by the growth of the A-norms observed in the previous outer iteration, which keeps
+ * step sizes up to about 4 to 6 usable for well-preconditioned problems. The iteration
+ * count reported to the SolverControl is the number of operator applications.
+ */
+template <typename VectorType>
+class SolverSStepCG : public dealii::SolverBase<VectorType>
+{
+public:
+  /**
+   * @brief Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    explicit AdditionalData(unsigned int _step_size = 4)
+      : step_size(_step_size)
+    {}
+
+    /**
+     * @brief Number of CG steps per global reduction.
+     */
+    unsigned int step_size;
+  };
+
+  /**
+   * @brief Constructor.
+   */
+  explicit SolverSStepCG(dealii::SolverControl &solver_control,
+                         const AdditionalData  &_data = AdditionalData())
+    : dealii::SolverBase<VectorType>(solver_control)
+    , data(_data)
+  {
+    AssertThrow(data.step_size > 0,
+                dealii::ExcMessage("The s-step CG step size must be positive"));
+  }
+
+  /**
+   * @brief Solve A x = b.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType         &matrix,
+        VectorType               &x_vector,
+        const VectorType         &b_vector,
+        const PreconditionerType &preconditioner)
+  {
+    const MPI_Comm     communicator = x_vector.block(0).get_mpi_communicator();
+    const unsigned int s_size       = data.step_size;
+
+    VectorType r_vector;
+    r_vector.reinit(x_vector, false);
+    matrix.vmult(r_vector, x_vector);
+    r_vector.sadd(-1.0, 1.0, b_vector);
+
+    // New basis S and A S, and the conjugate directions P and A P of the previous
+    // outer iteration
+    std::vector<VectorType> basis(s_size);
+    std::vector<VectorType> basis_images(s_size);
+    std::vector<VectorType> directions(s_size);
+    std::vector<VectorType> direction_images(s_size);
+    for (unsigned int j = 0; j < s_size; ++j)
+      {
+        basis[j].reinit(x_vector, false);
+        basis_images[j].reinit(x_vector, false);
+        directions[j].reinit(x_vector, false);
+        direction_images[j].reinit(x_vector, false);
+      }
+
+    dealii::FullMatrix<double> gram(s_size, s_size);
+    dealii::FullMatrix<double> old_gram_inverse(s_size, s_size);
+    dealii::FullMatrix<double> coupling(s_size, s_size);
+    dealii::FullMatrix<double> conjugation(s_size, s_size);
+    dealii::FullMatrix<double> correction(s_size, s_size);
+    dealii::Vector<double>     projected_residual(s_size);
+    dealii::Vector<double>     coefficients(s_size);
+    std::vector<double>        scaling(s_size, 1.0);
+
+    // S^T A S, P^T A S, S^T r, and r^T r
+    std::vector<double> dots((2 * s_size * s_size) + s_size + 1);
+    const unsigned int  coupling_offset = s_size * s_size;
+    const unsigned int  residual_offset = 2 * s_size * s_size;
+    bool                first_iteration = true;
+
+    dealii::SolverControl::State state         = dealii::SolverControl::iterate;
+    unsigned int                 step          = 0;
+    double                       residual_norm = 0.0;
+    while (state == dealii::SolverControl::iterate)
+      {
+        // Build the scaled monomial basis
+        preconditioner.vmult(basis[0], r_vector);
+        matrix.vmult(basis_images[0], basis[0]);
+        for (unsigned int j = 1; j < s_size; ++j)
+          {
+            preconditioner.vmult(basis[j], basis_images[j - 1]);
+            basis[j] /= scaling[j];
+            matrix.vmult(basis_images[j], basis[j]);
+          }
+
+        // One reduction for all dot products of this outer iteration
+        for (unsigned int i = 0; i < s_size; ++i)
+          {
+            for (unsigned int j = 0; j < s_size; ++j)
+              {
+                dots[(i * s_size) + j] = local_dot(basis[i], basis_images[j]);
+                dots[coupling_offset + (i * s_size) + j] =
+                  first_iteration ? 0.0 : local_dot(direction_images[i], basis[j]);
+              }
+            dots[residual_offset + i] = local_dot(basis[i], r_vector);
+          }
+        dots.back() = local_dot(r_vector, r_vector);
+        MPI_Allreduce(MPI_IN_PLACE,
+                      dots.data(),
+                      int(dots.size()),
+                      MPI_DOUBLE,
+                      MPI_SUM,
+                      communicator);
+
+        residual_norm = std::sqrt(dots.back());
+        state         = this->iteration_status(step, residual_norm, x_vector);
+        if (state != dealii::SolverControl::iterate)
+          {
+            break;
+          }
+
+        for (unsigned int i = 0; i < s_size; ++i)
+          {
+            for (unsigned int j = 0; j < s_size; ++j)
+              {
+                gram(i, j)     = dots[(i * s_size) + j];
+                coupling(i, j) = dots[coupling_offset + (i * s_size) + j];
+              }
+            projected_residual(i) = dots[residual_offset + i];
+          }
+
+        // Update the scaling from the growth of the A-norms of the basis
+        for (unsigned int j = 1; j < s_size; ++j)
+          {
+            if (gram(j - 1, j - 1) > 0.0 && gram(j, j) > 0.0)
+              {
+                scaling[j] *= std::sqrt(gram(j, j) / gram(j - 1, j - 1));
+              }
+          }
+
+        // Make the basis A-conjugate to the previous directions, P = S - P_old B with
+        // B = (P_old^T A P_old)^{-1} P_old^T A S. Since P_old^T r = 0, the projected
+        // residual is unchanged.
+        if (!first_iteration)
+          {
+            old_gram_inverse.mmult(conjugation, coupling);
+            coupling.Tmmult(correction, conjugation);
+            gram.add(-1.0, correction);
+            for (unsigned int j = 0; j < s_size; ++j)
+              {
+                for (unsigned int i = 0; i < s_size; ++i)
+                  {
+                    basis[j].add(-conjugation(i, j), directions[i]);
+                    basis_images[j].add(-conjugation(i, j), direction_images[i]);
+                  }
+              }
+          }
+
+        // Minimize the A-norm of the error over the new directions
+        old_gram_inverse = gram;
+        old_gram_inverse.gauss_jordan();
+        old_gram_inverse.vmult(coefficients, projected_residual);
+        for (unsigned int j = 0; j < s_size; ++j)
+          {
+            x_vector.add(coefficients(j), basis[j]);
+            r_vector.add(-coefficients(j), basis_images[j]);
+          }
+
+        std::swap(basis, directions);
+        std::swap(basis_images, direction_images);
+        first_iteration = false;
+        step += s_size;
+      }
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(step, residual_norm));
+  }
+
+private:
+  /**
+   * @brief Solver parameters.
+   */
+  const AdditionalData data;
+};
+
+PRISMS_PF_END_NAMESPACE
@@ -0,0 +1,348 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <prismspf/config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Approximate eigenvectors that are recycled between the linear solves of a solve
+ * block.
+ *
+ * The vectors are kept A-orthonormal, so the deflation projection needs no Gram matrix.
+ * They refer to the DoF layout of the mesh they were computed on and must be cleared
+ * when the mesh changes.
+ */
+template <typename VectorType>
+struct DeflationSpace
+{
+  /**
+   * @brief Drop the recycled vectors.
+   */
+  void
+  clear()
+  {
+    vectors.clear();
+    images.clear();
+  }
+
+  /**
+   * @brief Number of recycled vectors.
+   */
+  [[nodiscard]] unsigned int
+  size() const
+  {
+    return vectors.size();
+  }
+
+  /**
+   * @brief Recycled vectors W.
+   */
+  std::vector<VectorType> vectors;
+
+  /**
+   * @brief Operator applied to the recycled vectors, A W.
+   */
+  std::vector<VectorType> images;
+};
+
+/**
+ * @brief Deflated preconditioned conjugate gradient method with subspace recycling.
+ *
+ * This is the deflated CG of Saad, Yeung, Erhel, and Guyomarc'h. The initial guess is
+ * corrected so that the residual is orthogonal to the recycled space W, and every search
+ * direction is made A-orthogonal to W, which removes the eigenvalues captured by W from
+ * the convergence of CG. Each iteration costs the dot products and vector updates of one
+ * extra vector per recycled vector.
+ *
+ * After the solve, the Ritz vectors of the smallest eigenvalues of A on the span of W and
+ * the first search directions become the new recycled space. Because the operator of a
+ * solve block changes slowly between increments, they remain good approximate
+ * eigenvectors for the next solve. The recycled vectors are re-orthonormalized with the
+ * current operator at the start of every solve, at the cost of one operator application
+ * per recycled vector.
+ */
+template <typename VectorType>
+class SolverDeflatedCG : public dealii::SolverBase<VectorType>
+{
+public:
+  /**
+   * @brief Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    explicit AdditionalData(unsigned int _space_size = 8, unsigned int _harvest_size = 20)
+      : space_size(_space_size)
+      , harvest_size(_harvest_size)
+    {}
+
+    /**
+     * @brief Number of vectors that are recycled.
+     */
+    unsigned int space_size;
+
+    /**
+     * @brief Number of search directions of each solve that are used to update the
+     * recycled vectors.
+     */
+    unsigned int harvest_size;
+  };
+
+  /**
+   * @brief Constructor.
+   */
+  SolverDeflatedCG(dealii::SolverControl      &solver_control,
+                   DeflationSpace<VectorType> &_space,
+                   const AdditionalData       &_data = AdditionalData())
+    : dealii::SolverBase<VectorType>(solver_control)
+    , space(&_space)
+    , data(_data)
+  {}
+
+  /**
+   * @brief Solve A x = b.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType         &matrix,
+        VectorType               &x_vector,
+        const VectorType         &b_vector,
+        const PreconditionerType &preconditioner)
+  {
+    refresh_space(matrix, x_vector);
+
+    VectorType r_vector;
+    VectorType z_vector;
+    VectorType p_vector;
+    VectorType ap_vector;
+    r_vector.reinit(x_vector, false);
+    z_vector.reinit(x_vector, false);
+    p_vector.reinit(x_vector, false);
+    ap_vector.reinit(x_vector, false);
+
+    matrix.vmult(r_vector, x_vector);
+    r_vector.sadd(-1.0, 1.0, b_vector);
+
+    // Make the residual orthogonal to W
+    for (unsigned int j = 0; j < space->size(); ++j)
+      {
+        const double coefficient = space->vectors[j] * r_vector;
+        x_vector.add(coefficient, space->vectors[j]);
+        r_vector.add(-coefficient, space->images[j]);
+      }
+
+    preconditioner.vmult(z_vector, r_vector);
+    p_vector = z_vector;
+    deflate(p_vector, z_vector);
+    double residual_dot = r_vector * z_vector;
+
+    std::vector<VectorType> directions;
+    std::vector<VectorType> direction_images;
+    directions.reserve(data.harvest_size);
+    direction_images.reserve(data.harvest_size);
+
+    unsigned int                 step          = 0;
+    double                       residual_norm = r_vector.l2_norm();
+    dealii::SolverControl::State state =
+      this->iteration_status(step, residual_norm, x_vector);
+    while (state == dealii::SolverControl::iterate)
+      {
+        matrix.vmult(ap_vector, p_vector);
+        const double curvature = p_vector * ap_vector;
+        Assert(curvature > 0.0,
+               dealii::ExcMessage("The deflated CG solver requires a symmetric positive "
+                                  "definite operator"));
+        const double alpha = residual_dot / curvature;
+
+        // Keep the A-normalized search direction for the new recycled space
+        if (directions.size() < data.harvest_size && data.space_size > 0)
+          {
+            const double scale = 1.0 / std::sqrt(curvature);
+            directions.emplace_back(p_vector);
+            directions.back() *= scale;
+            direction_images.emplace_back(ap_vector);
+            direction_images.back() *= scale;
+          }
+
+        x_vector.add(alpha, p_vector);
+        r_vector.add(-alpha, ap_vector);
+
+        ++step;
+        residual_norm = r_vector.l2_norm();
+        state         = this->iteration_status(step, residual_norm, x_vector);
+        if (state != dealii::SolverControl::iterate)
+          {
+            break;
+          }
+
+        preconditioner.vmult(z_vector, r_vector);
+        const double new_residual_dot = r_vector * z_vector;
+        const double beta             = new_residual_dot / residual_dot;
+        residual_dot                  = new_residual_dot;
+
+        p_vector.sadd(beta, 1.0, z_vector);
+        deflate(p_vector, z_vector);
+      }
+
+    harvest(directions, direction_images);
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(step, residual_norm));
+  }
+
+private:
+  /**
+   * @brief Subtract the A-orthogonal projection of z onto W from p.
+   */
+  void
+  deflate(VectorType &p_vector, const VectorType &z_vector) const
+  {
+    for (unsigned int j = 0; j < space->size(); ++j)
+      {
+        p_vector.add(-(space->images[j] * z_vector), space->vectors[j]);
+      }
+  }
+
+  /**
+   * @brief Apply the current operator to the recycled vectors and A-orthonormalize them
+   * with modified Gram-Schmidt. Nearly dependent vectors are dropped.
+   */
+  template <typename MatrixType>
+  void
+  refresh_space(const MatrixType &matrix, const VectorType &x_vector)
+  {
+    const double drop_tolerance = 1.0e-8;
+
+    if (space->size() > 0 && space->vectors.front().size() != x_vector.size())
+      {
+        space->clear();
+      }
+
+    std::vector<VectorType> vectors;
+    std::vector<VectorType> images;
+    for (VectorType &vector : space->vectors)
+      {
+        VectorType image;
+        image.reinit(x_vector, false);
+        matrix.vmult(image, vector);
+        const double original_norm = std::sqrt(std::abs(vector * image));
+
+        for (unsigned int j = 0; j < vectors.size(); ++j)
+          {
+            const double coefficient = images[j] * vector;
+            vector.add(-coefficient, vectors[j]);
+            image.add(-coefficient, images[j]);
+          }
+        const double norm_squared = vector * image;
+        if (norm_squared <= 0.0 ||
+            std::sqrt(norm_squared) <= drop_tolerance * original_norm)
+          {
+            continue;
+          }
+        const double scale = 1.0 / std::sqrt(norm_squared);
+        vector *= scale;
+        image *= scale;
+        vectors.push_back(std::move(vector));
+        images.push_back(std::move(image));
+      }
+    space->vectors = std::move(vectors);
+    space->images  = std::move(images);
+  }
+
+  /**
+   * @brief Replace the recycled space with the Ritz vectors of the smallest eigenvalues
+   * of A on the span of the recycled vectors and the harvested search directions.
+   */
+  void
+  harvest(std::vector<VectorType> &directions, std::vector<VectorType> &direction_images)
+  {
+    if (data.space_size == 0)
+      {
+        space->clear();
+        return;
+      }
+
+    // Basis Z = [W, P] and A Z
+    std::vector<VectorType> &basis  = space->vectors;
+    std::vector<VectorType> &images = space->images;
+    for (unsigned int j = 0; j < directions.size(); ++j)
+      {
+        basis.push_back(std::move(directions[j]));
+        images.push_back(std::move(direction_images[j]));
+      }
+    const unsigned int n_basis = basis.size();
+    if (n_basis <= data.space_size)
+      {
+        return;
+      }
+
+    // Generalized eigenproblem Z^T A Z y = lambda Z^T Z y
+    dealii::LAPACKFullMatrix<double> stiffness(n_basis, n_basis);
+    dealii::LAPACKFullMatrix<double> mass(n_basis, n_basis);
+    for (unsigned int i = 0; i < n_basis; ++i)
+      {
+        for (unsigned int j = i; j < n_basis; ++j)
+          {
+            const double stiffness_entry =
+              0.5 * ((basis[i] * images[j]) + (basis[j] * images[i]));
+            const double mass_entry = basis[i] * basis[j];
+            stiffness(i, j)         = stiffness_entry;
+            stiffness(j, i)         = stiffness_entry;
+            mass(i, j)              = mass_entry;
+            mass(j, i)              = mass_entry;
+          }
+      }
+    std::vector<dealii::Vector<double>> eigenvectors(n_basis,
+                                                     dealii::Vector<double>(n_basis));
+    stiffness.compute_generalized_eigenvalues_symmetric(mass, eigenvectors);
+
+    std::vector<unsigned int> order(n_basis);
+    std::iota(order.begin(), order.end(), 0U);
+    std::sort(order.begin(),
+              order.end(),
+              [&](unsigned int lhs, unsigned int rhs)
+              {
+                return stiffness.eigenvalue(lhs).real() <
+                       stiffness.eigenvalue(rhs).real();
+              });
+
+    // The Ritz vectors are A-orthogonal up to rounding, which the next refresh corrects
+    std::vector<VectorType> ritz_vectors(data.space_size);
+    for (unsigned int k = 0; k < data.space_size; ++k)
+      {
+        const dealii::Vector<double> &coefficients = eigenvectors[order[k]];
+        ritz_vectors[k].reinit(basis.front(), false);
+        for (unsigned int j = 0; j < n_basis; ++j)
+          {
+            ritz_vectors[k].add(coefficients(j), basis[j]);
+          }
+      }
+    space->vectors = std::move(ritz_vectors);
+    space->images.clear();
+  }
+
+  /**
+   * @brief Recycled space, owned by the caller so that it outlives the solver.
+   */
+  DeflationSpace<VectorType> *space;
+
+  /**
+   * @brief Solver parameters.
+   */
+  const AdditionalData data;
+};
+
+PRISMS_PF_END_NAMESPACE
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <prismspf/core/simulation_timer.h>
 #include <prismspf/core/timer.h>
+#include <prismspf/core/type_enums.h>
 #include <prismspf/core/types.h>
 
 #include <prismspf/solvers/mf_operator.h>
@@ -11,6 +13,10 @@
 
 #include <prismspf/config.h>
 
+#include <array>
+#include <cmath>
+#include <limits>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -18,6 +24,14 @@ class SolveContext;
 
 /**
  * @brief This class handles the explicit solves of all explicit fields
+ *
+ * With a user-defined update, the RHS is the new value of the fields. Otherwise, the RHS
+ * is the time derivative f(u) of the fields, which is integrated by the solve block's
+ * explicit integrator. The RHS reads the state u through old_1, which holds the stage
+ * state while the RHS is evaluated. Other fields are frozen at the beginning of the
+ * increment. The RHS of each stage sees the stage time t_n + c_i dt through a copy of
+ * the simulation timer, while the Dirichlet values stay at the end of the increment,
+ * as they do for substeps.
  */
 template <unsigned int dim, unsigned int degree, typename number>
 class ExplicitSolver : public SolverBase<dim, degree, number>
@@ -46,13 +60,23 @@ public:
                       solve_context->get_field_attributes(),
                       solve_context->get_solution_indexer(),
                       solve_context->get_matrix_free_manager(),
-                      solve_context->get_simulation_timer(),
+                      stage_timer,
                       solve_block,
                       solve_block.dependencies_rhs);
     rhs_operator.set_scaling_diagonal(
       true,
       solve_context->get_invm_manager().get_invm(solve_context->get_field_attributes(),
                                                  solve_block.field_indices));
+
+    // The time derivative and, for the low-storage scheme, the accumulated update
+    if (solve_block.explicit_integrator == LowStorageRK4)
+      {
+        solutions.init_stage_vectors(2);
+      }
+    else if (solve_block.explicit_integrator != UserDefinedUpdate)
+      {
+        solutions.init_stage_vectors(1);
+      }
   }
 
   /**
@@ -66,7 +90,19 @@ public:
     solutions.zero_out_ghosts();
     Timer::end_section("Zero ghosts");
 
-    rhs_operator.compute_operator(solutions.get_solution_full_vector());
+    if (solve_block.explicit_integrator == UserDefinedUpdate)
+      {
+        set_stage_time(1.0);
+        rhs_operator.compute_operator(solutions.get_solution_full_vector());
+      }
+    else if (solve_block.explicit_integrator == LowStorageRK4)
+      {
+        integrate_low_storage();
+      }
+    else
+      {
+        integrate_shu_osher();
+      }
 
     // Apply constraints
     solutions.apply_constraints();
@@ -77,7 +113,248 @@ public:
     Timer::end_section("Update ghosts");
   }
 
+  /**
+   * @brief Estimate the maximum stable timestep from the largest eigenvalue magnitude of
+   * the Jacobian of the time derivative at the state of the last increment.
+   *
+   * The eigenvalue is found with power iterations, where each product of the Jacobian is
+   * a finite difference of the RHS, so the estimate only covers the coupling between the
+   * fields of this solve block. With a user-defined update, the RHS is taken to be
+   * u + dt f(u), i.e., forward Euler. The stable timestep is the extent of the stability
+   * region of the integrator along the negative real axis divided by the eigenvalue,
+   * which is exact for diffusive problems. For subcycled solve blocks, it is the
+   * timestep of a substep.
+   */
+  [[nodiscard]] double
+  estimate_stable_timestep() override
+  {
+    if (solutions.get_primary_solutions().old_solutions.empty())
+      {
+        return std::numeric_limits<double>::max();
+      }
+    const unsigned int n_iterations = solve_context->get_user_inputs()
+                                        .temporal_discretization
+                                        .stable_timestep_power_iterations;
+    const double timestep =
+      solve_context->get_simulation_timer().get_timestep() / solve_block.n_substeps;
+    const bool user_defined_update =
+      solve_block.explicit_integrator == UserDefinedUpdate;
+
+    // The RHS reads the state through old_1, which is perturbed in place and restored
+    // at the end
+    BlockVector<number> &old_state = solutions.get_old_solution_full_vector(0);
+    BlockVector<number>  base_state;
+    BlockVector<number>  base_rhs;
+    BlockVector<number>  perturbed_rhs;
+    BlockVector<number>  direction;
+    base_state.reinit(old_state, true);
+    base_rhs.reinit(old_state, true);
+    perturbed_rhs.reinit(old_state, true);
+    direction.reinit(old_state, true);
+    base_state = old_state;
+    set_stage_time(1.0);
+    rhs_operator.compute_operator(base_rhs);
+
+    // Start from the highest frequency mode, which dominates for diffusion
+    for (unsigned int block = 0; block < direction.n_blocks(); ++block)
+      {
+        SolutionVector<number> &direction_block = direction.block(block);
+        for (unsigned int i = 0; i < direction_block.locally_owned_size(); ++i)
+          {
+            direction_block.local_element(i) =
+              (direction_block.get_partitioner()->local_to_global(i) % 2 == 0) ? 1.0
+                                                                               : -1.0;
+          }
+      }
+    solutions.apply_constraints(direction);
+
+    const double epsilon = std::sqrt(std::numeric_limits<double>::epsilon()) *
+                           (1.0 + base_state.linfty_norm());
+    double eigenvalue = 0.0;
+    for (unsigned int iteration = 0; iteration < n_iterations; ++iteration)
+      {
+        const double direction_norm = direction.l2_norm();
+        if (direction_norm == 0.0)
+          {
+            break;
+          }
+        direction /= direction_norm;
+
+        old_state.zero_out_ghost_values();
+        old_state = base_state;
+        old_state.add(epsilon, direction);
+        old_state.update_ghost_values();
+        rhs_operator.compute_operator(perturbed_rhs);
+
+        // Jacobian of the time derivative applied to the direction. A user-defined
+        // update gives (I + dt J) d, so d / dt is subtracted after the scaling.
+        perturbed_rhs -= base_rhs;
+        perturbed_rhs /= user_defined_update ? epsilon * timestep : epsilon;
+        if (user_defined_update)
+          {
+            perturbed_rhs.add(-1.0 / timestep, direction);
+          }
+        solutions.apply_constraints(perturbed_rhs);
+        eigenvalue = perturbed_rhs.l2_norm();
+        direction.swap(perturbed_rhs);
+      }
+    old_state.zero_out_ghost_values();
+    old_state = base_state;
+    old_state.update_ghost_values();
+
+    if (eigenvalue == 0.0)
+      {
+        return std::numeric_limits<double>::max();
+      }
+    return stability_radius() / eigenvalue;
+  }
+
+protected:
+  /**
+   * @brief The multi-stage integrators read the old state through old_1.
+   */
+  [[nodiscard]] unsigned int
+  history_depth() const override
+  {
+    return solve_block.explicit_integrator == UserDefinedUpdate ? 0 : 1;
+  }
+
 private:
+  /**
+   * @brief Extent of the stability region of the integrator along the negative real
+   * axis.
+   */
+  [[nodiscard]] double
+  stability_radius() const
+  {
+    switch (solve_block.explicit_integrator)
+      {
+        case SSPRK3:
+          return 2.5127;
+        case LowStorageRK4:
+          return 4.6567;
+        default:
+          return 2.0;
+      }
+  }
+
+  /**
+   * @brief Set the time seen by the RHS to t_n + offset dt. The simulation timer holds
+   * the end of the step, t_n + dt, and is left untouched.
+   */
+  void
+  set_stage_time(double offset)
+  {
+    const SimulationTimer &sim_timer = solve_context->get_simulation_timer();
+    stage_timer                      = sim_timer;
+    stage_timer.set_time(sim_timer.get_time() -
+                         ((1.0 - offset) * sim_timer.get_timestep()));
+  }
+
+  /**
+   * @brief Evaluate the time derivative at the state in the solution vector and the
+   * stage time t_n + offset dt. The state is swapped into old_1 for the evaluation,
+   * which leaves u_n in the solution vector in the meantime.
+   */
+  void
+  evaluate_time_derivative(BlockVector<number> &dst, double offset)
+  {
+    set_stage_time(offset);
+    BlockVector<number> &state = solutions.get_solution_full_vector();
+    BlockVector<number> &old   = solutions.get_old_solution_full_vector(0);
+    state.update_ghost_values();
+    state.swap(old);
+    rhs_operator.compute_operator(dst);
+    state.swap(old);
+    state.zero_out_ghost_values();
+  }
+
+  /**
+   * @brief Forward Euler and SSP-RK3 in Shu-Osher form,
+   * u^(i) = a_i u_n + b_i (u^(i-1) + dt f(u^(i-1))), which only needs one stage vector
+   * because u_n is kept in old_1.
+   */
+  void
+  integrate_shu_osher()
+  {
+    static constexpr std::array<std::array<double, 2>, 1> forward_euler = {
+      {{0.0, 1.0}}
+    };
+    static constexpr std::array<std::array<double, 2>, 3> ssp_rk3 = {
+      {{0.0, 1.0}, {3.0 / 4.0, 1.0 / 4.0}, {1.0 / 3.0, 2.0 / 3.0}}
+    };
+    static constexpr std::array<double, 3> ssp_rk3_offsets = {0.0, 1.0, 0.5};
+    const bool         is_euler = solve_block.explicit_integrator == ForwardEuler;
+    const unsigned int n_stages = is_euler ? forward_euler.size() : ssp_rk3.size();
+    const double       timestep = solve_context->get_simulation_timer().get_timestep();
+    BlockVector<number>       &state      = solutions.get_solution_full_vector();
+    const BlockVector<number> &old_state  = solutions.get_old_solution_full_vector(0);
+    BlockVector<number>       &derivative = solutions.get_stage_vector(0);
+
+    state = old_state;
+    state.zero_out_ghost_values();
+    for (unsigned int stage = 0; stage < n_stages; ++stage)
+      {
+        const auto &[old_weight, stage_weight] =
+          is_euler ? forward_euler[stage] : ssp_rk3[stage];
+        evaluate_time_derivative(derivative, is_euler ? 0.0 : ssp_rk3_offsets[stage]);
+        state.sadd(stage_weight, stage_weight * timestep, derivative);
+        if (old_weight != 0.0)
+          {
+            state.add(old_weight, old_state);
+          }
+        solutions.apply_constraints();
+      }
+  }
+
+  /**
+   * @brief Five-stage, fourth-order 2N-storage Runge-Kutta method of Carpenter and
+   * Kennedy (1994), du = A_i du + dt f(u), u = u + B_i du.
+   */
+  void
+  integrate_low_storage()
+  {
+    static constexpr std::array<double, 5> coefficients_a = {
+      0.0,
+      -567301805773.0 / 1357537059087.0,
+      -2404267990393.0 / 2016746695238.0,
+      -3550918686646.0 / 2091501179385.0,
+      -1275806237668.0 / 842570457699.0};
+    static constexpr std::array<double, 5> coefficients_b = {
+      1432997174477.0 / 9575080441755.0,
+      5161836677717.0 / 13612068292357.0,
+      1720146321549.0 / 2090206949498.0,
+      3134564353537.0 / 4481467310338.0,
+      2277821191437.0 / 14882151754819.0};
+    static constexpr std::array<double, 5> stage_offsets = {
+      0.0,
+      1432997174477.0 / 9575080441755.0,
+      2526269341429.0 / 6820363962896.0,
+      2006345519317.0 / 3224310063776.0,
+      2802321613138.0 / 2924317926251.0};
+    const double timestep = solve_context->get_simulation_timer().get_timestep();
+    BlockVector<number> &state      = solutions.get_solution_full_vector();
+    BlockVector<number> &derivative = solutions.get_stage_vector(0);
+    BlockVector<number> &update     = solutions.get_stage_vector(1);
+
+    state = solutions.get_old_solution_full_vector(0);
+    state.zero_out_ghost_values();
+    update = 0.0;
+    for (unsigned int stage = 0; stage < coefficients_a.size(); ++stage)
+      {
+        evaluate_time_derivative(derivative, stage_offsets[stage]);
+        update.sadd(coefficients_a[stage], timestep, derivative);
+        state.add(coefficients_b[stage], update);
+        solutions.apply_constraints();
+      }
+  }
+
+  /**
+   * @brief Copy of the simulation timer at the time of the current stage, which the RHS
+   * operator reads.
+   */
+  SimulationTimer stage_timer;
+
   /**
    * @brief Matrix free operator.
    */
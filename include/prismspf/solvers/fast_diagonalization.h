@@ -0,0 +1,497 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/tensor_product_matrix.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+#include <prismspf/core/field_attributes.h>
+#include <prismspf/core/matrix_free_manager.h>
+#include <prismspf/core/type_enums.h>
+
+#include <prismspf/solvers/mf_operator.h>
+
+#include <prismspf/config.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Cell-wise block Jacobi preconditioner from the fast diagonalization method.
+ *
+ * On every cell, the operator is approximated by the tensor-product operator
+ *
+ *   a M + b K,
+ *
+ * where M and K are the mass and Laplace matrices of the cell. They are assembled from
+ * the 1D matrices of the Gauss-Lobatto Lagrange basis scaled with the cell extents, and
+ * inverted with dealii::TensorProductMatrixSymmetricSum at a cost of O(k^{d+1}) per cell.
+ * The coefficients a and b are the least-squares fit of the diagonal of the actual
+ * operator on the cell's DoFs to the assembled diagonals of M and K. This averages
+ * varying coefficients per cell, since the diagonal of a shared DoF collects the
+ * contributions of all adjacent cells, and picks up the mass shift of implicit time
+ * steps. The fields and components of a solve block are treated independently.
+ *
+ * The cell inverses are summed as an additive Schwarz method with the symmetric
+ * weighting W^{1/2} sum_c R_c^T A_c^{-1} R_c W^{1/2}, where W holds the inverse number of
+ * cells that share a DoF, so the preconditioner stays symmetric for use inside
+ * Chebyshev iterations.
+ *
+ * The approximation assumes Laplace-like operators on axis-aligned, affine cells, which
+ * is what the meshes of PRISMS-PF consist of.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class FastDiagonalizationPreconditioner
+{
+public:
+  using ScalarValue = dealii::VectorizedArray<number>;
+  using CellInverse =
+    dealii::TensorProductMatrixSymmetricSum<dim, ScalarValue, degree + 1>;
+  using FEEval = dealii::FEEvaluation<dim, degree, degree + 1, 1, number, ScalarValue>;
+
+  static constexpr unsigned int n_cell_dofs = dealii::Utilities::pow(degree + 1, dim);
+
+  /**
+   * @brief Standardized data struct to pipe additional data to the preconditioner.
+   */
+  struct AdditionalData
+  {
+    explicit AdditionalData(double _damping = 1.0)
+      : damping(_damping)
+    {}
+
+    /**
+     * @brief Scaling of the preconditioned vector. Values below one damp the additive
+     * Schwarz smoother.
+     */
+    double damping;
+  };
+
+  /**
+   * @brief Initialize with the operator whose diagonal is fitted.
+   * @note The cell inverses are only computed in reinit().
+   */
+  void
+  initialize(const MFOperator<dim, degree, number> &_lhs_operator,
+             const AdditionalData                  &data = AdditionalData())
+  {
+    lhs_operator = &_lhs_operator;
+    damping      = data.damping;
+
+    const SolveBlock                   &solve_block = lhs_operator->get_solve_block();
+    const std::vector<FieldAttributes> &attributes =
+      lhs_operator->get_field_attributes();
+    components.clear();
+    unsigned int block_index = 0;
+    for (const unsigned int field_index : solve_block.field_indices)
+      {
+        const unsigned int n_components =
+          attributes[field_index].field_type == TensorRank::Vector ? dim : 1;
+        for (unsigned int component = 0; component < n_components; ++component)
+          {
+            components.push_back({block_index, field_index, component});
+          }
+        ++block_index;
+      }
+
+    reference_matrices(reference_mass, reference_laplace);
+  }
+
+  /**
+   * @brief Fit the cell coefficients and compute the cell inverses.
+   * @pre The diagonal of the operator has been evaluated.
+   */
+  void
+  reinit()
+  {
+    Assert(lhs_operator != nullptr, dealii::ExcNotInitialized());
+    const MatrixFree<dim, number> &matrix_free = *lhs_operator->get_matrix_free();
+    const unsigned int             n_batches   = matrix_free.n_cell_batches();
+
+    // Diagonal of the operator and the assembled diagonals of the reference operators
+    const BlockVector<number> &inverse_diagonal =
+      lhs_operator->get_matrix_diagonal_inverse()->get_vector();
+    BlockVector<number> operator_diagonal;
+    BlockVector<number> mass_diagonal;
+    BlockVector<number> laplace_diagonal;
+    operator_diagonal.reinit(inverse_diagonal);
+    mass_diagonal.reinit(inverse_diagonal);
+    laplace_diagonal.reinit(inverse_diagonal);
+    weights.reinit(inverse_diagonal);
+    for (unsigned int block = 0; block < inverse_diagonal.n_blocks(); ++block)
+      {
+        const SolutionVector<number> &inverse_block = inverse_diagonal.block(block);
+        SolutionVector<number>       &diagonal_block = operator_diagonal.block(block);
+        for (unsigned int i = 0; i < inverse_block.locally_owned_size(); ++i)
+          {
+            const number value = inverse_block.local_element(i);
+            diagonal_block.local_element(i) = value != number(0.0) ? 1.0 / value : 0.0;
+          }
+      }
+
+    for (const ComponentEntry &entry : components)
+      {
+        FEEval phi(matrix_free, entry.field_index, 0, entry.component);
+        for (unsigned int cell = 0; cell < n_batches; ++cell)
+          {
+            phi.reinit(cell);
+            const std::array<ScalarValue, dim> extents = cell_extents(cell, entry);
+
+            for (unsigned int i = 0; i < n_cell_dofs; ++i)
+              {
+                phi.begin_dof_values()[i] = reference_diagonal(i, extents, true);
+              }
+            phi.distribute_local_to_global(mass_diagonal.block(entry.block_index));
+            for (unsigned int i = 0; i < n_cell_dofs; ++i)
+              {
+                phi.begin_dof_values()[i] = reference_diagonal(i, extents, false);
+              }
+            phi.distribute_local_to_global(laplace_diagonal.block(entry.block_index));
+            for (unsigned int i = 0; i < n_cell_dofs; ++i)
+              {
+                phi.begin_dof_values()[i] = 1.0;
+              }
+            phi.distribute_local_to_global(weights.block(entry.block_index));
+          }
+      }
+    mass_diagonal.compress(dealii::VectorOperation::add);
+    laplace_diagonal.compress(dealii::VectorOperation::add);
+    weights.compress(dealii::VectorOperation::add);
+
+    // Inverse square root of the multiplicity. Each component only writes its own DoFs,
+    // so every DoF was counted once per adjacent cell.
+    for (unsigned int block = 0; block < weights.n_blocks(); ++block)
+      {
+        SolutionVector<number> &weight_block = weights.block(block);
+        for (unsigned int i = 0; i < weight_block.locally_owned_size(); ++i)
+          {
+            const number count = weight_block.local_element(i);
+            weight_block.local_element(i) =
+              count > number(0.0) ? 1.0 / std::sqrt(count) : 1.0;
+          }
+      }
+
+    // Fit the coefficients and compute the cell inverses
+    operator_diagonal.update_ghost_values();
+    mass_diagonal.update_ghost_values();
+    laplace_diagonal.update_ghost_values();
+    cell_inverses.assign(components.size(), std::vector<CellInverse>(n_batches));
+    for (unsigned int entry_index = 0; entry_index < components.size(); ++entry_index)
+      {
+        const ComponentEntry &entry = components[entry_index];
+        FEEval phi_operator(matrix_free, entry.field_index, 0, entry.component);
+        FEEval phi_mass(matrix_free, entry.field_index, 0, entry.component);
+        FEEval phi_laplace(matrix_free, entry.field_index, 0, entry.component);
+        for (unsigned int cell = 0; cell < n_batches; ++cell)
+          {
+            phi_operator.reinit(cell);
+            phi_mass.reinit(cell);
+            phi_laplace.reinit(cell);
+            phi_operator.read_dof_values(operator_diagonal.block(entry.block_index));
+            phi_mass.read_dof_values(mass_diagonal.block(entry.block_index));
+            phi_laplace.read_dof_values(laplace_diagonal.block(entry.block_index));
+
+            ScalarValue mass_coefficient;
+            ScalarValue laplace_coefficient;
+            fit_coefficients(phi_operator.begin_dof_values(),
+                             phi_mass.begin_dof_values(),
+                             phi_laplace.begin_dof_values(),
+                             matrix_free.n_active_entries_per_cell_batch(cell),
+                             mass_coefficient,
+                             laplace_coefficient);
+
+            const std::array<ScalarValue, dim> extents = cell_extents(cell, entry);
+            std::array<dealii::Table<2, ScalarValue>, dim> mass_matrices;
+            std::array<dealii::Table<2, ScalarValue>, dim> derivative_matrices;
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                mass_matrices[d].reinit(degree + 1, degree + 1);
+                derivative_matrices[d].reinit(degree + 1, degree + 1);
+                for (unsigned int i = 0; i <= degree; ++i)
+                  {
+                    for (unsigned int j = 0; j <= degree; ++j)
+                      {
+                        const ScalarValue mass_entry =
+                          extents[d] * number(reference_mass(i, j));
+                        mass_matrices[d](i, j) = mass_entry;
+                        derivative_matrices[d](i, j) =
+                          (laplace_coefficient * number(reference_laplace(i, j)) /
+                           extents[d]) +
+                          (mass_coefficient * mass_entry / number(dim));
+                      }
+                  }
+              }
+            cell_inverses[entry_index][cell].reinit(mass_matrices, derivative_matrices);
+          }
+      }
+    operator_diagonal.zero_out_ghost_values();
+    mass_diagonal.zero_out_ghost_values();
+    laplace_diagonal.zero_out_ghost_values();
+
+    weighted_src.reinit(inverse_diagonal);
+  }
+
+  /**
+   * @brief Apply the preconditioner.
+   * @note requires dst is not ghosted
+   */
+  void
+  vmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    Assert(!cell_inverses.empty(), dealii::ExcNotInitialized());
+    const MatrixFree<dim, number> &matrix_free = *lhs_operator->get_matrix_free();
+
+    weighted_src = src;
+    weighted_src.scale(weights);
+    dst = 0.0;
+    weighted_src.update_ghost_values();
+    for (unsigned int entry_index = 0; entry_index < components.size(); ++entry_index)
+      {
+        const ComponentEntry &entry = components[entry_index];
+        FEEval                phi(matrix_free, entry.field_index, 0, entry.component);
+        std::array<ScalarValue, n_cell_dofs> cell_src {};
+        for (unsigned int cell = 0; cell < matrix_free.n_cell_batches(); ++cell)
+          {
+            phi.reinit(cell);
+            phi.read_dof_values(weighted_src.block(entry.block_index));
+            std::copy(phi.begin_dof_values(),
+                      phi.begin_dof_values() + n_cell_dofs,
+                      cell_src.begin());
+            cell_inverses[entry_index][cell].apply_inverse(
+              dealii::ArrayView<ScalarValue>(phi.begin_dof_values(), n_cell_dofs),
+              dealii::ArrayView<const ScalarValue>(cell_src.data(), n_cell_dofs));
+            phi.distribute_local_to_global(dst.block(entry.block_index));
+          }
+      }
+    dst.compress(dealii::VectorOperation::add);
+    weighted_src.zero_out_ghost_values();
+
+    dst.scale(weights);
+    if (damping != 1.0)
+      {
+        dst *= damping;
+      }
+  }
+
+private:
+  /**
+   * @brief A component of a field in the solve block.
+   */
+  struct ComponentEntry
+  {
+    unsigned int block_index;
+    unsigned int field_index;
+    unsigned int component;
+  };
+
+  /**
+   * @brief Mass and Laplace matrices of the 1D Lagrange basis on the Gauss-Lobatto
+   * points, in lexicographic order, on the unit interval.
+   */
+  static void
+  reference_matrices(dealii::FullMatrix<double> &mass,
+                     dealii::FullMatrix<double> &laplace)
+  {
+    const std::vector<dealii::Polynomials::Polynomial<double>> basis =
+      dealii::Polynomials::generate_complete_Lagrange_basis(
+        dealii::QGaussLobatto<1>(degree + 1).get_points());
+    const dealii::QGauss<1> quadrature(degree + 1);
+
+    mass.reinit(degree + 1, degree + 1);
+    laplace.reinit(degree + 1, degree + 1);
+    std::vector<double> values_i(2);
+    std::vector<double> values_j(2);
+    for (unsigned int q = 0; q < quadrature.size(); ++q)
+      {
+        const double x      = quadrature.point(q)[0];
+        const double weight = quadrature.weight(q);
+        for (unsigned int i = 0; i <= degree; ++i)
+          {
+            basis[i].value(x, values_i);
+            for (unsigned int j = 0; j <= degree; ++j)
+              {
+                basis[j].value(x, values_j);
+                mass(i, j) += values_i[0] * values_j[0] * weight;
+                laplace(i, j) += values_i[1] * values_j[1] * weight;
+              }
+          }
+      }
+  }
+
+  /**
+   * @brief Extents of the cells of a batch in each direction. Unused lanes get unit
+   * extents so that their inverses are well defined.
+   */
+  std::array<ScalarValue, dim>
+  cell_extents(unsigned int cell, const ComponentEntry &entry) const
+  {
+    const MatrixFree<dim, number> &matrix_free = *lhs_operator->get_matrix_free();
+    std::array<ScalarValue, dim>   extents;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        extents[d] = 1.0;
+      }
+    for (unsigned int lane = 0; lane < matrix_free.n_active_entries_per_cell_batch(cell);
+         ++lane)
+      {
+        const auto cell_iterator =
+          matrix_free.get_cell_iterator(cell, lane, entry.field_index);
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            extents[d][lane] = number(cell_iterator->extent_in_direction(d));
+          }
+      }
+    return extents;
+  }
+
+  /**
+   * @brief Diagonal entry of the cell mass (or Laplace) matrix for the lexicographic
+   * cell DoF index.
+   */
+  ScalarValue
+  reference_diagonal(unsigned int                        index,
+                     const std::array<ScalarValue, dim> &extents,
+                     bool                                mass) const
+  {
+    std::array<unsigned int, dim> indices {};
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        indices[d] = index % (degree + 1);
+        index /= (degree + 1);
+      }
+
+    ScalarValue mass_product = 1.0;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        mass_product *= extents[d] * number(reference_mass(indices[d], indices[d]));
+      }
+    if (mass)
+      {
+        return mass_product;
+      }
+
+    // Each term of K replaces the mass factor of one direction with the Laplace factor
+    ScalarValue laplace_sum = 0.0;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        const ScalarValue mass_factor =
+          extents[d] * number(reference_mass(indices[d], indices[d]));
+        const ScalarValue laplace_factor =
+          number(reference_laplace(indices[d], indices[d])) / extents[d];
+        laplace_sum += mass_product * laplace_factor / mass_factor;
+      }
+    return laplace_sum;
+  }
+
+  /**
+   * @brief Least-squares fit of diag(A) = a diag(M) + b diag(K) on the DoFs of a cell,
+   * with nonnegative coefficients.
+   */
+  static void
+  fit_coefficients(const ScalarValue *operator_values,
+                   const ScalarValue *mass_values,
+                   const ScalarValue *laplace_values,
+                   unsigned int       n_lanes,
+                   ScalarValue       &mass_coefficient,
+                   ScalarValue       &laplace_coefficient)
+  {
+    mass_coefficient    = 0.0;
+    laplace_coefficient = 1.0;
+    for (unsigned int lane = 0; lane < n_lanes; ++lane)
+      {
+        double mm = 0.0;
+        double mk = 0.0;
+        double kk = 0.0;
+        double ma = 0.0;
+        double ka = 0.0;
+        for (unsigned int i = 0; i < n_cell_dofs; ++i)
+          {
+            const double a_value = operator_values[i][lane];
+            const double m_value = mass_values[i][lane];
+            const double k_value = laplace_values[i][lane];
+            mm += m_value * m_value;
+            mk += m_value * k_value;
+            kk += k_value * k_value;
+            ma += m_value * a_value;
+            ka += k_value * a_value;
+          }
+
+        double       a_fit       = 0.0;
+        double       b_fit       = 0.0;
+        const double determinant = (mm * kk) - (mk * mk);
+        if (determinant > 1.0e-12 * mm * kk)
+          {
+            a_fit = ((kk * ma) - (mk * ka)) / determinant;
+            b_fit = ((mm * ka) - (mk * ma)) / determinant;
+          }
+        // Fall back to one of the two terms if the fit is degenerate or negative
+        if (a_fit < 0.0 || b_fit <= 0.0)
+          {
+            a_fit = 0.0;
+            b_fit = kk > 0.0 ? ka / kk : 0.0;
+          }
+        if (b_fit <= 0.0)
+          {
+            a_fit = mm > 0.0 ? std::max(ma / mm, 0.0) : 0.0;
+            b_fit = 0.0;
+          }
+        if (a_fit <= 0.0 && b_fit <= 0.0)
+          {
+            b_fit = 1.0;
+          }
+        mass_coefficient[lane]    = number(a_fit);
+        laplace_coefficient[lane] = number(b_fit);
+      }
+  }
+
+  /**
+   * @brief Operator whose diagonal is fitted.
+   */
+  const MFOperator<dim, degree, number> *lhs_operator = nullptr;
+
+  /**
+   * @brief Damping of the preconditioned vector.
+   */
+  double damping = 1.0;
+
+  /**
+   * @brief Fields and components of the solve block.
+   */
+  std::vector<ComponentEntry> components;
+
+  /**
+   * @brief 1D reference matrices.
+   */
+  dealii::FullMatrix<double> reference_mass;
+  dealii::FullMatrix<double> reference_laplace;
+
+  /**
+   * @brief Cell inverses, by component and cell batch.
+   */
+  std::vector<std::vector<CellInverse>> cell_inverses;
+
+  /**
+   * @brief Inverse square root of the number of cells sharing each DoF.
+   */
+  BlockVector<number> weights;
+
+  /**
+   * @brief Weighted input vector.
+   */
+  mutable BlockVector<number> weighted_src;
+};
+
+PRISMS_PF_END_NAMESPACE
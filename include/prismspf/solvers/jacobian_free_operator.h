@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+
+#include <prismspf/core/group_solution_handler.h>
+#include <prismspf/core/matrix_free_manager.h>
+#include <prismspf/core/timer.h>
+#include <prismspf/core/types.h>
+
+#include <prismspf/solvers/mf_operator.h>
+
+#include <prismspf/config.h>
+
+#include <cmath>
+#include <limits>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Jacobian-vector products by finite differences of the residual.
+ *
+ * The Newton solver solves lhs(du) = r(u), where the user's compute_lhs is the negative
+ * directional derivative of compute_rhs. This operator approximates it without
+ * compute_lhs as
+ *
+ *   J v = -(r(u + eps v) - r(u)) / eps,
+ *
+ * where r is evaluated through the same rhs MFOperator that computes the Newton
+ * residual. The perturbed state is written into the solution vectors of the solve block,
+ * constrained, and restored afterwards, so the residual sees exactly what it would see
+ * for an ordinary Newton iterate.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class JacobianFreeOperator
+{
+public:
+  /**
+   * @brief Constructor.
+   */
+  JacobianFreeOperator() = default;
+
+  /**
+   * @brief Initialize.
+   *
+   * @param perturbation Relative size of the finite difference step. Zero picks the
+   * square root of the machine epsilon.
+   */
+  void
+  init(const MFOperator<dim, degree, number> &_rhs_operator,
+       GroupSolutionHandler<dim, number>     &_solutions,
+       double                                 _perturbation)
+  {
+    rhs_operator = &_rhs_operator;
+    solutions    = &_solutions;
+    perturbation = _perturbation > 0.0
+                     ? _perturbation
+                     : std::sqrt(std::numeric_limits<number>::epsilon());
+  }
+
+  /**
+   * @brief Set the state u and residual r(u) to linearize around. The residual is
+   * referenced, not copied, and must outlive the linear solve.
+   */
+  void
+  set_linearization_point(const BlockVector<number> &residual)
+  {
+    Assert(solutions != nullptr, dealii::ExcNotInitialized());
+    base_residual = &residual;
+    base_solution.reinit(solutions->get_solution_full_vector(), true);
+    base_solution = solutions->get_solution_full_vector();
+    base_solution.zero_out_ghost_values();
+    base_solution_norm = base_solution.l2_norm();
+  }
+
+  /**
+   * @brief Matrix-vector multiplication.
+   * @note requires dst is not ghosted
+   */
+  void
+  vmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    Assert(base_residual != nullptr, dealii::ExcNotInitialized());
+
+    const double src_norm = src.l2_norm();
+    if (src_norm == 0.0)
+      {
+        dst = 0.0;
+        return;
+      }
+    const double epsilon = perturbation * (1.0 + base_solution_norm) / src_norm;
+
+    Timer::start_section("Jacobian-free vmult");
+    BlockVector<number> &solution = solutions->get_solution_full_vector();
+
+    // Perturb the state and evaluate the residual
+    solution.zero_out_ghost_values();
+    solution = base_solution;
+    solution.add(epsilon, src);
+    solutions->apply_constraints();
+    solution.update_ghost_values();
+    rhs_operator->compute_operator(dst);
+
+    // Restore the state
+    solution.zero_out_ghost_values();
+    solution = base_solution;
+    solution.update_ghost_values();
+
+    dst -= *base_residual;
+    dst *= -1.0 / epsilon;
+    Timer::end_section("Jacobian-free vmult");
+  }
+
+  // NOLINTBEGIN(readability-identifier-naming)
+
+  /**
+   * @brief Transpose matrix-vector multiplication. Only valid for symmetric Jacobians.
+   */
+  void
+  Tvmult(BlockVector<number> &dst, const BlockVector<number> &src) const
+  {
+    vmult(dst, src);
+  }
+
+  // NOLINTEND(readability-identifier-naming)
+
+private:
+  /**
+   * @brief Operator that computes the residual.
+   */
+  const MFOperator<dim, degree, number> *rhs_operator = nullptr;
+
+  /**
+   * @brief Solution vectors that are perturbed.
+   */
+  GroupSolutionHandler<dim, number> *solutions = nullptr;
+
+  /**
+   * @brief Residual at the linearization point.
+   */
+  const BlockVector<number> *base_residual = nullptr;
+
+  /**
+   * @brief State at the linearization point.
+   */
+  BlockVector<number> base_solution;
+
+  /**
+   * @brief l2 norm of the state at the linearization point.
+   */
+  double base_solution_norm = 0.0;
+
+  /**
+   * @brief Relative finite difference step.
+   */
+  double perturbation = 0.0;
+};
+
+PRISMS_PF_END_NAMESPACE
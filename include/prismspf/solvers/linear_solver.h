@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <deal.II/base/timer.h>
 #include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/solver_control.h>
 #include <deal.II/lac/solver_selector.h>
 
@@ -15,19 +18,30 @@
 #include <prismspf/core/type_enums.h>
 #include <prismspf/core/types.h>
 
+#include <prismspf/solvers/block_preconditioner.h>
+#include <prismspf/solvers/communication_avoiding_cg.h>
+#include <prismspf/solvers/deflated_cg.h>
+#include <prismspf/solvers/fast_diagonalization.h>
 #include <prismspf/solvers/mf_operator.h>
+#include <prismspf/solvers/mg_coarse_direct.h>
+#include <prismspf/solvers/mg_p_coarsening.h>
 #include <prismspf/solvers/solver_base.h>
 
 #include <prismspf/user_inputs/solve_parameters.h>
 
 #include <prismspf/config.h>
 
+#include <algorithm>
+#include <deque>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 //
 #include <deal.II/lac/precondition_block.h>
 #include <deal.II/multigrid/mg_coarse.h>
-#include <deal.II/multigrid/mg_constrained_dofs.h>
 #include <deal.II/multigrid/mg_matrix.h>
 #include <deal.II/multigrid/mg_smoother.h>
 #include <deal.II/multigrid/mg_tools.h>
@@ -55,34 +69,81 @@ public:
   using Smoother        = dealii::MGSmootherPrecondition<MFOperator<dim, degree, number>,
                                                          SmootherPrecond,
                                                          BlockVector<number>>;
+  using FDMPreconditioner = FastDiagonalizationPreconditioner<dim, degree, number>;
+  using FDMChebyshev =
+    dealii::PreconditionChebyshev<MFOperator<dim, degree, number>,
+                                  BlockVector<number>,
+                                  FDMPreconditioner>;
+  using FDMChebyshevSmoother =
+    dealii::MGSmootherPrecondition<MFOperator<dim, degree, number>,
+                                   FDMChebyshev,
+                                   BlockVector<number>>;
+  using SchwarzSmoother = dealii::MGSmootherPrecondition<MFOperator<dim, degree, number>,
+                                                         FDMPreconditioner,
+                                                         BlockVector<number>>;
+  using MGTwoLevelTransfer = dealii::MGTwoLevelTransfer<dim, SolutionVector<number>>;
+  using MGFieldTransfer = dealii::MGTransferGlobalCoarsening<dim, SolutionVector<number>>;
   using MGTransferType =
-    dealii::MGTransferBlockGlobalCoarsening<dim, BlockVector<number>>;
+    dealii::MGTransferBlockGlobalCoarsening<dim, SolutionVector<number>>;
   // dc = default constructible, ndc = not default constructible
-  dealii::MGLevelObject<MFOperator<dim, degree, number>> mg_lhs_operators; // dc
-  std::vector<dealii::MGConstrainedDoFs>                 mg_constraints;   // dc
-  MGTransferType                                         mg_transfer;      // ndc
-  Smoother                                               mg_smoother;      // dc
-  dealii::MGCoarseGridApplySmoother<BlockVector<number>> mg_coarse_solver; // dc
-  dealii::mg::Matrix<BlockVector<number>>                mg_matrix;        // dc
-  dealii::Multigrid<BlockVector<number>>                 multigrid;        // ndc
-  dealii::PreconditionMG<dim, BlockVector<number>, MGTransferType>
-    multigrid_preconditioner; // ndc
+  dealii::MGLevelObject<MFOperator<dim, degree, number>> mg_lhs_operators;       // dc
+  std::vector<dealii::MGLevelObject<MGTwoLevelTransfer>> mg_two_level_transfers; // dc
+  std::vector<std::unique_ptr<MGFieldTransfer>>          mg_field_transfers;     // ndc
+  std::unique_ptr<MGTransferType>                        mg_transfer;            // ndc
+  Smoother                                               mg_smoother;            // dc
+  // Fast diagonalization smoothers
+  dealii::MGLevelObject<std::shared_ptr<FDMPreconditioner>> mg_fdm_preconditioners; // dc
+  FDMChebyshevSmoother                                      mg_fdm_smoother;        // dc
+  SchwarzSmoother                                           mg_schwarz_smoother;    // dc
+  MGSmootherType smoother_type = SmootherJacobiChebyshev;                         // dc
+  dealii::MGCoarseGridApplySmoother<BlockVector<number>> mg_coarse_solver;       // dc
+  // Chebyshev-preconditioned CG coarse grid solver
+  dealii::ReductionControl                  coarse_solver_control; // dc
+  dealii::SolverCG<BlockVector<number>>     coarse_cg;             // ndc
+  PreconditionChebyshev                     coarse_chebyshev;      // dc
+  dealii::MGCoarseGridIterativeSolver<BlockVector<number>,
+                                      dealii::SolverCG<BlockVector<number>>,
+                                      MFOperator<dim, degree, number>,
+                                      PreconditionChebyshev>
+    mg_coarse_cg; // dc
+  // Direct coarse grid solver
+  MGCoarseGridDirect<dim, degree, number>                 mg_coarse_direct; // dc
+  MGCoarseSolverType coarse_solver_type = CoarseSmoother;                   // dc
+  dealii::mg::Matrix<BlockVector<number>>                 mg_matrix;        // dc
+  std::unique_ptr<dealii::Multigrid<BlockVector<number>>> multigrid;        // ndc
+  // p-multigrid levels. Only the finest level uses mg_lhs_operators and the levels below
+  // it have linear elements.
+  using POperator = MFOperator<dim, 1, number>;
+  using PChebyshev =
+    dealii::PreconditionChebyshev<POperator,
+                                  BlockVector<number>,
+                                  dealii::DiagonalMatrix<BlockVector<number>>>;
+  using PSmoother =
+    dealii::MGSmootherPrecondition<POperator, PChebyshev, BlockVector<number>>;
+  bool                                       p_coarsening = false; // dc
+  dealii::MGLevelObject<POperator>           mg_p_lhs_operators;   // dc
+  PSmoother                                  mg_p_smoother;        // dc
+  MGPCoarseningSmoother<BlockVector<number>> mg_p_split_smoother;  // dc
+  PChebyshev                                 coarse_p_chebyshev;   // dc
+  dealii::MGCoarseGridIterativeSolver<BlockVector<number>,
+                                      dealii::SolverCG<BlockVector<number>>,
+                                      POperator,
+                                      PChebyshev>
+    mg_p_coarse_cg; // dc
+  MGCoarseGridDirect<dim, 1, number>       mg_p_coarse_direct; // dc
+  dealii::mg::Matrix<BlockVector<number>>  mg_p_matrix;        // dc
+  MGPCoarseningMatrix<BlockVector<number>> mg_p_split_matrix;  // dc
 
   MGContext()
-    : mg_transfer(mg_constraints)
-    , multigrid(mg_matrix,
-                mg_coarse_solver,
-                mg_transfer,
-                mg_smoother,
-                mg_smoother,
-                0,
-                0,
-                dealii::Multigrid<BlockVector<number>>::Cycle::v_cycle)
-    , multigrid_preconditioner(std::vector<const dealii::DoFHandler<dim> *>(),
-                               multigrid,
-                               mg_transfer)
+    : coarse_cg(coarse_solver_control)
   {}
 
+  /**
+   * @brief Build the hierarchy. Level max_level is the active mesh and lower levels are
+   * the DoFHandlers on the coarsened triangulations, so relative level max_level - level.
+   * With p-multigrid, the levels below max_level have linear elements and are evaluated
+   * by the coarse PDE operator of the solve context.
+   */
   void
   init(unsigned int                             min_level,
        unsigned int                             max_level,
@@ -91,124 +152,356 @@ public:
        const SolveContext<dim, degree, number> &solve_context,
        const GroupSolutionHandler<dim, number> &solutions)
   {
+    p_coarsening =
+      solve_context.get_dof_manager().has_p_coarsening() && min_level < max_level;
+    AssertThrow(!p_coarsening || lin_params.mg_smoother == SmootherJacobiChebyshev,
+                dealii::ExcMessage("p-multigrid only supports the Jacobi-Chebyshev "
+                                   "smoother"));
+    // First level with the element degree
+    const unsigned int min_fine_level = p_coarsening ? max_level : min_level;
+
     // 1. Level operators
     mg_lhs_operators =
-      dealii::MGLevelObject<MFOperator<dim, degree, number>>(min_level, max_level);
-    for (unsigned level = min_level; level <= max_level; ++level)
-      {
-        const unsigned int relative_level = max_level - level;
-        mg_lhs_operators[level].init(solve_context.get_pde_operator(),
-                                     &PDEOperatorBase<dim, degree, number>::compute_lhs,
-                                     solve_context.get_field_attributes(),
-                                     solve_context.get_solution_indexer(),
-                                     solve_context.get_matrix_free_manager(),
-                                     solve_context.get_simulation_timer(),
-                                     solve_block,
-                                     solve_block.dependencies_lhs);
-        mg_lhs_operators[level].set_scaling_diagonal(
-          lin_params.tolerance_type != AbsoluteResidual,
-          solve_context.get_invm_manager().get_invm_sqrt(
-            solve_context.get_field_attributes(),
-            solve_block.field_indices,
-            relative_level));
-        mg_lhs_operators[level].set_relative_level(relative_level);
-      }
-
-    // 2. MG Constraints (homogeneous)
-    mg_constraints = make_mg_constraints(solve_block, solve_context, solutions);
-
-    // 3. MG Transfer
-    mg_transfer.initialize_constraints(mg_constraints);
-    mg_transfer.build(
-      solve_context.get_dof_manager().get_block_dof_handlers(solve_block.field_indices));
-
-    // 4. MG Smoother
-    dealii::MGLevelObject<typename SmootherPrecond::AdditionalData> smoother_data(
-      min_level,
-      max_level);
+      dealii::MGLevelObject<MFOperator<dim, degree, number>>(min_fine_level, max_level);
+    for (unsigned level = min_fine_level; level <= max_level; ++level)
+      {
+        init_level_operator(mg_lhs_operators[level],
+                            solve_context.get_pde_operator(),
+                            max_level - level,
+                            solve_block,
+                            lin_params,
+                            solve_context);
+      }
+    if (p_coarsening)
+      {
+        mg_p_lhs_operators = dealii::MGLevelObject<POperator>(min_level, max_level - 1);
+        for (unsigned level = min_level; level < max_level; ++level)
+          {
+            init_level_operator(mg_p_lhs_operators[level],
+                                solve_context.get_coarse_pde_operator(),
+                                max_level - level,
+                                solve_block,
+                                lin_params,
+                                solve_context);
+          }
+      }
+
+    // 2. Two-level transfers between the coarsened meshes. The homogeneous level
+    // constraints from the ConstraintManager carry the hanging nodes and Dirichlet
+    // boundaries of each level. The p-multigrid transfer is between the two DoFHandlers
+    // on the active mesh.
+    make_mg_transfer(min_level, max_level, solve_block, solve_context, solutions);
+
+    // 3. MG Smoother
     const auto &chebyshev_params = lin_params.chebyshev_parameters;
-    for (unsigned int level = min_level; level <= max_level; ++level)
+    const auto  smoother_data    =
+      make_smoother_data<SmootherPrecond>(mg_lhs_operators, chebyshev_params);
+    mg_smoother.initialize(mg_lhs_operators, smoother_data);
+    const dealii::MGSmootherBase<BlockVector<number>> *smoother = &mg_smoother;
+
+    dealii::MGLevelObject<typename PChebyshev::AdditionalData> p_smoother_data;
+    if (p_coarsening)
       {
-        unsigned int relative_level              = level - min_level;
-        smoother_data[level].smoothing_range     = chebyshev_params.smoothing_range;
-        smoother_data[level].degree              = chebyshev_params.degree;
-        smoother_data[level].eig_cg_n_iterations = chebyshev_params.eig_cg_n_iterations;
-        smoother_data[level].constraints.close(); // todo
+        p_smoother_data =
+          make_smoother_data<PChebyshev>(mg_p_lhs_operators, chebyshev_params);
+        mg_p_smoother.initialize(mg_p_lhs_operators, p_smoother_data);
+        mg_p_split_smoother.initialize(mg_smoother, mg_p_smoother, max_level - 1);
+        smoother = &mg_p_split_smoother;
+      }
 
-        mg_lhs_operators[level].reinit_matrix_diagonal();
-        smoother_data[level].preconditioner =
-          mg_lhs_operators[level].get_matrix_diagonal_inverse();
+    // The cell inverses of the fast diagonalization smoothers are computed in
+    // reinit_smoothers(), once the level diagonals are evaluated
+    smoother_type = lin_params.mg_smoother;
+    if (smoother_type == SmootherFDMChebyshev)
+      {
+        dealii::MGLevelObject<typename FDMChebyshev::AdditionalData> fdm_data(min_level,
+                                                                              max_level);
+        mg_fdm_preconditioners.resize(min_level, max_level);
+        for (unsigned int level = min_level; level <= max_level; ++level)
+          {
+            mg_fdm_preconditioners[level] = std::make_shared<FDMPreconditioner>();
+            mg_fdm_preconditioners[level]->initialize(mg_lhs_operators[level]);
+
+            fdm_data[level].smoothing_range     = chebyshev_params.smoothing_range;
+            fdm_data[level].degree              = chebyshev_params.degree;
+            fdm_data[level].eig_cg_n_iterations = chebyshev_params.eig_cg_n_iterations;
+            fdm_data[level].preconditioner      = mg_fdm_preconditioners[level];
+          }
+        mg_fdm_smoother.initialize(mg_lhs_operators, fdm_data);
+        smoother = &mg_fdm_smoother;
+      }
+    else if (smoother_type == SmootherFDMSchwarz)
+      {
+        mg_schwarz_smoother.initialize(
+          mg_lhs_operators,
+          typename FDMPreconditioner::AdditionalData(lin_params.schwarz_damping));
+        mg_schwarz_smoother.set_steps(lin_params.schwarz_steps);
+        smoother = &mg_schwarz_smoother;
       }
-    mg_smoother.initialize(mg_lhs_operators, smoother_data);
 
-    // 5. Coarse grid solver
-    mg_coarse_solver.initialize(mg_smoother);
+    // 4. Coarse grid solver. The direct solver is factorized in reinit_coarse_solver().
+    coarse_solver_type = lin_params.mg_coarse_solver;
+    const dealii::MGCoarseGridBase<BlockVector<number>> *coarse_solver =
+      &mg_coarse_solver;
+    if (lin_params.mg_coarse_solver == CoarseChebyshevCG)
+      {
+        coarse_solver_control.set_max_steps(lin_params.mg_coarse_max_iterations);
+        coarse_solver_control.set_tolerance(1.0e-14);
+        coarse_solver_control.set_reduction(lin_params.mg_coarse_tolerance);
+        if (p_coarsening)
+          {
+            coarse_p_chebyshev.initialize(mg_p_lhs_operators[min_level],
+                                          p_smoother_data[min_level]);
+            mg_p_coarse_cg.initialize(coarse_cg,
+                                      mg_p_lhs_operators[min_level],
+                                      coarse_p_chebyshev);
+            coarse_solver = &mg_p_coarse_cg;
+          }
+        else
+          {
+            coarse_chebyshev.initialize(mg_lhs_operators[min_level],
+                                        smoother_data[min_level]);
+            mg_coarse_cg.initialize(coarse_cg,
+                                    mg_lhs_operators[min_level],
+                                    coarse_chebyshev);
+            coarse_solver = &mg_coarse_cg;
+          }
+      }
+    else if (lin_params.mg_coarse_solver == CoarseDirect)
+      {
+        BlockVector<number> coarse_vector;
+        solve_context.get_matrix_free_manager().initialize_mg_block_vector(
+          coarse_vector,
+          solve_block.field_indices,
+          max_level - min_level);
+        if (p_coarsening)
+          {
+            mg_p_coarse_direct.initialize(mg_p_lhs_operators[min_level], coarse_vector);
+            coarse_solver = &mg_p_coarse_direct;
+          }
+        else
+          {
+            mg_coarse_direct.initialize(mg_lhs_operators[min_level], coarse_vector);
+            coarse_solver = &mg_coarse_direct;
+          }
+      }
+    else
+      {
+        mg_coarse_solver.initialize(*smoother);
+      }
 
-    // 6. Multigrid object
+    // 5. Multigrid object
     mg_matrix = dealii::mg::Matrix<BlockVector<number>>(mg_lhs_operators);
-    multigrid = dealii::Multigrid<BlockVector<number>>(
-      mg_matrix,
-      mg_coarse_solver,
-      mg_transfer,
-      mg_smoother,
-      mg_smoother,
+    const dealii::MGMatrixBase<BlockVector<number>> *matrix = &mg_matrix;
+    if (p_coarsening)
+      {
+        mg_p_matrix = dealii::mg::Matrix<BlockVector<number>>(mg_p_lhs_operators);
+        mg_p_split_matrix.initialize(mg_matrix, mg_p_matrix);
+        matrix = &mg_p_split_matrix;
+      }
+    multigrid = std::make_unique<dealii::Multigrid<BlockVector<number>>>(
+      *matrix,
+      *coarse_solver,
+      *mg_transfer,
+      *smoother,
+      *smoother,
       min_level,
       max_level,
       dealii::Multigrid<BlockVector<number>>::Cycle::v_cycle);
+  }
 
-    // multigrid_preconditioner =
-    //   dealii::PreconditionMG<dim, BlockVector<number>, MGTransferType>(
-    //     solve_context.get_dof_manager()
-    //       .get_block_dof_handlers(solve_block.field_indices),
-    //     multigrid,
-    //     mg_transfer);
+  /**
+   * @brief Apply a function to the operator of every level, e.g., to update the mass
+   * terms. The function is called with the operator and the level.
+   */
+  template <typename Function>
+  void
+  for_each_level_operator(const Function &function)
+  {
+    for (unsigned int level = mg_lhs_operators.min_level();
+         level <= mg_lhs_operators.max_level();
+         ++level)
+      {
+        function(mg_lhs_operators[level], level);
+      }
+    if (p_coarsening)
+      {
+        for (unsigned int level = mg_p_lhs_operators.min_level();
+             level <= mg_p_lhs_operators.max_level();
+             ++level)
+          {
+            function(mg_p_lhs_operators[level], level);
+          }
+      }
   }
 
   /**
-   * @brief Multigrid constraints.
+   * @brief Recompute the cell inverses of the fast diagonalization smoothers.
+   * @pre The diagonals of the level operators have been evaluated.
    */
-  static std::vector<dealii::MGConstrainedDoFs>
-  make_mg_constraints(const SolveBlock                        &solve_block,
-                      const SolveContext<dim, degree, number> &solve_context,
-                      const GroupSolutionHandler<dim, number> &solutions)
+  void
+  reinit_smoothers()
   {
-    std::vector<dealii::MGConstrainedDoFs> mg_constraints(
-      solve_block.field_indices.size());
-    for (unsigned int block_index = 0; block_index < solve_block.field_indices.size();
-         block_index++)
+    for (unsigned int level = mg_lhs_operators.min_level();
+         level <= mg_lhs_operators.max_level();
+         ++level)
       {
-        unsigned int field_index = solutions.get_block_to_global_index()[block_index];
-        mg_constraints[block_index].initialize(
-          solve_context.get_dof_manager().get_field_dof_handler(field_index));
+        if (smoother_type == SmootherFDMChebyshev)
+          {
+            mg_fdm_preconditioners[level]->reinit();
+          }
+        else if (smoother_type == SmootherFDMSchwarz)
+          {
+            mg_schwarz_smoother.smoothers[level].reinit();
+          }
       }
-    const std::vector<FieldAttributes> &field_attributes =
-      solve_context.get_field_attributes();
-    for (unsigned int block_index = 0; block_index < solve_block.field_indices.size();
-         block_index++)
-      {
-        unsigned int field_index     = solutions.get_block_to_global_index()[block_index];
-        const FieldAttributes &field = field_attributes[field_index];
-        unsigned int num_comps       = (field.field_type == TensorRank::Vector) ? dim : 1;
-        for (const auto &[comp, comp_bcs] :
-             field.boundary_conditions.component_constraints)
+  }
+
+  /**
+   * @brief Refactorize the direct coarse grid solver, e.g., after the level operators
+   * changed with the linearization point or the timestep.
+   */
+  void
+  reinit_coarse_solver()
+  {
+    if (coarse_solver_type == CoarseDirect && p_coarsening)
+      {
+        mg_p_coarse_direct.reinit();
+      }
+    else if (coarse_solver_type == CoarseDirect)
+      {
+        mg_coarse_direct.reinit();
+      }
+  }
+
+  /**
+   * @brief Release everything that refers to the multigrid levels, e.g., before they are
+   * rebuilt after grid refinement.
+   */
+  void
+  clear()
+  {
+    multigrid.reset();
+    mg_transfer.reset();
+    mg_field_transfers.clear();
+    mg_two_level_transfers.clear();
+  }
+
+  /**
+   * @brief Build the per-field transfers and combine them into the block transfer.
+   */
+  void
+  make_mg_transfer(unsigned int                             min_level,
+                   unsigned int                             max_level,
+                   const SolveBlock                        &solve_block,
+                   const SolveContext<dim, degree, number> &solve_context,
+                   const GroupSolutionHandler<dim, number> &solutions)
+  {
+    const DoFManager<dim, degree> &dof_manager = solve_context.get_dof_manager();
+    const ConstraintManager<dim, degree, number> &constraint_manager =
+      solve_context.get_constraint_manager();
+    const MatrixFreeManager<dim, number> &matrix_free_manager =
+      solve_context.get_matrix_free_manager();
+
+    // The transfers reference the two-level objects, so the latter are built in place.
+    clear();
+    const unsigned int num_blocks = solve_block.field_indices.size();
+    mg_two_level_transfers.resize(num_blocks);
+    std::vector<const MGFieldTransfer *> field_transfer_pointers;
+    for (unsigned int block_index = 0; block_index < num_blocks; block_index++)
+      {
+        const unsigned int field_index =
+          solutions.get_block_to_global_index()[block_index];
+
+        auto &two_level_transfer = mg_two_level_transfers[block_index];
+        two_level_transfer.resize(min_level, max_level);
+        for (unsigned int level = min_level + 1; level <= max_level; ++level)
           {
-            std::set<unsigned int> constrained_boundary_ids;
-            for (const auto &[boundary_id, boundary_type] : comp_bcs)
-              {
-                if (boundary_type == Condition::Dirichlet)
-                  {
-                    constrained_boundary_ids.insert(boundary_id);
-                  }
-              }
-            mg_constraints[block_index].make_zero_boundary_constraints(
-              solve_context.get_dof_manager().get_field_dof_handler(field_index),
-              constrained_boundary_ids,
-              num_comps == 1
-                ? ConstraintManager<dim, degree, number>::scalar_empty_mask
-                : ConstraintManager<dim, degree, number>::vector_component_mask.at(comp));
+            const unsigned int relative_level = max_level - level;
+            two_level_transfer[level].reinit(
+              dof_manager.get_mg_field_dof_handler(field_index, relative_level),
+              dof_manager.get_mg_field_dof_handler(field_index, relative_level + 1),
+              constraint_manager.get_mg_field_constraint(field_index, relative_level),
+              constraint_manager.get_mg_field_constraint(field_index,
+                                                         relative_level + 1));
           }
+
+        // Level vectors share the partitioners of the level MatrixFree objects
+        mg_field_transfers.push_back(std::make_unique<MGFieldTransfer>(
+          two_level_transfer,
+          [&matrix_free_manager, field_index, max_level](const unsigned int      level,
+                                                         SolutionVector<number> &vector)
+          {
+            vector.reinit(matrix_free_manager.get_mg_shared_matrix_free(max_level - level)
+                            .get_vector_partitioner(field_index));
+          }));
+        field_transfer_pointers.push_back(mg_field_transfers.back().get());
       }
-    return mg_constraints;
+    mg_transfer = std::make_unique<MGTransferType>(field_transfer_pointers);
+  }
+
+private:
+  /**
+   * @brief Initialize the operator of a level with the PDE operator of its element
+   * degree.
+   */
+  template <unsigned int level_degree>
+  static void
+  init_level_operator(MFOperator<dim, level_degree, number>            &level_operator,
+                      const PDEOperatorBase<dim, level_degree, number> &pde_operator,
+                      unsigned int                                      relative_level,
+                      const SolveBlock                                 &solve_block,
+                      const LinearSolverParameters                     &lin_params,
+                      const SolveContext<dim, degree, number>          &solve_context)
+  {
+    const auto lhs_function =
+      solve_block.automatic_jacobian
+        ? &PDEOperatorBase<dim, level_degree, number>::compute_rhs
+        : &PDEOperatorBase<dim, level_degree, number>::compute_lhs;
+    level_operator.init(pde_operator,
+                        lhs_function,
+                        solve_context.get_field_attributes(),
+                        solve_context.get_solution_indexer(),
+                        solve_context.get_matrix_free_manager(),
+                        solve_context.get_simulation_timer(),
+                        solve_block,
+                        solve_block.dependencies_lhs);
+    level_operator.set_scaling_diagonal(
+      lin_params.tolerance_type != AbsoluteResidual,
+      solve_context.get_invm_manager().get_invm_sqrt(solve_context.get_field_attributes(),
+                                                     solve_block.field_indices,
+                                                     relative_level));
+    level_operator.set_relative_level(relative_level);
+    level_operator.linearize = solve_block.automatic_jacobian;
+  }
+
+  /**
+   * @brief Chebyshev smoother settings of the given level operators. The preconditioner
+   * is the inverse of the level diagonal.
+   */
+  template <typename ChebyshevType, typename OperatorType>
+  static dealii::MGLevelObject<typename ChebyshevType::AdditionalData>
+  make_smoother_data(
+    dealii::MGLevelObject<OperatorType>                   &lhs_operators,
+    const dealii::PreconditionChebyshev<>::AdditionalData &chebyshev_params)
+  {
+    dealii::MGLevelObject<typename ChebyshevType::AdditionalData> smoother_data(
+      lhs_operators.min_level(),
+      lhs_operators.max_level());
+    for (unsigned int level = lhs_operators.min_level();
+         level <= lhs_operators.max_level();
+         ++level)
+      {
+        smoother_data[level].smoothing_range     = chebyshev_params.smoothing_range;
+        smoother_data[level].degree              = chebyshev_params.degree;
+        smoother_data[level].eig_cg_n_iterations = chebyshev_params.eig_cg_n_iterations;
+        smoother_data[level].constraints.close(); // todo
+
+        lhs_operators[level].reinit_matrix_diagonal();
+        smoother_data[level].preconditioner =
+          lhs_operators[level].get_matrix_diagonal_inverse();
+      }
+    return smoother_data;
   }
 };
 
@@ -260,9 +553,12 @@ public:
                                       solve_context->get_invm_manager().get_invm_sqrt(
                                         solve_context->get_field_attributes(),
                                         solve_block.field_indices));
-    // Initialize lhs_operator
+    // Initialize lhs_operator. With an automatic Jacobian, it is the linearization of the
+    // RHS.
     lhs_operator.init(solve_context->get_pde_operator(),
-                      &PDEOperatorBase<dim, degree, number>::compute_lhs,
+                      solve_block.automatic_jacobian
+                        ? &PDEOperatorBase<dim, degree, number>::compute_rhs
+                        : &PDEOperatorBase<dim, degree, number>::compute_lhs,
                       solve_context->get_field_attributes(),
                       solve_context->get_solution_indexer(),
                       solve_context->get_matrix_free_manager(),
@@ -273,6 +569,7 @@ public:
                                       solve_context->get_invm_manager().get_invm_sqrt(
                                         solve_context->get_field_attributes(),
                                         solve_block.field_indices));
+    lhs_operator.linearize = solve_block.automatic_jacobian;
 
     linear_solver_control.set_max_steps(lin_params().max_iterations);
     linear_solver_control.set_tolerance(lin_params().tolerance * normalization_value());
@@ -298,6 +595,37 @@ public:
     initialize_preconditioner();
   }
 
+  /**
+   * @brief Prepare for solution transfer (for AMR). The multigrid hierarchy refers to the
+   * coarsened triangulations of the old mesh, so it is released here and rebuilt in
+   * reinit(). The recycled Krylov vectors are dropped and harvested again on the new
+   * mesh, and so is the assembled operator. The history of old solution times is reset,
+   * so the extrapolation starts over from the transferred solutions.
+   */
+  void
+  prepare_for_solution_transfer() override
+  {
+    SolverBase<dim, degree, number>::prepare_for_solution_transfer();
+    multigrid_preconditioner = nullptr;
+    block_preconditioner.clear();
+    mg_context.clear();
+    deflation_space.clear();
+    lhs_operator.clear_matrix();
+    use_assembled_operator.reset();
+    history_times.clear();
+  }
+
+  /**
+   * @brief Roll back to the snapshot of the solutions. The times of the old solutions
+   * are recorded again from the next update on.
+   */
+  void
+  roll_back() override
+  {
+    SolverBase<dim, degree, number>::roll_back();
+    history_times.clear();
+  }
+
   /**
    * @brief Solve for a single update step.
    */
@@ -310,22 +638,40 @@ public:
     Timer::end_section("Zero ghosts");
 
     // Set up rhs vector
+    update_time_terms();
     rhs_operator.compute_operator(rhs_vector);
 
     // Set inhomogeneous Dirichlet values. TODO: only update if time-dependent
     solutions.apply_constraints(inhomogeneous_values);
 
-    // Note 1. Use the previous result of the linear solve without nonzero dirichlet
-    // as the initial guess in the next increment. See Note 2. `inhomogeneous_rhs` is
-    // not actually what it is being used as here, we just don't want to allocate a
-    // whole new vector for this purpose
-    solutions.get_solution_full_vector().swap(inhomogeneous_rhs);
+    // Note 1. Without a solution history, use the previous result of the linear solve
+    // without nonzero dirichlet as the initial guess in the next increment. See Note 2.
+    // `inhomogeneous_rhs` is not actually what it is being used as here, we just don't
+    // want to allocate a whole new vector for this purpose
+    if (history_depth() == 0)
+      {
+        solutions.get_solution_full_vector().swap(inhomogeneous_rhs);
+      }
     // Get the homogeneous rhs
     lhs_operator.read_plain = true;
     lhs_operator.compute_operator(inhomogeneous_rhs, inhomogeneous_values);
     lhs_operator.read_plain = false;
     rhs_vector -= inhomogeneous_rhs;
 
+    // Otherwise, build the initial guess from the old solutions
+    if (history_depth() > 0)
+      {
+        Timer::start_section("Initial guess");
+        compute_history_guess(solutions.get_solution_full_vector(), rhs_vector);
+        Timer::end_section("Initial guess");
+      }
+
+    // Tune the solver settings on the first representative system
+    if (autotune_due())
+      {
+        autotune(rhs_vector, lhs_operator, solutions.get_solution_full_vector());
+      }
+
     // Linear solve
     do_linear_solve(rhs_vector, lhs_operator, solutions.get_solution_full_vector());
 
@@ -333,7 +679,10 @@ public:
     // increment. See Note 1. `inhomogeneous_rhs` is not actually what it is being
     // used as here, we just don't want to allocate a whole new vector for this
     // purpose
-    inhomogeneous_rhs = solutions.get_solution_full_vector();
+    if (history_depth() == 0)
+      {
+        inhomogeneous_rhs = solutions.get_solution_full_vector();
+      }
     // Add back in nonzero dirichlet conditions
     solutions.get_solution_full_vector() += inhomogeneous_values;
 
@@ -346,8 +695,41 @@ public:
     Timer::end_section("Update ghosts");
   }
 
+  /**
+   * @brief Update the fields and record the time of the newest old solution.
+   */
+  void
+  update() override
+  {
+    SolverBase<dim, degree, number>::update();
+    if (history_depth() > 0)
+      {
+        history_times.push_front(solve_context->get_simulation_timer().get_time());
+        while (history_times.size() > history_depth())
+          {
+            history_times.pop_back();
+          }
+      }
+  }
+
+  int
+  do_linear_solve(BlockVector<number>             &b_vector,
+                  MFOperator<dim, degree, number> &lhs_matrix,
+                  BlockVector<number>             &x_vector)
+  {
+    update_operator_backend(lhs_matrix);
+    return do_linear_solve(b_vector, lhs_matrix, lhs_matrix, x_vector);
+  }
+
+  /**
+   * @brief Solve system_matrix x = b. The preconditioners are always built from
+   * lhs_matrix, so the system matrix can be any operator with a vmult that approximates
+   * it, e.g., a Jacobian-free operator.
+   */
+  template <typename SystemMatrixType>
   int
   do_linear_solve(BlockVector<number>             &b_vector,
+                  const SystemMatrixType          &system_matrix,
                   MFOperator<dim, degree, number> &lhs_matrix,
                   BlockVector<number>             &x_vector)
   {
@@ -356,29 +738,45 @@ public:
       {
         if (lin_params().preconditioner == None)
           {
-            lin_solver.solve(lhs_matrix,
-                             x_vector,
-                             b_vector,
-                             dealii::PreconditionIdentity());
+            krylov_solve(system_matrix,
+                         x_vector,
+                         b_vector,
+                         dealii::PreconditionIdentity());
           }
         else if (lin_params().preconditioner == Chebyshev)
           {
-            lhs_matrix.reinit_matrix_diagonal();
-            lhs_matrix.eval_matrix_diagonal();
+            if (preconditioner_needs_rebuild())
+              {
+                lhs_matrix.reinit_matrix_diagonal();
+                lhs_matrix.eval_matrix_diagonal();
+              }
+
+            krylov_solve(system_matrix, x_vector, b_vector, precond_chebyshev);
+          }
+        else if (lin_params().preconditioner == Block)
+          {
+            if (preconditioner_needs_rebuild())
+              {
+                if (lin_params().block_inner_solve == BlockInnerGMG)
+                  {
+                    eval_mg_level_diagonals();
+                  }
+                lhs_matrix.reinit_matrix_diagonal();
+                lhs_matrix.eval_matrix_diagonal();
+                block_preconditioner.reinit(lhs_matrix);
+              }
 
-            lin_solver.solve(lhs_matrix, x_vector, b_vector, precond_chebyshev);
+            krylov_solve(system_matrix, x_vector, b_vector, block_preconditioner);
           }
         else if (lin_params().preconditioner == GMG)
           {
-            // TODO: recalculate diagonals
-            auto &lhs_ops = mg_context.mg_lhs_operators;
-            for (unsigned int level = lhs_ops.min_level(); level <= lhs_ops.max_level();
-                 ++level)
+            if (preconditioner_needs_rebuild())
               {
-                lhs_ops[level].reinit_matrix_diagonal(); // todo
-                lhs_ops[level].eval_matrix_diagonal();
+                eval_mg_level_diagonals();
+                mg_context.reinit_smoothers();
+                mg_context.reinit_coarse_solver();
               }
-            lin_solver.solve(lhs_operator, x_vector, b_vector, *multigrid_preconditioner);
+            krylov_solve(system_matrix, x_vector, b_vector, *multigrid_preconditioner);
           }
       }
     catch (dealii::SolverControl::NoConvergence &exc)
@@ -402,6 +800,482 @@ public:
   }
 
 protected:
+  /**
+   * @brief Number of old solutions needed for the initial guess.
+   */
+  [[nodiscard]] unsigned int
+  history_depth() const override
+  {
+    const unsigned int bdf_depth = bdf_order();
+    if (lin_params().extrapolation_order == 0 && lin_params().projection_size == 0)
+      {
+        return bdf_depth;
+      }
+    return std::max({lin_params().extrapolation_order + 1,
+                     lin_params().projection_size,
+                     bdf_depth});
+  }
+
+  /**
+   * @brief Order of the BDF integrator, which is also the number of old solutions it
+   * needs. Zero for a user-defined residual.
+   */
+  [[nodiscard]] unsigned int
+  bdf_order() const
+  {
+    switch (solve_block.implicit_integrator)
+      {
+        case BDF1:
+          return 1;
+        case BDF2:
+          return 2;
+        case BDF3:
+          return 3;
+        default:
+          return 0;
+      }
+  }
+
+  /**
+   * @brief Norm of the residual b - A x of the current solution, in the units of the
+   * linear solver tolerance.
+   */
+  [[nodiscard]] double
+  current_residual_norm() override
+  {
+    update_time_terms();
+    rhs_operator.compute_operator(rhs_vector);
+
+    BlockVector<number> lhs_vector;
+    lhs_vector.reinit(rhs_vector, true);
+    lhs_operator.read_plain = true;
+    lhs_operator.compute_operator(lhs_vector, solutions.get_solution_full_vector());
+    lhs_operator.read_plain = false;
+    rhs_vector -= lhs_vector;
+    return rhs_vector.l2_norm() / normalization_value();
+  }
+
+  /**
+   * @brief Set the lumped mass time derivative of the BDF integrator on the operators,
+   * with the coefficients of the current step history. The order is reduced while
+   * there is not enough history, e.g., in the first increments. Without any history,
+   * the steady problem is solved.
+   */
+  void
+  update_time_terms()
+  {
+    if (solve_block.implicit_integrator == UserDefinedResidual)
+      {
+        return;
+      }
+    const SimulationTimer &sim_timer = solve_context->get_simulation_timer();
+    const unsigned int     order =
+      std::min({bdf_order(),
+                sim_timer.get_n_previous_timesteps(),
+                static_cast<unsigned int>(
+                  solutions.get_primary_solutions().old_solutions.size())});
+    const std::vector<double> coefficients =
+      order > 0 ? sim_timer.get_bdf_coefficients(order) : std::vector<double> {0.0};
+
+    // The RHS is g(u) - M du/dt. For newton blocks, the current solution contributes
+    // to the residual; for linear blocks, it is the unknown and moves to the LHS.
+    std::vector<std::pair<double, const BlockVector<number> *>> history;
+    if (solve_block.solve_type == Newton)
+      {
+        history.emplace_back(-coefficients[0], &solutions.get_solution_full_vector());
+      }
+    for (unsigned int j = 1; j <= order; ++j)
+      {
+        history.emplace_back(-coefficients[j],
+                             &solutions.get_old_solution_full_vector(j - 1));
+      }
+    const InvMManager<dim, degree, number> &invm_manager =
+      solve_context->get_invm_manager();
+    const std::vector<FieldAttributes> &field_attributes =
+      solve_context->get_field_attributes();
+    rhs_operator.set_mass_terms(
+      invm_manager.get_jxw(field_attributes, solve_block.field_indices),
+      0.0,
+      history);
+    lhs_operator.set_mass_terms(
+      invm_manager.get_jxw(field_attributes, solve_block.field_indices),
+      coefficients[0]);
+    lhs_time_shift = coefficients[0];
+
+    if (mg_context.multigrid != nullptr)
+      {
+        const unsigned int max_level = mg_context.mg_lhs_operators.max_level();
+        mg_context.for_each_level_operator(
+          [&](auto &lhs_op, unsigned int level)
+          {
+            lhs_op.set_mass_terms(invm_manager.get_jxw(field_attributes,
+                                                       solve_block.field_indices,
+                                                       max_level - level),
+                                  coefficients[0]);
+          });
+      }
+  }
+
+  /**
+   * @brief Extrapolate the old solutions in time to the current time with a Lagrange
+   * polynomial of the given order. The order is reduced while there is not enough
+   * history, e.g., in the first increments. Subcycled solve blocks only use the newest
+   * old solution, because old_1 holds the previous substep while the times count
+   * increments. Returns false if there is no history.
+   */
+  bool
+  extrapolate_solution(BlockVector<number> &dst, unsigned int order) const
+  {
+    const unsigned int n_old = solutions.get_primary_solutions().old_solutions.size();
+    const unsigned int n_history =
+      solve_block.n_substeps > 1
+        ? std::min(n_old, 1U)
+        : std::min<unsigned int>(history_times.size(), n_old);
+    if (n_history == 0)
+      {
+        return false;
+      }
+    order = std::min(order, n_history - 1);
+
+    // Lagrange weights for the nodes t_1, ..., t_{order+1}, which can be unevenly spaced
+    const double time = solve_context->get_simulation_timer().get_time();
+    dst               = 0.0;
+    for (unsigned int k = 0; k <= order; ++k)
+      {
+        double weight = 1.0;
+        for (unsigned int j = 0; j <= order; ++j)
+          {
+            if (j != k)
+              {
+                weight *=
+                  (time - history_times[j]) / (history_times[k] - history_times[j]);
+              }
+          }
+        dst.add(weight, solutions.get_old_solution_full_vector(k));
+      }
+    return true;
+  }
+
+  /**
+   * @brief Compute the initial guess of the homogeneous linear solve from the old
+   * solutions.
+   *
+   * The old solutions are first extrapolated in time. If a projection size is set, the
+   * guess is instead the combination of the most recent old solutions that minimizes the
+   * residual of the linear system, which costs one operator application per old
+   * solution.
+   */
+  void
+  compute_history_guess(BlockVector<number> &x_vector, const BlockVector<number> &b_vector)
+  {
+    if (!extrapolate_solution(x_vector, lin_params().extrapolation_order))
+      {
+        x_vector = 0.0;
+        return;
+      }
+    x_vector -= inhomogeneous_values;
+
+    const unsigned int n_basis =
+      std::min<unsigned int>(lin_params().projection_size, history_times.size());
+    if (n_basis > 0)
+      {
+        project_initial_guess(x_vector, b_vector, n_basis);
+      }
+  }
+
+  /**
+   * @brief Minimize the residual of the linear system over the span of the homogeneous
+   * part of the n_basis most recent old solutions.
+   *
+   * The operator applied to each basis vector is orthonormalized with modified
+   * Gram-Schmidt. Nearly dependent vectors are dropped, which happens in the first
+   * increments when the old solutions are still identical copies of the initial
+   * condition.
+   */
+  void
+  project_initial_guess(BlockVector<number>       &x_vector,
+                        const BlockVector<number> &b_vector,
+                        unsigned int               n_basis)
+  {
+    const double drop_tolerance = 1.0e-10;
+
+    projection_basis.resize(n_basis);
+    projection_images.resize(n_basis);
+    dealii::FullMatrix<double> r_matrix(n_basis, n_basis);
+    std::vector<bool>          kept(n_basis, false);
+    std::vector<double>        coefficients(n_basis, 0.0);
+
+    for (unsigned int k = 0; k < n_basis; ++k)
+      {
+        projection_basis[k].reinit(x_vector, true);
+        projection_basis[k] = solutions.get_old_solution_full_vector(k);
+        projection_basis[k].zero_out_ghost_values();
+        projection_basis[k] -= inhomogeneous_values;
+
+        projection_images[k].reinit(x_vector, true);
+        lhs_operator.vmult(projection_images[k], projection_basis[k]);
+
+        const double original_norm = projection_images[k].l2_norm();
+        for (unsigned int j = 0; j < k; ++j)
+          {
+            if (kept[j])
+              {
+                r_matrix(j, k) = projection_images[j] * projection_images[k];
+                projection_images[k].add(-r_matrix(j, k), projection_images[j]);
+              }
+          }
+        r_matrix(k, k) = projection_images[k].l2_norm();
+        kept[k]        = r_matrix(k, k) > drop_tolerance * original_norm;
+        if (kept[k])
+          {
+            projection_images[k] /= r_matrix(k, k);
+            coefficients[k] = projection_images[k] * b_vector;
+          }
+      }
+
+    // Back substitution with the upper triangular factor
+    bool any_kept = false;
+    for (unsigned int k = n_basis; k-- > 0;)
+      {
+        if (!kept[k])
+          {
+            coefficients[k] = 0.0;
+            continue;
+          }
+        any_kept = true;
+        for (unsigned int l = k + 1; l < n_basis; ++l)
+          {
+            if (kept[l])
+              {
+                coefficients[k] -= r_matrix(k, l) * coefficients[l];
+              }
+          }
+        coefficients[k] /= r_matrix(k, k);
+      }
+    if (!any_kept)
+      {
+        return;
+      }
+
+    x_vector = 0.0;
+    for (unsigned int k = 0; k < n_basis; ++k)
+      {
+        if (kept[k])
+          {
+            x_vector.add(coefficients[k], projection_basis[k]);
+          }
+      }
+  }
+
+  /**
+   * @brief Candidate settings of the autotune sweep. Only the solver type and the
+   * preconditioner settings are varied; the tolerance stays the same.
+   */
+  [[nodiscard]] std::vector<LinearSolverParameters>
+  autotune_candidates() const
+  {
+    const LinearSolverParameters &original     = lin_params();
+    std::vector<std::string>      solver_types = original.autotune_solver_types;
+    if (solver_types.empty())
+      {
+        solver_types.push_back(original.solver_type);
+      }
+    const unsigned int num_levels = solve_context->get_dof_manager().num_levels();
+
+    std::vector<LinearSolverParameters> candidates;
+    for (const std::string &solver_type : solver_types)
+      {
+        LinearSolverParameters candidate = original;
+        candidate.solver_type            = solver_type;
+
+        candidate.preconditioner = None;
+        candidates.push_back(candidate);
+
+        candidate.preconditioner = Chebyshev;
+        for (const unsigned int chebyshev_degree : {2U, 4U, 6U})
+          {
+            for (const double smoothing_range : {10.0, 20.0})
+              {
+                candidate.chebyshev_parameters.degree          = chebyshev_degree;
+                candidate.chebyshev_parameters.smoothing_range = smoothing_range;
+                candidates.push_back(candidate);
+              }
+          }
+
+        // The multigrid hierarchy only exists if GMG was requested
+        if (original.preconditioner == GMG)
+          {
+            candidate.preconditioner = GMG;
+            for (unsigned int depth = std::max(num_levels, 4U) - 3; depth <= num_levels;
+                 ++depth)
+              {
+                for (const unsigned int chebyshev_degree : {2U, 4U})
+                  {
+                    candidate.mg_depth                    = depth;
+                    candidate.chebyshev_parameters.degree = chebyshev_degree;
+                    candidates.push_back(candidate);
+                  }
+              }
+          }
+      }
+    return candidates;
+  }
+
+  /**
+   * @brief Short description of the settings of a candidate for the summary log.
+   */
+  [[nodiscard]] static std::string
+  describe_candidate(const LinearSolverParameters &candidate)
+  {
+    std::string description = candidate.solver_type;
+    if (candidate.preconditioner == None)
+      {
+        description += ", no preconditioner";
+      }
+    else if (candidate.preconditioner == GMG)
+      {
+        description += ", GMG with mg depth " + std::to_string(candidate.mg_depth) +
+                       " and smoother degree " +
+                       std::to_string(candidate.chebyshev_parameters.degree);
+      }
+    else
+      {
+        description += ", Chebyshev with degree " +
+                       std::to_string(candidate.chebyshev_parameters.degree) +
+                       " and smoothing range " +
+                       std::to_string(candidate.chebyshev_parameters.smoothing_range);
+      }
+    return description;
+  }
+
+  /**
+   * @brief Whether the autotune sweep is requested and has to run on the next linear
+   * solve.
+   */
+  [[nodiscard]] bool
+  autotune_due() const
+  {
+    return lin_params().autotune && !autotuned &&
+           solve_context->get_simulation_timer().get_increment() >=
+             lin_params().autotune_increment;
+  }
+
+  /**
+   * @brief Run the autotune sweep on the system lhs x = b, with the operator backend of
+   * the LHS.
+   */
+  void
+  autotune(const BlockVector<number>       &b_vector,
+           MFOperator<dim, degree, number> &lhs_matrix,
+           const BlockVector<number>       &x_vector)
+  {
+    update_operator_backend(lhs_matrix);
+    autotune(b_vector, lhs_matrix, lhs_matrix, x_vector);
+  }
+
+  /**
+   * @brief Time every candidate setting on the system x = b, starting from the current
+   * initial guess, and keep the fastest one that converges. The candidates are timed
+   * including the preconditioner setup that is repeated for every solve, but not the
+   * one-time setup. As in do_linear_solve(), the preconditioners are built from
+   * lhs_matrix, and the system matrix can be any operator that approximates it.
+   */
+  template <typename SystemMatrixType>
+  void
+  autotune(const BlockVector<number>       &b_vector,
+           const SystemMatrixType          &system_matrix,
+           MFOperator<dim, degree, number> &lhs_matrix,
+           const BlockVector<number>       &x_vector)
+  {
+    Timer::start_section("Autotune");
+    const LinearSolverParameters original = lin_params();
+
+    BlockVector<number> b_trial;
+    BlockVector<number> x_trial;
+    b_trial.reinit(b_vector, true);
+    x_trial.reinit(x_vector, true);
+
+    ConditionalOStreams::pout_summary()
+      << "Autotune of the linear solver of solve block " << solve_block.id << "\n";
+    double                                best_time = std::numeric_limits<double>::max();
+    std::optional<LinearSolverParameters> best;
+    for (const LinearSolverParameters &candidate : autotune_candidates())
+      {
+        solve_block.linear_solver_parameters = candidate;
+        initialize_solver();
+        initialize_preconditioner();
+        deflation_space.clear();
+
+        b_trial = b_vector;
+        x_trial = x_vector;
+        dealii::Timer timer(MPI_COMM_WORLD, true);
+        do_linear_solve(b_trial, system_matrix, lhs_matrix, x_trial);
+        timer.stop();
+
+        const bool converged =
+          linear_solver_control.last_check() == dealii::SolverControl::success;
+        ConditionalOStreams::pout_summary()
+          << "  " << describe_candidate(candidate) << ": "
+          << (converged ? std::to_string(timer.wall_time()) + " s, " +
+                            std::to_string(linear_solver_control.last_step()) +
+                            " steps"
+                        : std::string("not converged"))
+          << "\n";
+        if (converged && timer.wall_time() < best_time)
+          {
+            best_time = timer.wall_time();
+            best      = candidate;
+          }
+      }
+
+    solve_block.linear_solver_parameters = best.value_or(original);
+    ConditionalOStreams::pout_summary()
+      << "  Selected: " << describe_candidate(lin_params()) << "\n"
+      << std::flush;
+    initialize_solver();
+    initialize_preconditioner();
+    deflation_space.clear();
+    autotuned = true;
+    Timer::end_section("Autotune");
+  }
+
+  /**
+   * @brief Set the absolute tolerance of the linear solver, in the units of the
+   * normalized residual.
+   */
+  void
+  set_linear_tolerance(double tolerance)
+  {
+    linear_solver_control.set_tolerance(tolerance);
+  }
+
+  /**
+   * @brief Reset the linear solver tolerance to the one from the parameters.
+   */
+  void
+  reset_linear_tolerance()
+  {
+    linear_solver_control.set_tolerance(lin_params().tolerance * normalization_value());
+  }
+
+  /**
+   * @brief Solver control of the most recent linear solve.
+   */
+  [[nodiscard]] const dealii::SolverControl &
+  get_linear_solver_control() const
+  {
+    return linear_solver_control;
+  }
+
+  /**
+   * @brief Linear solver parameters
+   */
+  const LinearSolverParameters &
+  lin_params() const
+  {
+    return solve_block.linear_solver_parameters;
+  }
+
   /**
    * @brief Matrix free operators
    */
@@ -426,9 +1300,49 @@ protected:
     return value;
   }
 
+  /**
+   * @brief Run the selected Krylov method. The pipelined, s-step, and deflated CG methods
+   * are not part of dealii::SolverSelector, so they are constructed here.
+   */
+  template <typename SystemMatrixType, typename PreconditionerType>
+  void
+  krylov_solve(const SystemMatrixType    &system_matrix,
+               BlockVector<number>       &x_vector,
+               const BlockVector<number> &b_vector,
+               const PreconditionerType  &preconditioner)
+  {
+    if (lin_params().solver_type == "pipelined_cg")
+      {
+        SolverPipelinedCG<BlockVector<number>> solver(linear_solver_control);
+        solver.solve(system_matrix, x_vector, b_vector, preconditioner);
+      }
+    else if (lin_params().solver_type == "s_step_cg")
+      {
+        const typename SolverSStepCG<BlockVector<number>>::AdditionalData data(
+          lin_params().s_step_size);
+        SolverSStepCG<BlockVector<number>> solver(linear_solver_control, data);
+        solver.solve(system_matrix, x_vector, b_vector, preconditioner);
+      }
+    else if (lin_params().solver_type == "deflated_cg")
+      {
+        const typename SolverDeflatedCG<BlockVector<number>>::AdditionalData data(
+          lin_params().deflation_space_size,
+          lin_params().deflation_harvest_size);
+        SolverDeflatedCG<BlockVector<number>> solver(linear_solver_control,
+                                                     deflation_space,
+                                                     data);
+        solver.solve(system_matrix, x_vector, b_vector, preconditioner);
+      }
+    else
+      {
+        lin_solver.solve(system_matrix, x_vector, b_vector, preconditioner);
+      }
+  }
+
   void
   initialize_preconditioner()
   {
+    preconditioner_state.reset();
     if (lin_params().preconditioner == None)
       {
         void(0); // do nothing
@@ -441,6 +1355,22 @@ protected:
       {
         initialize_multigrid();
       }
+    if (lin_params().preconditioner == Block)
+      {
+        block_preconditioner.init(solve_block.field_indices.size(), lin_params());
+        if (lin_params().block_inner_solve == BlockInnerGMG)
+          {
+            AssertThrow(!solve_context->get_dof_manager().has_p_coarsening(),
+                        dealii::ExcMessage("The multigrid inner solves of the block "
+                                           "preconditioner do not support p-multigrid"));
+            initialize_mg_context();
+            block_preconditioner.set_multigrid(
+              mg_context.mg_lhs_operators,
+              *mg_context.mg_transfer,
+              solve_context->get_dof_manager().get_block_dof_handlers(
+                solve_block.field_indices));
+          }
+      }
   }
 
   void
@@ -485,19 +1415,35 @@ protected:
     lin_solver.set_data(local_gmres_parameters);
     lin_solver.set_data(local_fgmres_parameters);
 
-    lin_solver.select(lin_params().solver_type);
+    if (lin_params().solver_type != "pipelined_cg" &&
+        lin_params().solver_type != "s_step_cg" &&
+        lin_params().solver_type != "deflated_cg")
+      {
+        lin_solver.select(lin_params().solver_type);
+      }
     lin_solver.set_control(linear_solver_control);
   }
 
 private:
   /**
-   * @brief Linear solver parameters
+   * @brief Whether the autotune sweep has run.
    */
-  const LinearSolverParameters &
-  lin_params() const
-  {
-    return solve_block.linear_solver_parameters;
-  }
+  bool autotuned = false;
+
+  /**
+   * @brief Times of the old solutions, most recent first.
+   */
+  std::deque<double> history_times;
+
+  /**
+   * @brief Homogeneous parts of the old solutions used in the initial guess projection.
+   */
+  std::vector<BlockVector<number>> projection_basis;
+
+  /**
+   * @brief Orthonormalized operator applied to the projection basis.
+   */
+  std::vector<BlockVector<number>> projection_images;
 
   /**
    * @brief Solver control. Contains max iterations and tolerance.
@@ -523,6 +1469,38 @@ private:
   PreconditionChebyshev                 precond_chebyshev;
   PreconditionChebyshev::AdditionalData precond_data;
 
+  /**
+   * @brief Approximate eigenvectors recycled by the deflated CG solver
+   */
+  DeflationSpace<BlockVector<number>> deflation_space;
+
+  /**
+   * @brief Whether the LHS operator is applied as an assembled matrix. Unset until the
+   * operator backend has been chosen on the current mesh.
+   */
+  std::optional<bool> use_assembled_operator;
+
+  /**
+   * @brief Mass shift c_0 of the BDF integrator on the LHS operator.
+   */
+  double lhs_time_shift = 0.0;
+
+  /**
+   * @brief Timestep and mass shift the preconditioner was built for. Unset if the
+   * preconditioner has to be rebuilt before the next solve.
+   */
+  std::optional<std::pair<double, double>> preconditioner_state;
+
+  /**
+   * @brief Timestep and mass shift the assembled LHS matrix was built for.
+   */
+  std::optional<std::pair<double, double>> assembled_state;
+
+  /**
+   * @brief Block preconditioner for solve blocks with several coupled fields
+   */
+  BlockPreconditioner<dim, degree, number> block_preconditioner;
+
   MGContext<dim, degree, number> mg_context;
 
   using PreconditionMG =
@@ -534,19 +1512,192 @@ private:
    */
   std::shared_ptr<PreconditionMG> multigrid_preconditioner = nullptr;
 
+  /**
+   * @brief Whether the LHS operator only depends on the src values of the solved fields,
+   * so that it only changes with the timestep, the BDF mass shift, and the mesh.
+   *
+   * An LHS with an explicit time dependence, e.g., a time-dependent coefficient, cannot
+   * be detected here. Its assembled matrix and preconditioner are only rebuilt if the
+   * solve block also declares an LHS dependency on the values of a field.
+   */
+  [[nodiscard]] bool
+  lhs_is_constant() const
+  {
+    for (const auto &[field_index, dependency] : solve_block.dependencies_lhs)
+      {
+        if (dependency.flag != dealii::EvaluationFlags::nothing)
+          {
+            return false;
+          }
+        for (const auto &old_flag : dependency.old_flags)
+          {
+            if (old_flag != dealii::EvaluationFlags::nothing)
+              {
+                return false;
+              }
+          }
+      }
+    return true;
+  }
+
+  /**
+   * @brief Whether the diagonals, smoothers, and inner solves of the preconditioner have
+   * to be rebuilt before the next solve.
+   *
+   * A constant LHS operator, e.g., the linearly stabilized splitting of a fourth-order
+   * equation, only changes with the timestep and the BDF mass shift, so its
+   * preconditioner is built once and reused until either of them or the mesh changes.
+   */
+  [[nodiscard]] bool
+  preconditioner_needs_rebuild()
+  {
+    const std::pair<double, double> state = lhs_state();
+    if (!lhs_is_constant())
+      {
+        preconditioner_state.reset();
+        return true;
+      }
+    if (preconditioner_state == state)
+      {
+        return false;
+      }
+    preconditioner_state = state;
+    return true;
+  }
+
+  /**
+   * @brief Timestep and BDF mass shift of the next solve, which determine a constant LHS
+   * operator on a given mesh.
+   */
+  [[nodiscard]] std::pair<double, double>
+  lhs_state() const
+  {
+    return {solve_context->get_simulation_timer().get_timestep(), lhs_time_shift};
+  }
+
+  /**
+   * @brief Assemble the LHS operator if the operator backend asks for it and decide
+   * whether it is applied as a sparse matrix. A constant LHS operator is reassembled
+   * when the timestep or the mass shift changes, like its preconditioner.
+   */
+  void
+  update_operator_backend(MFOperator<dim, degree, number> &lhs_matrix)
+  {
+    if (lin_params().operator_backend == BackendMatrixFree ||
+        !use_assembled_operator.value_or(true))
+      {
+        return;
+      }
+
+    const std::pair<double, double> state = lhs_state();
+    if (!lhs_matrix.is_matrix_assembled() || !lhs_is_constant() ||
+        assembled_state != state)
+      {
+        Timer::start_section("Assemble operator");
+        lhs_matrix.assemble_matrix(
+          solve_context->get_constraint_manager().get_field_constraints());
+        Timer::end_section("Assemble operator");
+        assembled_state = state;
+      }
+
+    if (!use_assembled_operator.has_value())
+      {
+        use_assembled_operator = lin_params().operator_backend == BackendAssembled ||
+                                 assembled_operator_is_faster(lhs_matrix);
+        if (!*use_assembled_operator)
+          {
+            lhs_matrix.clear_matrix();
+            return;
+          }
+      }
+    lhs_matrix.set_use_assembled_matrix(true);
+  }
+
+  /**
+   * @brief Time the matrix-free and the assembled application of the LHS operator and
+   * report whether the latter is faster.
+   */
+  bool
+  assembled_operator_is_faster(MFOperator<dim, degree, number> &lhs_matrix)
+  {
+    const unsigned int n_trials = 10;
+
+    BlockVector<number> src;
+    BlockVector<number> dst;
+    src.reinit(solutions.get_solution_full_vector());
+    dst.reinit(src, true);
+    src = 1.0;
+
+    const auto time_vmults = [&](bool assembled)
+    {
+      lhs_matrix.set_use_assembled_matrix(assembled);
+      lhs_matrix.vmult(dst, src);
+      dealii::Timer timer(MPI_COMM_WORLD, true);
+      for (unsigned int trial = 0; trial < n_trials; ++trial)
+        {
+          lhs_matrix.vmult(dst, src);
+        }
+      timer.stop();
+      return timer.wall_time() / n_trials;
+    };
+    const double matrix_free_time = time_vmults(false);
+    const double assembled_time   = time_vmults(true);
+
+    ConditionalOStreams::pout_summary()
+      << "Operator backend of solve block " << solve_block.id
+      << ": matrix-free vmult " << matrix_free_time << " s, assembled vmult "
+      << assembled_time << " s\n"
+      << std::flush;
+    return assembled_time < matrix_free_time;
+  }
+
   void
   initialize_multigrid()
   {
-    const unsigned int global_refinement =
-      solve_context->get_user_inputs().spatial_discretization.global_refinement;
-    const unsigned int min_level = global_refinement - (lin_params().mg_depth) + 1;
-    const unsigned int max_level = global_refinement;
-    mg_context
-      .init(min_level, max_level, solve_block, lin_params(), *solve_context, solutions);
+    multigrid_preconditioner = nullptr;
+    initialize_mg_context();
     multigrid_preconditioner = std::make_shared<PreconditionMG>(
       solve_context->get_dof_manager().get_block_dof_handlers(solve_block.field_indices),
-      mg_context.multigrid,
-      mg_context.mg_transfer);
+      *mg_context.multigrid,
+      *mg_context.mg_transfer);
+  }
+
+  /**
+   * @brief Build the multigrid hierarchy, which the GMG preconditioner and the multigrid
+   * inner solves of the block preconditioner share.
+   */
+  void
+  initialize_mg_context()
+  {
+    // The hierarchy is the coarsening sequence of the current mesh, which is rebuilt
+    // after every refinement, so it also covers locally refined meshes.
+    const unsigned int num_levels = solve_context->get_dof_manager().num_levels();
+    AssertThrow(lin_params().mg_depth <= num_levels,
+                dealii::ExcMessage("The mg depth (" +
+                                   std::to_string(lin_params().mg_depth) +
+                                   ") is larger than the number of levels in the "
+                                   "coarsening sequence (" +
+                                   std::to_string(num_levels) + ")"));
+    const unsigned int max_level = num_levels - 1;
+    const unsigned int min_level = num_levels - lin_params().mg_depth;
+    // The multigrid inner solves of the block preconditioner refer to the old transfer
+    block_preconditioner.clear();
+    mg_context
+      .init(min_level, max_level, solve_block, lin_params(), *solve_context, solutions);
+  }
+
+  /**
+   * @brief Evaluate the diagonals of the level operators.
+   */
+  void
+  eval_mg_level_diagonals()
+  {
+    mg_context.for_each_level_operator(
+      [](auto &lhs_op, [[maybe_unused]] unsigned int level)
+      {
+        lhs_op.reinit_matrix_diagonal(); // todo
+        lhs_op.eval_matrix_diagonal();
+      });
   }
 };
 
@@ -4,6 +4,10 @@
 #pragma once
 
 #include <deal.II/base/vectorization.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/operators.h>
 
@@ -24,6 +28,7 @@
 #include <prismspf/config.h>
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #if DEAL_II_VERSION_MAJOR >= 9 && DEAL_II_VERSION_MINOR >= 7
@@ -197,6 +202,44 @@ private:
                                BlockVector<number>                 &diagonal,
                                unsigned int                         field_index) const;
 
+  /**
+   * @brief Add the lumped mass terms to dst.
+   */
+  void
+  add_mass_terms(BlockVector<number> &dst, const BlockVector<number> &src) const;
+
+  /**
+   * @brief Matrix-vector multiplication with the assembled matrix.
+   */
+  void
+  assembled_vmult(BlockVector<number> &dst, const BlockVector<number> &src) const;
+
+  /**
+   * @brief Local indices and weights of the cell DoFs of all solved fields with the
+   * constraints resolved. The cell DoFs are ordered by field, component, and node, like
+   * in FEEvaluation.
+   */
+  void
+  resolve_cell_dofs(
+    unsigned int                                                  cell,
+    unsigned int                                                  lane,
+    const std::vector<const dealii::AffineConstraints<number> *> &constraints,
+    std::vector<std::vector<std::pair<unsigned int, number>>>    &resolved) const;
+
+  template <TensorRank Rank>
+  void
+  submit_unit_dof_value(FieldContainer<dim, degree, number> &variable_list,
+                        unsigned int                         field_index,
+                        unsigned int                         node,
+                        unsigned int                         component) const;
+
+  template <TensorRank Rank>
+  ScalarValue
+  get_dof_value_component(FieldContainer<dim, degree, number> &variable_list,
+                          unsigned int                         field_index,
+                          unsigned int                         node,
+                          unsigned int                         component) const;
+
 public:
   /**
    * @brief Set scaling diagonal
@@ -209,6 +252,23 @@ public:
     scale_by_diagonal = scale;
   }
 
+  /**
+   * @brief Add lumped mass terms to the result of the operator,
+   * M (src_weight src + sum_k weight_k v_k), e.g., the time derivative of a BDF
+   * integrator. The constrained rows stay zero. The vectors v_k are referenced, not
+   * copied.
+   */
+  void
+  set_mass_terms(
+    const std::vector<const SolutionVector<number> *>          &_lumped_mass,
+    double                                                      _src_weight,
+    std::vector<std::pair<double, const BlockVector<number> *>> _vector_terms = {})
+  {
+    lumped_mass  = _lumped_mass;
+    src_weight   = _src_weight;
+    vector_terms = std::move(_vector_terms);
+  }
+
   /**
    * @brief Return the number of DoFs.
    */
@@ -216,13 +276,55 @@ public:
   m() const;
 
   /**
-   * @brief Return the value of the matrix entry. This function is only valid when row ==
-   * col and when the diagonal is initialized. Additionally, this is only used so that we
-   * may compile. Trying to use this function will throw an error.
+   * @brief Return the value of the matrix entry. The indices are global indices of the
+   * solved fields, numbered block by block. This function is only valid once the matrix
+   * has been assembled and returns the contribution of the locally owned cells, which is
+   * the full entry in serial.
    */
   number
   el(const unsigned int &row, const unsigned int &col) const;
 
+  /**
+   * @brief Assemble the operator into a sparse matrix.
+   *
+   * The matrix acts on the locally relevant (owned and ghost) DoFs of the solved fields
+   * and only holds the contributions of the locally owned cells, so that it is applied
+   * like the matrix-free cell loop: import the ghost values of src, multiply, and add the
+   * ghost entries of dst to their owners. This needs no distributed sparse matrix
+   * library. The cell matrices are computed by applying the user-defined operator to
+   * unit vectors, one cell DoF at a time, so this is only economical for low degrees.
+   *
+   * The homogeneous part of the constraints is eliminated. Constrained rows are left
+   * empty, which matches the matrix-free operator. The sparsity pattern is kept until
+   * clear_matrix() is called, e.g., when the mesh changes.
+   *
+   * @param constraints The constraints of all fields, indexed by field index.
+   */
+  void
+  assemble_matrix(
+    const std::vector<const dealii::AffineConstraints<number> *> &constraints);
+
+  /**
+   * @brief Release the assembled matrix and its sparsity pattern, and go back to the
+   * matrix-free application.
+   */
+  void
+  clear_matrix();
+
+  /**
+   * @brief Whether the operator has been assembled.
+   */
+  [[nodiscard]] bool
+  is_matrix_assembled() const;
+
+  /**
+   * @brief Whether vmult() uses the assembled matrix rather than the matrix-free cell
+   * loop. Reads of plain src values always use the cell loop.
+   * @pre The matrix has been assembled.
+   */
+  void
+  set_use_assembled_matrix(bool use);
+
   /**
    * @brief Release all memory and return to state like having called the default
    * constructor.
@@ -237,6 +339,24 @@ public:
   const MatrixFree<dim, number> *
   get_matrix_free() const;
 
+  /**
+   * @brief Get the solve block of this operator.
+   */
+  [[nodiscard]] const SolveBlock &
+  get_solve_block() const
+  {
+    return solve_block;
+  }
+
+  /**
+   * @brief Get the attributes of all fields.
+   */
+  [[nodiscard]] const std::vector<FieldAttributes> &
+  get_field_attributes() const
+  {
+    return field_attributes;
+  }
+
   /**
    * @brief Get read access to the inverse diagonal of this operator.
    */
@@ -278,6 +398,12 @@ public:
    */
   bool read_plain = false;
 
+  /**
+   * @brief Whether the user-defined operator is linearized with dual numbers, i.e., the
+   * operator is the RHS of a solve block with an automatic Jacobian.
+   */
+  bool linearize = false;
+
 private:
   /**
    * @brief The attribute list of the relevant variables.
@@ -338,6 +464,21 @@ private:
    */
   bool scale_by_diagonal = false;
 
+  /**
+   * @brief Lumped mass matrix of each block. Empty without mass terms.
+   */
+  std::vector<const SolutionVector<number> *> lumped_mass;
+
+  /**
+   * @brief Weight of the mass term of src.
+   */
+  double src_weight = 0.0;
+
+  /**
+   * @brief Weights and vectors of the other mass terms.
+   */
+  std::vector<std::pair<double, const BlockVector<number> *>> vector_terms;
+
   /**
    * @brief Mapping from field index to block index (only for dst).
    */
@@ -359,6 +500,37 @@ private:
    */
   std::shared_ptr<dealii::DiagonalMatrix<BlockVector<number>>> inverse_diagonal_entries =
     std::make_shared<dealii::DiagonalMatrix<BlockVector<number>>>();
+
+  /**
+   * @brief Sparsity pattern of the assembled matrix.
+   */
+  dealii::SparsityPattern sparsity_pattern;
+
+  /**
+   * @brief Assembled matrix on the locally relevant DoFs of the solved fields.
+   */
+  dealii::SparseMatrix<number> sparse_matrix;
+
+  /**
+   * @brief Offset of each block in the local numbering of the assembled matrix.
+   */
+  std::vector<unsigned int> local_block_offsets;
+
+  /**
+   * @brief Scratch vectors of the assembled matrix-vector multiplication.
+   */
+  mutable dealii::Vector<number> local_src;
+  mutable dealii::Vector<number> local_dst;
+
+  /**
+   * @brief Whether the operator has been assembled.
+   */
+  bool matrix_assembled = false;
+
+  /**
+   * @brief Whether vmult uses the assembled matrix.
+   */
+  bool use_assembled_matrix = false;
 };
 
 PRISMS_PF_END_NAMESPACE
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <prismspf/core/matrix_free_manager.h>
+#include <prismspf/core/timer.h>
+
+#include <prismspf/solvers/mf_operator.h>
+
+#include <prismspf/config.h>
+
+#include <string>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Direct coarse grid solver for geometric multigrid.
+ *
+ * The coarse level operator is assembled into a dense matrix by applying it to the unit
+ * vectors, which also captures the coupling between the fields of a block. The matrix
+ * is replicated on every process and factorized with LAPACK, so each coarse solve is a
+ * gather of the right-hand side and a pair of triangular solves. The factorization is
+ * recomputed by reinit() whenever the coarse operator changes, e.g., with the Newton
+ * linearization point or the timestep. This is only meant for small coarse problems,
+ * and larger coarse levels are rejected.
+ *
+ * Rows and columns of constrained degrees of freedom are zero in the level operator;
+ * their diagonal entries are set to one.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class MGCoarseGridDirect : public dealii::MGCoarseGridBase<BlockVector<number>>
+{
+public:
+  /**
+   * @brief Set the coarse operator. The matrix is assembled by the next reinit().
+   *
+   * @param _coarse_operator Operator on the coarsest level.
+   * @param template_vector Vector with the block layout of the coarsest level.
+   */
+  void
+  initialize(const MFOperator<dim, degree, number> &_coarse_operator,
+             const BlockVector<number>             &template_vector)
+  {
+    coarse_operator = &_coarse_operator;
+    n_dofs          = template_vector.size();
+    owned_dofs      = template_vector.locally_owned_elements();
+    AssertThrow(n_dofs <= max_n_dofs,
+                dealii::ExcMessage(
+                  "The coarse level has " + std::to_string(n_dofs) +
+                  " degrees of freedom, but the direct coarse grid solver replicates a "
+                  "dense matrix on every process and is limited to " +
+                  std::to_string(max_n_dofs) +
+                  ". Increase the mg depth to coarsen further, or use the Smoother or CG "
+                  "coarse grid solver."));
+    unit_vector.reinit(template_vector);
+    column.reinit(template_vector);
+    full_vector.reinit(0);
+  }
+
+  /**
+   * @brief Assemble and factorize the coarse matrix of the current coarse operator.
+   */
+  void
+  reinit()
+  {
+    Assert(coarse_operator != nullptr, dealii::ExcNotInitialized());
+    Timer::start_section("Assemble coarse matrix");
+    const MPI_Comm communicator = unit_vector.block(0).get_mpi_communicator();
+
+    // Each process fills the rows it owns. Every process loops over all columns,
+    // because the operator application is collective.
+    dealii::FullMatrix<double> full_matrix(n_dofs, n_dofs);
+    for (dealii::types::global_dof_index j = 0; j < n_dofs; ++j)
+      {
+        unit_vector = 0.0;
+        if (owned_dofs.is_element(j))
+          {
+            unit_vector(j) = 1.0;
+          }
+        coarse_operator->vmult(column, unit_vector);
+        for (const auto i : owned_dofs)
+          {
+            full_matrix(i, j) = column(i);
+          }
+      }
+    dealii::Utilities::MPI::sum(full_matrix, communicator, full_matrix);
+
+    for (dealii::types::global_dof_index i = 0; i < n_dofs; ++i)
+      {
+        if (full_matrix(i, i) == 0.0)
+          {
+            full_matrix(i, i) = 1.0;
+          }
+      }
+
+    lu_matrix.copy_from(full_matrix);
+    lu_matrix.compute_lu_factorization();
+
+    full_vector.reinit(n_dofs);
+    Timer::end_section("Assemble coarse matrix");
+  }
+
+  /**
+   * @brief Solve the coarse problem.
+   */
+  void
+  operator()([[maybe_unused]] const unsigned int level,
+             BlockVector<number>                &dst,
+             const BlockVector<number>          &src) const override
+  {
+    Assert(full_vector.size() == src.size(), dealii::ExcNotInitialized());
+    full_vector = 0.0;
+    for (const auto i : owned_dofs)
+      {
+        full_vector(i) = src(i);
+      }
+    dealii::Utilities::MPI::sum(full_vector,
+                                src.block(0).get_mpi_communicator(),
+                                full_vector);
+
+    lu_matrix.solve(full_vector);
+
+    for (const auto i : owned_dofs)
+      {
+        dst(i) = static_cast<number>(full_vector(i));
+      }
+  }
+
+private:
+  /**
+   * @brief Operator on the coarsest level.
+   */
+  const MFOperator<dim, degree, number> *coarse_operator = nullptr;
+
+  /**
+   * @brief Largest coarse level that is assembled. The dense matrix then takes 128 MB
+   * on every process.
+   */
+  static constexpr dealii::types::global_dof_index max_n_dofs = 4000;
+
+  /**
+   * @brief Number of degrees of freedom on the coarse level.
+   */
+  dealii::types::global_dof_index n_dofs = 0;
+
+  /**
+   * @brief Locally owned degrees of freedom, numbered across the blocks.
+   */
+  dealii::IndexSet owned_dofs;
+
+  /**
+   * @brief Scratch vectors for the assembly, with the block layout of the coarse level.
+   */
+  BlockVector<number> unit_vector;
+
+  BlockVector<number> column;
+
+  /**
+   * @brief LU factorization of the coarse matrix.
+   */
+  dealii::LAPACKFullMatrix<double> lu_matrix;
+
+  /**
+   * @brief Replicated right-hand side and solution.
+   */
+  mutable dealii::Vector<double> full_vector;
+};
+
+PRISMS_PF_END_NAMESPACE
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <prismspf/config.h>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Level matrices of a p-multigrid hierarchy. The finest level uses the operator
+ * of the element degree and the levels below it the operator with linear elements, so
+ * the two sets of level matrices have different types and are combined here.
+ */
+template <typename VectorType>
+class MGPCoarseningMatrix : public dealii::MGMatrixBase<VectorType>
+{
+public:
+  /**
+   * @brief Set the level matrices.
+   *
+   * @param _fine_matrix Level matrix of the finest level.
+   * @param _coarse_matrix Level matrices of the levels with linear elements.
+   */
+  void
+  initialize(const dealii::MGMatrixBase<VectorType> &_fine_matrix,
+             const dealii::MGMatrixBase<VectorType> &_coarse_matrix)
+  {
+    Assert(_coarse_matrix.get_maxlevel() + 1 == _fine_matrix.get_minlevel(),
+           dealii::ExcMessage("The linear levels must end below the finest level"));
+    fine_matrix   = &_fine_matrix;
+    coarse_matrix = &_coarse_matrix;
+  }
+
+  void
+  vmult(const unsigned int level, VectorType &dst, const VectorType &src) const override
+  {
+    get_matrix(level).vmult(level, dst, src);
+  }
+
+  void
+  vmult_add(const unsigned int level,
+            VectorType        &dst,
+            const VectorType  &src) const override
+  {
+    get_matrix(level).vmult_add(level, dst, src);
+  }
+
+  void
+  Tvmult(const unsigned int level, VectorType &dst, const VectorType &src) const override
+  {
+    get_matrix(level).Tvmult(level, dst, src);
+  }
+
+  void
+  Tvmult_add(const unsigned int level,
+             VectorType        &dst,
+             const VectorType  &src) const override
+  {
+    get_matrix(level).Tvmult_add(level, dst, src);
+  }
+
+  [[nodiscard]] unsigned int
+  get_minlevel() const override
+  {
+    Assert(coarse_matrix != nullptr, dealii::ExcNotInitialized());
+    return coarse_matrix->get_minlevel();
+  }
+
+  [[nodiscard]] unsigned int
+  get_maxlevel() const override
+  {
+    Assert(fine_matrix != nullptr, dealii::ExcNotInitialized());
+    return fine_matrix->get_maxlevel();
+  }
+
+private:
+  const dealii::MGMatrixBase<VectorType> &
+  get_matrix(const unsigned int level) const
+  {
+    Assert(fine_matrix != nullptr && coarse_matrix != nullptr,
+           dealii::ExcNotInitialized());
+    return level > coarse_matrix->get_maxlevel() ? *fine_matrix : *coarse_matrix;
+  }
+
+  /**
+   * @brief Level matrix of the finest level.
+   */
+  const dealii::MGMatrixBase<VectorType> *fine_matrix = nullptr;
+
+  /**
+   * @brief Level matrices of the levels with linear elements.
+   */
+  const dealii::MGMatrixBase<VectorType> *coarse_matrix = nullptr;
+};
+
+/**
+ * @brief Smoothers of a p-multigrid hierarchy, split like the level matrices of
+ * MGPCoarseningMatrix.
+ */
+template <typename VectorType>
+class MGPCoarseningSmoother : public dealii::MGSmootherBase<VectorType>
+{
+public:
+  /**
+   * @brief Set the smoothers.
+   *
+   * @param _fine_smoother Smoother of the finest level.
+   * @param _coarse_smoother Smoother of the levels with linear elements.
+   * @param _max_coarse_level Finest level with linear elements.
+   */
+  void
+  initialize(dealii::MGSmootherBase<VectorType> &_fine_smoother,
+             dealii::MGSmootherBase<VectorType> &_coarse_smoother,
+             const unsigned int                  _max_coarse_level)
+  {
+    fine_smoother    = &_fine_smoother;
+    coarse_smoother  = &_coarse_smoother;
+    max_coarse_level = _max_coarse_level;
+  }
+
+  void
+  clear() override
+  {
+    if (fine_smoother != nullptr)
+      {
+        fine_smoother->clear();
+      }
+    if (coarse_smoother != nullptr)
+      {
+        coarse_smoother->clear();
+      }
+  }
+
+  void
+  smooth(const unsigned int level, VectorType &u, const VectorType &rhs) const override
+  {
+    get_smoother(level).smooth(level, u, rhs);
+  }
+
+  void
+  apply(const unsigned int level, VectorType &u, const VectorType &rhs) const override
+  {
+    get_smoother(level).apply(level, u, rhs);
+  }
+
+private:
+  const dealii::MGSmootherBase<VectorType> &
+  get_smoother(const unsigned int level) const
+  {
+    Assert(fine_smoother != nullptr && coarse_smoother != nullptr,
+           dealii::ExcNotInitialized());
+    return level > max_coarse_level ? *fine_smoother : *coarse_smoother;
+  }
+
+  /**
+   * @brief Smoother of the finest level.
+   */
+  dealii::MGSmootherBase<VectorType> *fine_smoother = nullptr;
+
+  /**
+   * @brief Smoother of the levels with linear elements.
+   */
+  dealii::MGSmootherBase<VectorType> *coarse_smoother = nullptr;
+
+  /**
+   * @brief Finest level with linear elements.
+   */
+  unsigned int max_coarse_level = 0;
+};
+
+PRISMS_PF_END_NAMESPACE
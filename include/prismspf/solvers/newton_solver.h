@@ -9,12 +9,17 @@
 #include <prismspf/core/group_solution_handler.h>
 #include <prismspf/core/types.h>
 
+#include <prismspf/solvers/jacobian_free_operator.h>
 #include <prismspf/solvers/linear_solver.h>
 #include <prismspf/solvers/mf_operator.h>
 #include <prismspf/solvers/solver_base.h>
 
 #include <prismspf/config.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -53,7 +58,15 @@ public:
   init(const std::list<SolveBlock> &all_solve_blocks) override
   {
     LinearSolver<dim, degree, number>::init(all_solve_blocks);
+    validate_globalization();
     newton_update.reinit(solutions.get_solution_full_vector());
+    reinit_globalization_vectors();
+    if (newton_params().jacobian_free)
+      {
+        jacobian_free_operator.init(rhs_operator,
+                                    solutions,
+                                    newton_params().finite_difference_step);
+      }
   }
 
   /**
@@ -64,6 +77,7 @@ public:
   {
     LinearSolver<dim, degree, number>::reinit();
     newton_update.reinit(solutions.get_solution_full_vector());
+    reinit_globalization_vectors();
   }
 
   /**
@@ -76,33 +90,57 @@ public:
     const number newton_tolerance =
       newton_params().tolerance_value * normalization_value();
     unsigned int newton_max_iterations = newton_params().max_iterations;
+    const bool   eisenstat_walker      = newton_params().eisenstat_walker;
+    const NewtonGlobalization globalization = newton_params().globalization;
+    const bool                log_iterations =
+      globalization != FixedStep &&
+      solve_context->get_user_inputs().output_parameters.should_output(
+        solve_context->get_simulation_timer().get_increment());
+    trust_region_radius = newton_params().initial_trust_region_radius;
 
     BlockVector<number>             &newton_residual = rhs_vector;
     MFOperator<dim, degree, number> &rhs_op          = rhs_operator;
     MFOperator<dim, degree, number> &lhs_op          = lhs_operator;
-    // TODO: setup initial guess for solution vector. Maybe use old_solution if
-    // available.
-    if (!solutions.get_primary_solutions().old_solutions.empty())
+    // Initial guess. Extrapolate the old solutions in time if requested, otherwise start
+    // from the previous solution.
+    solutions.zero_out_ghosts();
+    const bool extrapolated =
+      this->lin_params().extrapolation_order > 0 &&
+      this->extrapolate_solution(solutions.get_solution_full_vector(),
+                                 this->lin_params().extrapolation_order);
+    if (!extrapolated && !solutions.get_primary_solutions().old_solutions.empty())
       {
         solutions.get_solution_full_vector() = solutions.get_old_solution_full_vector(0);
       }
+    this->update_time_terms();
 
     // Newton iteration loop.
     bool         newton_unconverged = true;
     unsigned int iter               = 0;
     number       l2_norm            = -1.0;
     int          total_lin_iters    = 0;
-    while (newton_unconverged && iter < newton_max_iterations)
+    int          saved_lin_iters    = 0;
+    double       forcing_term       = newton_params().initial_forcing_term;
+    double       previous_l2_norm   = 0.0;
+    bool         residual_is_current = false;
+    // The residual is evaluated once more after the last update, so that the
+    // convergence check covers the final iterate.
+    while (true)
       {
-        // Apply constraints to solution vector
-        solutions.apply_constraints();
-        solutions.update_ghosts();
+        // The line searches and the trust region leave the residual of the accepted
+        // step behind, so it doesn't have to be recomputed
+        if (!residual_is_current)
+          {
+            // Apply constraints to solution vector
+            solutions.apply_constraints();
+            solutions.update_ghosts();
 
-        // Solve for Newton-residual (r)
-        Timer::start_section("Zero ghosts");
-        newton_residual.zero_out_ghost_values();
-        Timer::end_section("Zero ghosts");
-        rhs_op.compute_operator(newton_residual);
+            // Solve for Newton-residual (r)
+            Timer::start_section("Zero ghosts");
+            newton_residual.zero_out_ghost_values();
+            Timer::end_section("Zero ghosts");
+            rhs_op.compute_operator(newton_residual);
+          }
         newton_residual.update_ghost_values();
 
         // Check convergence.
@@ -110,25 +148,101 @@ public:
         newton_unconverged = l2_norm > newton_tolerance;
         if (!newton_unconverged || iter == newton_max_iterations)
           {
-            continue;
+            break;
           }
 
         // Solve for Newton update. (-dr/du|Du)
         if (solutions.num_levels() > 1)
           {
-            solutions.mg_transfer_down(
-              solve_context->get_dof_manager(),
-              solve_context->get_user_inputs().spatial_discretization.global_refinement,
-              false);
+            solutions.mg_transfer_down(solve_context->get_dof_manager(), false);
+          }
+        if (eisenstat_walker)
+          {
+            if (iter > 0)
+              {
+                forcing_term = next_forcing_term(forcing_term, l2_norm, previous_l2_norm);
+              }
+            // Don't solve the linear system much more accurately than the Newton
+            // tolerance can use
+            const double floor = 0.5 * newton_tolerance / l2_norm;
+            this->set_linear_tolerance(std::max(forcing_term, floor) * l2_norm);
+          }
+        previous_l2_norm = l2_norm;
+
+        // The autotune sweep runs on the first Newton system that is due
+        int lin_iters = 0;
+        if (newton_params().jacobian_free)
+          {
+            jacobian_free_operator.set_linearization_point(newton_residual);
+            if (this->autotune_due())
+              {
+                this->autotune(newton_residual,
+                               jacobian_free_operator,
+                               lhs_op,
+                               newton_update);
+              }
+            lin_iters =
+              do_linear_solve(newton_residual, jacobian_free_operator, lhs_op, newton_update);
+          }
+        else
+          {
+            if (this->autotune_due())
+              {
+                this->autotune(newton_residual, lhs_op, newton_update);
+              }
+            lin_iters = do_linear_solve(newton_residual, lhs_op, newton_update);
+          }
+        total_lin_iters += lin_iters;
+        if (eisenstat_walker)
+          {
+            saved_lin_iters += estimate_saved_iterations(lin_iters);
           }
-        total_lin_iters += do_linear_solve(newton_residual, lhs_op, newton_update);
         newton_update.update_ghost_values();
 
-        // Zero out the ghosts
-        solutions.get_solution_full_vector().zero_out_ghost_values();
+        // Perform Newton update. The damping is the length of the accepted update
+        // relative to the Newton update.
+        double damping = newton_step_length;
+        if (globalization == FixedStep)
+          {
+            // Zero out the ghosts
+            solutions.get_solution_full_vector().zero_out_ghost_values();
 
-        // Perform Newton update.
-        solutions.get_solution_full_vector().add(newton_step_length, newton_update);
+            solutions.get_solution_full_vector().add(newton_step_length, newton_update);
+          }
+        else
+          {
+            Timer::start_section("Newton globalization");
+            base_solution = solutions.get_solution_full_vector();
+            base_solution.zero_out_ghost_values();
+            if (globalization == Backtracking)
+              {
+                damping = backtracking_line_search(l2_norm);
+              }
+            else if (globalization == CriticalPoint)
+              {
+                damping = critical_point_line_search(l2_norm);
+              }
+            else
+              {
+                damping = dogleg_step(l2_norm, lhs_op);
+              }
+            newton_residual.swap(trial_residual);
+            residual_is_current = true;
+            Timer::end_section("Newton globalization");
+          }
+
+        if (log_iterations)
+          {
+            ConditionalOStreams::pout_summary()
+              << "  Newton iteration " << iter << " residual: " << l2_norm
+              << " damping: " << damping;
+            if (globalization == TrustRegion)
+              {
+                ConditionalOStreams::pout_summary()
+                  << " trust region radius: " << trust_region_radius;
+              }
+            ConditionalOStreams::pout_summary() << "\n";
+          }
 
         // Update the ghosts
         Timer::start_section("Update ghosts");
@@ -136,19 +250,26 @@ public:
         Timer::end_section("Update ghosts");
 
         iter++;
-        // Todo: implement some super simple backtracking. Something like if the residual
-        // increases instead of decreasing, try again with a smaller step length.
       }
     if (solve_context->get_user_inputs().output_parameters.should_output(
           solve_context->get_simulation_timer().get_increment()))
       {
         ConditionalOStreams::pout_summary()
           << " Newton solve final residual : " << l2_norm / normalization_value()
-          << " Newton steps: " << iter << " Total linear steps: " << total_lin_iters
-          << "\n"
-          << std::flush;
+          << " Newton steps: " << iter << " Total linear steps: " << total_lin_iters;
+        if (eisenstat_walker)
+          {
+            ConditionalOStreams::pout_summary()
+              << " Estimated saved linear steps: " << saved_lin_iters;
+          }
+        ConditionalOStreams::pout_summary() << "\n" << std::flush;
+      }
+    if (eisenstat_walker)
+      {
+        this->reset_linear_tolerance();
       }
-    if (iter >= newton_max_iterations)
+    this->solve_failed = newton_unconverged || !std::isfinite(l2_norm);
+    if (newton_unconverged)
       {
         ConditionalOStreams::pout_base()
           << "[Increment " << solve_context->get_simulation_timer().get_increment()
@@ -158,9 +279,415 @@ public:
       }
   }
 
+protected:
+  /**
+   * @brief Norm of the Newton residual of the current solution, in the units of the
+   * Newton tolerance.
+   */
+  [[nodiscard]] double
+  current_residual_norm() override
+  {
+    this->update_time_terms();
+    rhs_vector.zero_out_ghost_values();
+    rhs_operator.compute_operator(rhs_vector);
+    return rhs_vector.l2_norm() / normalization_value();
+  }
+
 private:
   BlockVector<number> newton_update; //"change" term
 
+  /**
+   * @brief Finite difference approximation of the Jacobian, used instead of the LHS
+   * operator in Jacobian-free mode.
+   */
+  JacobianFreeOperator<dim, degree, number> jacobian_free_operator;
+
+  /**
+   * @brief Solution at the start of the globalized Newton step.
+   */
+  BlockVector<number> base_solution;
+
+  /**
+   * @brief Residual of the most recent trial step.
+   */
+  BlockVector<number> trial_residual;
+
+  /**
+   * @brief Dogleg scratch vectors: the steepest descent direction, the Jacobian applied
+   * to it and to the Newton update, and the trial step.
+   */
+  BlockVector<number> descent_direction;
+
+  BlockVector<number> jacobian_descent_direction;
+
+  BlockVector<number> jacobian_newton_update;
+
+  BlockVector<number> trial_step;
+
+  /**
+   * @brief Current trust region radius. Zero until the first Newton update sets it.
+   */
+  double trust_region_radius = 0.0;
+
+  /**
+   * @brief Allocate the vectors needed by the globalization strategy.
+   */
+  /**
+   * @brief Check that the globalization can be used with the solve block.
+   *
+   * The dogleg step needs the transpose of the Jacobian, which the matrix-free operators
+   * only have for symmetric Jacobians. The solve block states that its LHS is symmetric
+   * by solving it with one of the CG solvers, so the trust region is rejected for every
+   * other linear solver, including the ones the autotuning may pick.
+   */
+  void
+  validate_globalization() const
+  {
+    if (newton_params().globalization != TrustRegion)
+      {
+        return;
+      }
+    const auto is_symmetric_solver = [](const std::string &solver_type)
+    {
+      return solver_type == "cg" || solver_type == "pipelined_cg" ||
+             solver_type == "s_step_cg" || solver_type == "deflated_cg";
+    };
+    bool symmetric = is_symmetric_solver(this->lin_params().solver_type);
+    for (const std::string &solver_type : this->lin_params().autotune_solver_types)
+      {
+        symmetric = symmetric && is_symmetric_solver(solver_type);
+      }
+    AssertThrow(symmetric,
+                dealii::ExcMessage("The TrustRegion globalization of solve block " +
+                                   std::to_string(solve_block.id) +
+                                   " requires a symmetric Jacobian, which is solved with "
+                                   "a CG linear solver. Use another globalization for "
+                                   "nonsymmetric Jacobians."));
+  }
+
+  void
+  reinit_globalization_vectors()
+  {
+    const NewtonGlobalization globalization = newton_params().globalization;
+    if (globalization == FixedStep)
+      {
+        return;
+      }
+    const BlockVector<number> &solution = solutions.get_solution_full_vector();
+    base_solution.reinit(solution, true);
+    trial_residual.reinit(solution, true);
+    if (globalization == TrustRegion)
+      {
+        descent_direction.reinit(solution, true);
+        jacobian_descent_direction.reinit(solution, true);
+        jacobian_newton_update.reinit(solution, true);
+        trial_step.reinit(solution, true);
+      }
+  }
+
+  /**
+   * @brief Set the solution to base_solution + length * step, and compute its residual
+   * in trial_residual. Returns the l2 norm of the residual.
+   */
+  number
+  evaluate_trial(const BlockVector<number> &step, double length)
+  {
+    BlockVector<number> &solution = solutions.get_solution_full_vector();
+    solution.zero_out_ghost_values();
+    solution = base_solution;
+    solution.add(length, step);
+    solutions.apply_constraints();
+    solution.update_ghost_values();
+
+    trial_residual.zero_out_ghost_values();
+    rhs_operator.compute_operator(trial_residual);
+    return trial_residual.l2_norm();
+  }
+
+  /**
+   * @brief Print a warning when the globalization could not find an acceptable step.
+   */
+  void
+  warn_globalization_failure() const
+  {
+    ConditionalOStreams::pout_base()
+      << "[Increment " << solve_context->get_simulation_timer().get_increment() << "] "
+      << "Warning: Newton globalization did not find a sufficient decrease of the "
+         "residual in "
+      << newton_params().max_line_search_iterations
+      << " iterations. Taking the last trial step.\n";
+  }
+
+  /**
+   * @brief Armijo backtracking. The step size starts at the constant step size and is
+   * reduced by the step size modifier until
+   * |r(u + lambda du)| <= (1 - c lambda) |r(u)|.
+   */
+  double
+  backtracking_line_search(number l2_norm)
+  {
+    const double tau    = newton_params().step_size_modifier;
+    const double c      = newton_params().residual_decrease_coefficient;
+    double       lambda = newton_params().step_length;
+    for (unsigned int i = 0; i < newton_params().max_line_search_iterations; ++i)
+      {
+        if (i > 0)
+          {
+            lambda *= tau;
+          }
+        if (evaluate_trial(newton_update, lambda) <= (1.0 - (c * lambda)) * l2_norm)
+          {
+            return lambda;
+          }
+      }
+    warn_globalization_failure();
+    return lambda;
+  }
+
+  /**
+   * @brief Critical point line search. Secant iterations on the derivative of
+   * phi(lambda) = |r(u + lambda du)|^2, where the derivatives are estimated from phi at
+   * the previous step size, the midpoint, and the current step size. The step size is
+   * kept between the smallest backtracking step and the constant step size, and the
+   * best step size seen is taken.
+   */
+  double
+  critical_point_line_search(number l2_norm)
+  {
+    const double max_lambda = newton_params().step_length;
+    const double min_lambda =
+      max_lambda * std::pow(newton_params().step_size_modifier,
+                            double(newton_params().max_line_search_iterations));
+    const double relative_tolerance = 1.0e-3;
+
+    double lambda      = max_lambda;
+    double lambda_old  = 0.0;
+    double phi_old     = double(l2_norm) * l2_norm;
+    double best_lambda = lambda;
+    double best_phi    = std::numeric_limits<double>::max();
+    double last_lambda = -1.0;
+
+    const auto evaluate_phi = [&](double trial_lambda)
+    {
+      const double norm = evaluate_trial(newton_update, trial_lambda);
+      const double phi  = norm * norm;
+      last_lambda       = trial_lambda;
+      if (phi < best_phi)
+        {
+          best_phi    = phi;
+          best_lambda = trial_lambda;
+        }
+      return phi;
+    };
+
+    for (unsigned int i = 0; i < newton_params().max_line_search_iterations; ++i)
+      {
+        const double phi_mid = evaluate_phi(0.5 * (lambda + lambda_old));
+        const double phi     = evaluate_phi(lambda);
+
+        // One-sided derivatives at lambda from the quadratic through the three points
+        const double delta  = lambda - lambda_old;
+        const double dphi   = ((3.0 * phi) - (4.0 * phi_mid) + phi_old) / delta;
+        const double d2phi  = 4.0 * (phi - (2.0 * phi_mid) + phi_old) / (delta * delta);
+        double       update = 0.0;
+        if (d2phi > 0.0)
+          {
+            update = lambda - (dphi / d2phi);
+          }
+        else
+          {
+            // Not convex. Move towards decreasing phi.
+            update = dphi < 0.0 ? max_lambda : lambda * newton_params().step_size_modifier;
+          }
+        update = std::clamp(update, min_lambda, max_lambda);
+
+        lambda_old = lambda;
+        phi_old    = phi;
+        lambda     = update;
+        if (std::abs(lambda - lambda_old) <= relative_tolerance * lambda_old)
+          {
+            break;
+          }
+      }
+    if (best_phi >= double(l2_norm) * l2_norm)
+      {
+        warn_globalization_failure();
+      }
+
+    // Leave the solution and the residual at the best step size
+    if (last_lambda != best_lambda)
+      {
+        evaluate_trial(newton_update, best_lambda);
+      }
+    return best_lambda;
+  }
+
+  /**
+   * @brief Trust region dogleg step.
+   *
+   * With J the LHS operator (approximately -dr/du), the linear model of the residual is
+   * r(u + s) ~ r(u) - J s. The step goes from the Cauchy point along the steepest
+   * descent direction J^T r towards the Newton update, and is cut off at the trust
+   * region radius. The radius is adapted from the ratio of the actual and predicted
+   * reduction of |r|^2, and the step is retried with a smaller radius if the ratio is
+   * below the residual decrease coefficient. Every rejected step shrinks the radius.
+   * The matrix-free operators apply their transpose with vmult, so the Jacobian has to
+   * be symmetric, which validate_globalization() checks through the linear solver.
+   */
+  double
+  dogleg_step(number l2_norm, MFOperator<dim, degree, number> &lhs_op)
+  {
+    // Jacobian products, computed at the current solution
+    const auto apply_jacobian =
+      [&](BlockVector<number> &dst, const BlockVector<number> &src, bool transpose)
+    {
+      if (newton_params().jacobian_free)
+        {
+          jacobian_free_operator.vmult(dst, src);
+        }
+      else if (transpose)
+        {
+          lhs_op.Tvmult(dst, src);
+        }
+      else
+        {
+          lhs_op.vmult(dst, src);
+        }
+    };
+    apply_jacobian(descent_direction, rhs_vector, true);
+    apply_jacobian(jacobian_descent_direction, descent_direction, false);
+    apply_jacobian(jacobian_newton_update, newton_update, false);
+
+    const double rr    = double(l2_norm) * l2_norm;
+    const double gg    = descent_direction.norm_sqr();
+    const double dd    = newton_update.norm_sqr();
+    const double gd    = descent_direction * newton_update;
+    const double jgjg  = jacobian_descent_direction.norm_sqr();
+    const double jgjd  = jacobian_descent_direction * jacobian_newton_update;
+    const double jdjd  = jacobian_newton_update.norm_sqr();
+    const double rjg   = rhs_vector * jacobian_descent_direction;
+    const double rjd   = rhs_vector * jacobian_newton_update;
+    const double alpha = jgjg > 0.0 ? gg / jgjg : 0.0;
+
+    if (trust_region_radius <= 0.0)
+      {
+        trust_region_radius = std::sqrt(dd);
+      }
+
+    const double eta     = newton_params().residual_decrease_coefficient;
+    double       damping = 0.0;
+    for (unsigned int i = 0; i < newton_params().max_line_search_iterations; ++i)
+      {
+        // Dogleg step s = a g + b du
+        const double radius = trust_region_radius;
+        double       a      = 0.0;
+        double       b      = 0.0;
+        if (dd <= radius * radius)
+          {
+            a = 0.0;
+            b = 1.0;
+          }
+        else if (alpha * alpha * gg >= radius * radius)
+          {
+            a = radius / std::sqrt(gg);
+            b = 0.0;
+          }
+        else
+          {
+            // Solve |p + t q| = radius for t in [0, 1], with p = alpha g, q = du - p
+            const double pp = alpha * alpha * gg;
+            const double pq = (alpha * gd) - pp;
+            const double qq = dd - (2.0 * alpha * gd) + pp;
+            const double t =
+              (-pq + std::sqrt((pq * pq) + (qq * (radius * radius - pp)))) / qq;
+            a = alpha * (1.0 - t);
+            b = t;
+          }
+        const double step_norm =
+          std::sqrt((a * a * gg) + (2.0 * a * b * gd) + (b * b * dd));
+
+        // Predicted and actual reduction of |r|^2
+        const double model = rr - (2.0 * a * rjg) - (2.0 * b * rjd) + (a * a * jgjg) +
+                             (2.0 * a * b * jgjd) + (b * b * jdjd);
+        const double predicted = rr - model;
+
+        trial_step.equ(a, descent_direction);
+        trial_step.add(b, newton_update);
+        const double trial_norm = evaluate_trial(trial_step, 1.0);
+        const double actual     = rr - (double(trial_norm) * trial_norm);
+        const double ratio      = predicted > 0.0 ? actual / predicted : -1.0;
+        damping                 = dd > 0.0 ? step_norm / std::sqrt(dd) : 0.0;
+
+        if (ratio > eta)
+          {
+            if (ratio < 0.25)
+              {
+                trust_region_radius = 0.25 * step_norm;
+              }
+            else if (ratio > 0.75 && step_norm >= 0.99 * radius)
+              {
+                trust_region_radius = 2.0 * radius;
+              }
+            return damping;
+          }
+        // Rejected steps always shrink the radius, so that the retry takes a different
+        // step
+        trust_region_radius = 0.25 * step_norm;
+      }
+    warn_globalization_failure();
+    return damping;
+  }
+
+  /**
+   * @brief Eisenstat-Walker (choice 2) forcing term for the next Newton iteration.
+   *
+   * The forcing term follows the observed reduction of the residual,
+   * gamma * (|F_k| / |F_{k-1}|)^alpha. It is not allowed to drop much faster than the
+   * previous one, because the ratio can be accidentally small, and is capped at the
+   * maximum forcing term.
+   */
+  [[nodiscard]] double
+  next_forcing_term(double previous_forcing_term,
+                    double l2_norm,
+                    double previous_l2_norm) const
+  {
+    const double gamma = newton_params().forcing_term_gamma;
+    const double alpha = newton_params().forcing_term_alpha;
+
+    double forcing_term = gamma * std::pow(l2_norm / previous_l2_norm, alpha);
+
+    const double safeguard = gamma * std::pow(previous_forcing_term, alpha);
+    if (safeguard > 0.1)
+      {
+        forcing_term = std::max(forcing_term, safeguard);
+      }
+    return std::min(forcing_term, newton_params().max_forcing_term);
+  }
+
+  /**
+   * @brief Estimate how many more iterations the last linear solve would have taken with
+   * the fixed tolerance from the linear solver parameters, assuming the residual kept
+   * decreasing at its observed average rate.
+   */
+  [[nodiscard]] int
+  estimate_saved_iterations(int lin_iters)
+  {
+    const dealii::SolverControl &control = this->get_linear_solver_control();
+    const double fixed_tolerance = this->lin_params().tolerance * normalization_value();
+    if (lin_iters <= 0 || control.last_value() >= control.initial_value() ||
+        control.initial_value() <= fixed_tolerance || control.last_value() <= 0.0)
+      {
+        return 0;
+      }
+
+    const double log_rate =
+      std::log(control.last_value() / control.initial_value()) / lin_iters;
+    const double fixed_iters =
+      std::min(std::ceil(std::log(fixed_tolerance / control.initial_value()) / log_rate),
+               double(this->lin_params().max_iterations));
+    return std::max(0, int(fixed_iters) - lin_iters);
+  }
+
   [[nodiscard]] const NonlinearSolverParameters &
   newton_params() const
   {
@@ -0,0 +1,336 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/vectorization.h>
+
+#include <prismspf/core/matrix_free_manager.h>
+#include <prismspf/core/pde_operator_base.h>
+#include <prismspf/core/simulation_timer.h>
+#include <prismspf/core/solve_block.h>
+#include <prismspf/core/type_enums.h>
+
+#include <prismspf/utilities/dual_number.h>
+
+#include <prismspf/config.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+/**
+ * @brief Integrator of the local reaction du/dt = r(u) of a solve block with operator
+ * splitting.
+ *
+ * The reaction of the user's compute_reaction couples the fields of the solve block at
+ * each DoF, but not different DoFs. The scalar fields of a solve block share the scalar
+ * DoFHandler, so the same local index in each block of the solution vector is the same
+ * support point, and the DoFs are integrated in batches of the width of a
+ * VectorizedArray. The implicit integrators solve their stage equations with Newton
+ * iterations at each DoF. The Jacobian of the reaction is evaluated with one dual
+ * direction per field, and the small linear systems are solved with Gaussian elimination
+ * without pivoting.
+ */
+template <unsigned int dim, unsigned int degree, typename number>
+class PointwiseReactionIntegrator
+{
+public:
+  using ScalarValue = dealii::VectorizedArray<number>;
+  using DualValue   = DualNumber<ScalarValue>;
+  using State       = std::vector<ScalarValue>;
+
+  /**
+   * @brief Constructor.
+   */
+  PointwiseReactionIntegrator(const PDEOperatorBase<dim, degree, number> &_pde_operator,
+                              const SimulationTimer                      &_sim_timer,
+                              const SolveBlock                           &_solve_block)
+    : pde_operator(&_pde_operator)
+    , sim_timer(&_sim_timer)
+    , solve_block(&_solve_block)
+    , n_fields(_solve_block.field_indices.size())
+  {}
+
+  /**
+   * @brief Integrate the reaction of the locally owned DoFs over the given time, in
+   * place. Returns whether the Newton iterations converged at every DoF of every
+   * process.
+   */
+  [[nodiscard]] bool
+  integrate(BlockVector<number> &state, double time) const
+  {
+    Assert(state.n_blocks() == n_fields,
+           dealii::ExcDimensionMismatch(state.n_blocks(), n_fields));
+    const unsigned int n_lanes   = ScalarValue::size();
+    const unsigned int n_dofs    = state.block(0).locally_owned_size();
+    const double       step_size = time / solve_block->reaction_steps;
+
+    bool  converged = true;
+    State values(n_fields);
+    for (unsigned int first_dof = 0; first_dof < n_dofs; first_dof += n_lanes)
+      {
+        // Unused lanes repeat the last DoF, so that they stay finite
+        const unsigned int n_filled = std::min(n_lanes, n_dofs - first_dof);
+        for (unsigned int field = 0; field < n_fields; ++field)
+          {
+            for (unsigned int lane = 0; lane < n_lanes; ++lane)
+              {
+                values[field][lane] =
+                  state.block(field).local_element(first_dof +
+                                                   std::min(lane, n_filled - 1));
+              }
+          }
+        for (unsigned int step = 0; step < solve_block->reaction_steps; ++step)
+          {
+            converged = integrate_step(values, step_size) && converged;
+          }
+        for (unsigned int field = 0; field < n_fields; ++field)
+          {
+            for (unsigned int lane = 0; lane < n_filled; ++lane)
+              {
+                state.block(field).local_element(first_dof + lane) = values[field][lane];
+              }
+          }
+      }
+    return dealii::Utilities::MPI::logical_and(converged, MPI_COMM_WORLD);
+  }
+
+private:
+  /**
+   * @brief Maximum number of Newton iterations of a stage equation.
+   */
+  static constexpr unsigned int max_newton_iterations = 20;
+
+  /**
+   * @brief Tolerance of the Newton update, relative to one plus the magnitude of the
+   * value.
+   */
+  static constexpr double newton_tolerance = 1.0e-10;
+
+  /**
+   * @brief Advance the values by one step of the reaction integrator.
+   */
+  [[nodiscard]] bool
+  integrate_step(State &values, double step_size) const
+  {
+    switch (solve_block->reaction_integrator)
+      {
+        case ReactionBackwardEuler:
+          {
+            const State start = values;
+            State       rate(n_fields);
+            return solve_stage(values, start, step_size, rate);
+          }
+        case ReactionSDIRK2:
+          {
+            // y_1 = u + gamma h r(y_1),
+            // u_new = y_2 = u + (1 - gamma) h r(y_1) + gamma h r(y_2)
+            const double gamma = 1.0 - (1.0 / std::sqrt(2.0));
+            State        base  = values;
+            State        rate(n_fields);
+            bool         converged = solve_stage(values, base, gamma * step_size, rate);
+            for (unsigned int field = 0; field < n_fields; ++field)
+              {
+                base[field] += (1.0 - gamma) * step_size * rate[field];
+              }
+            converged = solve_stage(values, base, gamma * step_size, rate) && converged;
+            return converged;
+          }
+        case ReactionRK4:
+          {
+            static constexpr std::array<double, 4> stage_offsets = {0.0, 0.5, 0.5, 1.0};
+            static constexpr std::array<double, 4> stage_weights = {1.0 / 6.0,
+                                                                    1.0 / 3.0,
+                                                                    1.0 / 3.0,
+                                                                    1.0 / 6.0};
+            const State start = values;
+            State       stage = values;
+            State       rate(n_fields);
+            for (unsigned int index = 0; index < stage_offsets.size(); ++index)
+              {
+                if (index > 0)
+                  {
+                    for (unsigned int field = 0; field < n_fields; ++field)
+                      {
+                        stage[field] =
+                          start[field] + stage_offsets[index] * step_size * rate[field];
+                      }
+                  }
+                evaluate_rate(stage, rate);
+                for (unsigned int field = 0; field < n_fields; ++field)
+                  {
+                    values[field] += stage_weights[index] * step_size * rate[field];
+                  }
+              }
+            return true;
+          }
+        default:
+          AssertThrow(false, dealii::ExcMessage("Unknown reaction integrator"));
+          return false;
+      }
+  }
+
+  /**
+   * @brief Solve the stage equation y = base + scaled_step r(y) with Newton iterations,
+   * starting from the given y. The rate r(y) at the solution is returned as well.
+   */
+  [[nodiscard]] bool
+  solve_stage(State       &stage,
+              const State &base,
+              double       scaled_step,
+              State       &rate) const
+  {
+    std::vector<ScalarValue> jacobian(n_fields * n_fields);
+    State                    update(n_fields);
+    for (unsigned int iteration = 0; iteration < max_newton_iterations; ++iteration)
+      {
+        // (I - scaled_step J) dy = base + scaled_step r(y) - y
+        evaluate_jacobian(stage, rate, jacobian);
+        for (unsigned int row = 0; row < n_fields; ++row)
+          {
+            update[row] = base[row] + scaled_step * rate[row] - stage[row];
+            for (unsigned int column = 0; column < n_fields; ++column)
+              {
+                jacobian[(row * n_fields) + column] =
+                  -scaled_step * jacobian[(row * n_fields) + column];
+              }
+            jacobian[(row * n_fields) + row] += ScalarValue(1.0);
+          }
+        solve_dense(jacobian, update);
+
+        bool converged = true;
+        for (unsigned int field = 0; field < n_fields; ++field)
+          {
+            stage[field] += update[field];
+            for (unsigned int lane = 0; lane < ScalarValue::size(); ++lane)
+              {
+                // Written so that NaN does not count as converged
+                converged = converged &&
+                            std::abs(update[field][lane]) <=
+                              newton_tolerance * (1.0 + std::abs(stage[field][lane]));
+              }
+          }
+        if (converged)
+          {
+            evaluate_rate(stage, rate);
+            return true;
+          }
+      }
+    evaluate_rate(stage, rate);
+    return false;
+  }
+
+  /**
+   * @brief Evaluate the reaction rates.
+   */
+  void
+  evaluate_rate(const State &values, State &rate) const
+  {
+    std::vector<DualValue> dual_values(n_fields);
+    std::vector<DualValue> dual_rates(n_fields);
+    for (unsigned int field = 0; field < n_fields; ++field)
+      {
+        dual_values[field] = DualValue(values[field], ScalarValue(0.0));
+        dual_rates[field]  = DualValue(ScalarValue(0.0), ScalarValue(0.0));
+      }
+    pde_operator->compute_reaction(dual_rates, dual_values, *sim_timer, solve_block->id);
+    for (unsigned int field = 0; field < n_fields; ++field)
+      {
+        rate[field] = dual_rates[field].value;
+      }
+  }
+
+  /**
+   * @brief Evaluate the reaction rates and their Jacobian, stored row-major, with one
+   * dual direction per field.
+   */
+  void
+  evaluate_jacobian(const State              &values,
+                    State                    &rate,
+                    std::vector<ScalarValue> &jacobian) const
+  {
+    std::vector<DualValue> dual_values(n_fields);
+    std::vector<DualValue> dual_rates(n_fields);
+    for (unsigned int direction = 0; direction < n_fields; ++direction)
+      {
+        for (unsigned int field = 0; field < n_fields; ++field)
+          {
+            dual_values[field] =
+              DualValue(values[field], ScalarValue(field == direction ? 1.0 : 0.0));
+            dual_rates[field] = DualValue(ScalarValue(0.0), ScalarValue(0.0));
+          }
+        pde_operator->compute_reaction(dual_rates,
+                                       dual_values,
+                                       *sim_timer,
+                                       solve_block->id);
+        for (unsigned int field = 0; field < n_fields; ++field)
+          {
+            jacobian[(field * n_fields) + direction] = dual_rates[field].derivative;
+          }
+      }
+    for (unsigned int field = 0; field < n_fields; ++field)
+      {
+        rate[field] = dual_rates[field].value;
+      }
+  }
+
+  /**
+   * @brief Solve the row-major system in place with Gaussian elimination without
+   * pivoting, which overwrites the matrix. The right-hand side becomes the solution.
+   */
+  void
+  solve_dense(std::vector<ScalarValue> &matrix, State &rhs) const
+  {
+    for (unsigned int pivot = 0; pivot < n_fields; ++pivot)
+      {
+        const ScalarValue inverse_pivot =
+          ScalarValue(1.0) / matrix[(pivot * n_fields) + pivot];
+        for (unsigned int row = pivot + 1; row < n_fields; ++row)
+          {
+            const ScalarValue factor = matrix[(row * n_fields) + pivot] * inverse_pivot;
+            for (unsigned int column = pivot + 1; column < n_fields; ++column)
+              {
+                matrix[(row * n_fields) + column] -=
+                  factor * matrix[(pivot * n_fields) + column];
+              }
+            rhs[row] -= factor * rhs[pivot];
+          }
+      }
+    for (unsigned int row = n_fields; row-- > 0;)
+      {
+        for (unsigned int column = row + 1; column < n_fields; ++column)
+          {
+            rhs[row] -= matrix[(row * n_fields) + column] * rhs[column];
+          }
+        rhs[row] /= matrix[(row * n_fields) + row];
+      }
+  }
+
+  /**
+   * @brief PDE operator with the user's compute_reaction.
+   */
+  const PDEOperatorBase<dim, degree, number> *pde_operator;
+
+  /**
+   * @brief Simulation timer.
+   */
+  const SimulationTimer *sim_timer;
+
+  /**
+   * @brief Solve block of the reaction.
+   */
+  const SolveBlock *solve_block;
+
+  /**
+   * @brief Number of fields of the solve block.
+   */
+  unsigned int n_fields;
+};
+
+PRISMS_PF_END_NAMESPACE
@@ -35,6 +35,8 @@ class SolveContext
 public:
   /**
    * @brief Constructor.
+   * @param _coarse_pde_operator Optional PDE operator with linear elements. It evaluates
+   * the multigrid levels below the active mesh, which enables p-multigrid.
    */
   SolveContext(std::vector<FieldAttributes>            _field_attributes,
                const UserInputParameters<dim>         &_user_inputs,
@@ -42,7 +44,8 @@ public:
                DoFManager<dim, degree>                &_dof_manager,
                ConstraintManager<dim, degree, number> &_constraint_manager,
                SolutionIndexer<dim, number>           &_solution_indexer,
-               PDEOperatorBase<dim, degree, number>   &_pde_operator)
+               PDEOperatorBase<dim, degree, number>   &_pde_operator,
+               PDEOperatorBase<dim, 1, number>        *_coarse_pde_operator = nullptr)
     : field_attributes(std::move(_field_attributes))
     , user_inputs(&_user_inputs)
     , triangulation_manager(&_triangulation_manager)
@@ -53,7 +56,8 @@ public:
     , invm_manager()
     , sim_timer(user_inputs->temporal_discretization.dt,
                 user_inputs->temporal_discretization.initial_time)
-    , pde_operator(&_pde_operator) {};
+    , pde_operator(&_pde_operator)
+    , coarse_pde_operator(_coarse_pde_operator) {};
 
   /**
    * @brief Get the field attributes.
@@ -218,6 +222,25 @@ public:
     return *pde_operator;
   }
 
+  /**
+   * @brief Whether a PDE operator with linear elements was supplied for p-multigrid.
+   */
+  [[nodiscard]] bool
+  has_coarse_pde_operator() const
+  {
+    return coarse_pde_operator != nullptr;
+  }
+
+  /**
+   * @brief Get the PDE operator with linear elements for the p-multigrid levels.
+   */
+  [[nodiscard]] const PDEOperatorBase<dim, 1, number> &
+  get_coarse_pde_operator() const
+  {
+    Assert(coarse_pde_operator != nullptr, dealii::ExcNotInitialized());
+    return *coarse_pde_operator;
+  }
+
 private:
   /**
    * @brief Field attributes.
@@ -268,6 +291,11 @@ private:
    * @brief PDE operator.
    */
   PDEOperatorBase<dim, degree, number> *pde_operator;
+
+  /**
+   * @brief PDE operator with linear elements for the p-multigrid levels.
+   */
+  PDEOperatorBase<dim, 1, number> *coarse_pde_operator;
 };
 
 PRISMS_PF_END_NAMESPACE
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/numerics/vector_tools.h>
 
 #include <boost/geometry/core/cs.hpp>
@@ -17,12 +18,20 @@
 #include <prismspf/core/type_enums.h>
 #include <prismspf/core/types.h>
 
+#include <prismspf/solvers/reaction_integrator.h>
 #include <prismspf/solvers/solve_context.h>
 
 #include <prismspf/user_inputs/user_input_parameters.h>
 
 #include <prismspf/config.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -84,6 +93,13 @@ public:
   init(const std::list<SolveBlock> &all_solve_blocks)
   {
     NewDependencyExtents extents(solve_block.field_indices, all_solve_blocks);
+    extents.max_age = std::max(extents.max_age, history_depth());
+    // The equations of a solve block with operator splitting read the result of the
+    // reaction through old_1
+    if (solve_block.reaction_splitting != SplittingScheme::NoSplitting)
+      {
+        extents.max_age = std::max(extents.max_age, 1U);
+      }
     solutions.init(extents);
 
     // Apply constraints.
@@ -91,7 +107,8 @@ public:
 
     if (solutions.num_levels() > 0)
       {
-        solutions.reinit_mg_transfer(solve_context->get_dof_manager());
+        solutions.reinit_mg_transfer(solve_context->get_dof_manager(),
+                                     solve_context->get_constraint_manager());
       }
   }
 
@@ -106,11 +123,9 @@ public:
     solutions.apply_constraints();
     if (solutions.num_levels() > 0)
       {
-        solutions.reinit_mg_transfer(solve_context->get_dof_manager());
-        solutions.mg_transfer_down(
-          solve_context->get_dof_manager(),
-          solve_context->get_user_inputs().spatial_discretization.global_refinement,
-          true);
+        solutions.reinit_mg_transfer(solve_context->get_dof_manager(),
+                                     solve_context->get_constraint_manager());
+        solutions.mg_transfer_down(solve_context->get_dof_manager(), true);
       }
   }
 
@@ -127,15 +142,28 @@ public:
   virtual void
   solve()
   {
+    solve_failed = false;
     if (solve_context->get_simulation_timer().get_increment() == 0 &&
         solve_block.solve_timing == SolveTiming::Primary)
       {
         // Set the initial condition
         set_initial_condition();
       }
+    else if (should_solve())
+      {
+        if (solve_block.reaction_splitting == SplittingScheme::NoSplitting)
+          {
+            this->solve_impl();
+          }
+        else
+          {
+            solve_split();
+          }
+        record_solve();
+      }
     else
       {
-        this->solve_impl();
+        restore_last_solution();
       }
     if (solve_context->get_simulation_timer().get_increment() == 0)
       {
@@ -143,10 +171,7 @@ public:
       }
     if (solutions.num_levels() > 0)
       {
-        solutions.mg_transfer_down(
-          solve_context->get_dof_manager(),
-          solve_context->get_user_inputs().spatial_discretization.global_refinement,
-          false);
+        solutions.mg_transfer_down(solve_context->get_dof_manager(), false);
       }
   }
 
@@ -171,10 +196,13 @@ public:
   /**
    * @brief Prepare for solution transfer (for AMR).
    */
-  void
+  virtual void
   prepare_for_solution_transfer()
   {
     solutions.prepare_for_solution_transfer();
+    // Solve again on the new mesh
+    last_solve_increment.reset();
+    driving_field_snapshots.clear();
   }
 
   /**
@@ -186,6 +214,19 @@ public:
     solutions.execute_solution_transfer();
   }
 
+  /**
+   * @brief Roll back to the snapshot of the solutions, e.g., to retry a failed
+   * increment. The failed attempt may have recorded a solve for the solve policy, so
+   * the retry solves again.
+   */
+  virtual void
+  roll_back()
+  {
+    solutions.restore_snapshot();
+    last_solve_increment.reset();
+    driving_field_snapshots.clear();
+  }
+
   /**
    * @brief Print information about the solver to summary.log.
    */
@@ -193,6 +234,26 @@ public:
   print()
   {}
 
+  /**
+   * @brief Whether the last solve failed, e.g., because the Newton iterations did not
+   * converge.
+   */
+  [[nodiscard]] bool
+  has_failed() const
+  {
+    return solve_failed;
+  }
+
+  /**
+   * @brief Estimate the maximum stable timestep of the solve block. Only explicit solve
+   * blocks have a stability limit.
+   */
+  [[nodiscard]] virtual double
+  estimate_stable_timestep()
+  {
+    return std::numeric_limits<double>::max();
+  }
+
   /**
    * @brief Set the initial conditions.
    */
@@ -236,14 +297,13 @@ public:
         if (!initialized_from_file)
           {
             solutions.get_solution_vector(global_index).zero_out_ghost_values();
-            dealii::VectorTools::interpolate(
-              SystemWide<dim, degree>::mapping,
-              solve_context->get_dof_manager().get_field_dof_handler(global_index),
-              InitialCondition<dim, degree, number>(
-                global_index,
-                solve_context->get_field_attributes()[global_index].field_type,
-                solve_context->get_pde_operator()),
-              solutions.get_solution_vector(global_index));
+            VectorizedInitialCondition<dim, degree, number>(
+              global_index,
+              solve_context->get_field_attributes()[global_index].field_type,
+              solve_context->get_pde_operator())
+              .interpolate(
+                solve_context->get_dof_manager().get_field_dof_handler(global_index),
+                solutions.get_solution_vector(global_index));
           }
         solutions.apply_initial_condition_for_old_fields();
       }
@@ -277,6 +337,186 @@ public:
   }
 
 protected:
+  /**
+   * @brief Number of old solutions the solver itself needs, regardless of the
+   * dependencies of the user's equations.
+   */
+  [[nodiscard]] virtual unsigned int
+  history_depth() const
+  {
+    return 0;
+  }
+
+  /**
+   * @brief Norm of the residual of the current solution, normalized like the tolerance
+   * of the linear solver. Used by the SolveOnResidual policy.
+   */
+  [[nodiscard]] virtual double
+  current_residual_norm()
+  {
+    return std::numeric_limits<double>::max();
+  }
+
+  /**
+   * @brief Whether the solve block is solved this increment, according to its solve
+   * policy. It is always solved on the first increment and after the mesh changes.
+   */
+  [[nodiscard]] bool
+  should_solve()
+  {
+    if (solve_block.solve_policy == SolveEveryIncrement ||
+        !last_solve_increment.has_value())
+      {
+        return true;
+      }
+    switch (solve_block.solve_policy)
+      {
+        case SolveEveryNIncrements:
+          return solve_context->get_simulation_timer().get_increment() -
+                   *last_solve_increment >=
+                 solve_block.solve_period;
+        case SolveOnFieldChange:
+          return driving_field_change() > solve_block.solve_tolerance;
+        case SolveOnResidual:
+          restore_last_solution();
+          return current_residual_norm() > solve_block.solve_tolerance;
+        default:
+          return true;
+      }
+  }
+
+  /**
+   * @brief Record the increment of the solve and, for the SolveOnFieldChange policy, the
+   * fields that the equations depend on.
+   */
+  void
+  record_solve()
+  {
+    if (solve_block.solve_policy == SolveEveryIncrement)
+      {
+        return;
+      }
+    last_solve_increment = solve_context->get_simulation_timer().get_increment();
+    if (solve_block.solve_policy == SolveOnFieldChange)
+      {
+        for (const DependencyMap *dependencies :
+             {&solve_block.dependencies_rhs, &solve_block.dependencies_lhs})
+          {
+            for (const auto &[field_index, dependency] : *dependencies)
+              {
+                if (dependency.flag != dealii::EvaluationFlags::nothing &&
+                    solve_block.field_indices.count(field_index) == 0)
+                  {
+                    driving_field_snapshots[field_index] =
+                      solve_context->get_solution_indexer().get_solution_vector(
+                        field_index);
+                  }
+              }
+          }
+        AssertThrow(!driving_field_snapshots.empty(),
+                    dealii::ExcMessage("The equations of solve block " +
+                                       std::to_string(solve_block.id) +
+                                       " do not depend on the current value of "
+                                       "another field, so it cannot be solved on field "
+                                       "changes."));
+      }
+  }
+
+  /**
+   * @brief Largest relative change in the l2-norm of the fields the equations depend on,
+   * since the last solve.
+   */
+  [[nodiscard]] double
+  driving_field_change() const
+  {
+    double max_change = 0.0;
+    for (const auto &[field_index, snapshot] : driving_field_snapshots)
+      {
+        const SolutionVector<number> &field =
+          solve_context->get_solution_indexer().get_solution_vector(field_index);
+        double difference_squared = 0.0;
+        double snapshot_squared   = 0.0;
+        for (unsigned int i = 0; i < field.locally_owned_size(); ++i)
+          {
+            const double difference = field.local_element(i) - snapshot.local_element(i);
+            difference_squared += difference * difference;
+            snapshot_squared += snapshot.local_element(i) * snapshot.local_element(i);
+          }
+        difference_squared =
+          dealii::Utilities::MPI::sum(difference_squared, MPI_COMM_WORLD);
+        snapshot_squared = dealii::Utilities::MPI::sum(snapshot_squared, MPI_COMM_WORLD);
+        const double change = snapshot_squared > 0.0
+                                ? std::sqrt(difference_squared / snapshot_squared)
+                                : std::sqrt(difference_squared);
+        max_change          = std::max(max_change, change);
+      }
+    return max_change;
+  }
+
+  /**
+   * @brief Compose the local reaction and the equations of the solve block in Lie or
+   * Strang order. The first reaction substep starts from old_1, and its result replaces
+   * old_1 while the equations are solved, so that they start from it. Afterwards, old_1
+   * is restored to the state at the start of the step.
+   */
+  void
+  solve_split()
+  {
+    const SimulationTimer &sim_timer = solve_context->get_simulation_timer();
+    const double           reaction_time =
+      solve_block.reaction_splitting == SplittingScheme::StrangSplitting
+                  ? 0.5 * sim_timer.get_timestep()
+                  : sim_timer.get_timestep();
+    const PointwiseReactionIntegrator<dim, degree, number> reaction(
+      solve_context->get_pde_operator(),
+      sim_timer,
+      solve_block);
+    BlockVector<number> &state     = solutions.get_solution_full_vector();
+    BlockVector<number> &old_state = solutions.get_old_solution_full_vector(0);
+
+    // Reaction from the start of the step
+    solutions.zero_out_ghosts();
+    state                = old_state;
+    bool reaction_solved = reaction.integrate(state, reaction_time);
+    solutions.apply_constraints();
+
+    BlockVector<number> start_state;
+    start_state.reinit(old_state, true);
+    start_state = old_state;
+    old_state.zero_out_ghost_values();
+    old_state = state;
+    solutions.update_ghosts();
+
+    this->solve_impl();
+
+    // Second half of the reaction
+    if (solve_block.reaction_splitting == SplittingScheme::StrangSplitting)
+      {
+        solutions.zero_out_ghosts();
+        reaction_solved = reaction.integrate(state, reaction_time) && reaction_solved;
+        solutions.apply_constraints();
+      }
+
+    old_state.zero_out_ghost_values();
+    old_state = start_state;
+    solutions.update_ghosts();
+    solve_failed = solve_failed || !reaction_solved;
+  }
+
+  /**
+   * @brief Reset the solution to the one of the last solve. The update at the end of the
+   * previous increment moved it to the first old solution.
+   */
+  void
+  restore_last_solution()
+  {
+    if (!solutions.get_primary_solutions().old_solutions.empty())
+      {
+        solutions.get_solution_full_vector() = solutions.get_old_solution_full_vector(0);
+      }
+    solutions.update_ghosts();
+  }
+
   /**
    * @brief Information about the solve block this handler is responsible for.
    */
@@ -293,6 +533,24 @@ protected:
   GroupSolutionHandler<dim, number> solutions;
 
   std::vector<SolverBase<dim, degree, number> *> aux_solvers;
+
+  /**
+   * @brief Whether the last solve failed.
+   */
+  bool solve_failed = false;
+
+private:
+  /**
+   * @brief Increment of the last solve. Unset before the first solve and after the mesh
+   * changes.
+   */
+  std::optional<unsigned int> last_solve_increment;
+
+  /**
+   * @brief Fields that the equations depend on at the last solve, for the
+   * SolveOnFieldChange policy.
+   */
+  std::map<Types::Index, SolutionVector<number>> driving_field_snapshots;
 };
 
 PRISMS_PF_END_NAMESPACE
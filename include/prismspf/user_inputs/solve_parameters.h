@@ -16,6 +16,8 @@
 
 #include <execution>
 #include <map>
+#include <string>
+#include <vector>
 
 PRISMS_PF_BEGIN_NAMESPACE
 
@@ -45,9 +47,19 @@ struct LinearSolverParameters : public ParameterBase
   validate(const std::vector<FieldAttributes> &field_attributes,
            const std::vector<SolveBlock>      &solve_blocks) const override;
 
-  // Solver type. richardson|cg|bicgstab|gmres|fgmres|minres
+  // Solver type.
+  // richardson|cg|bicgstab|gmres|fgmres|minres|pipelined_cg|s_step_cg|deflated_cg
   std::string solver_type = "cg";
 
+  // Number of CG steps per global reduction of the s-step CG solver
+  unsigned int s_step_size = 4;
+
+  // Number of approximate eigenvectors the deflated CG solver recycles between solves
+  unsigned int deflation_space_size = 8;
+
+  // Number of search directions of each solve used to update the recycled vectors
+  unsigned int deflation_harvest_size = 20;
+
   // Solver tolerance
   double tolerance = 1.0e-10;
 
@@ -63,6 +75,57 @@ struct LinearSolverParameters : public ParameterBase
   // Preconditioner
   PreconditionerType preconditioner = PreconditionerType::None;
 
+  // Coarse grid solver of the multigrid preconditioner
+  MGCoarseSolverType mg_coarse_solver = MGCoarseSolverType::CoarseSmoother;
+
+  // Relative tolerance of the iterative coarse grid solver
+  double mg_coarse_tolerance = 1.0e-3;
+
+  // Max number of iterations of the iterative coarse grid solver
+  unsigned int mg_coarse_max_iterations = 100;
+
+  // Level smoother of the multigrid preconditioner
+  MGSmootherType mg_smoother = MGSmootherType::SmootherJacobiChebyshev;
+
+  // Damping of the additive Schwarz smoother
+  double schwarz_damping = 0.7;
+
+  // Number of additive Schwarz smoothing steps
+  unsigned int schwarz_steps = 2;
+
+  // Form of the block preconditioner
+  BlockPreconditionerForm block_form = BlockPreconditionerForm::BlockLowerTriangular;
+
+  // Approximate inverse of the diagonal blocks of the block preconditioner
+  BlockInnerSolveType block_inner_solve = BlockInnerSolveType::BlockInnerChebyshev;
+
+  // Number of leading fields of the solve block in the first diagonal block
+  unsigned int block_split = 1;
+
+  // Number of GMRES iterations on the approximate Schur complement
+  unsigned int schur_inner_iterations = 2;
+
+  // How the LHS operator is applied
+  OperatorBackend operator_backend = OperatorBackend::BackendMatrixFree;
+
+  // Whether to sweep candidate preconditioner settings on a representative linear system
+  // and keep the fastest
+  bool autotune = false;
+
+  // Increment whose linear system is used for the autotune sweep
+  unsigned int autotune_increment = 0;
+
+  // Solver types in the autotune sweep. Empty keeps the solver type.
+  std::vector<std::string> autotune_solver_types;
+
+  // Order of the polynomial extrapolation in time of the initial guess. Zero reuses the
+  // previous solution.
+  unsigned int extrapolation_order = 0;
+
+  // Number of previous solutions the initial guess is projected onto. Zero disables the
+  // projection.
+  unsigned int projection_size = 0;
+
   // Solver AdditionalData structures
   dealii::PreconditionChebyshev<>::AdditionalData chebyshev_parameters;
 
@@ -164,11 +227,46 @@ struct NonlinearSolverParameters : public ParameterBase
   // Nonlinear step length
   double step_length = 1.0;
 
+  // Globalization strategy
+  NewtonGlobalization globalization = FixedStep;
+
+  // Factor by which the step size decreases per backtrack
+  double step_size_modifier = 0.5;
+
+  // Sufficient decrease coefficient of the Armijo condition
+  double residual_decrease_coefficient = 1.0e-4;
+
+  // Max number of line search iterations or trust region reductions per Newton step
+  unsigned int max_line_search_iterations = 10;
+
+  // Initial trust region radius. Zero uses the length of the first Newton update.
+  double initial_trust_region_radius = 0.0;
+
   // Max number of iterations for the nonlinear solve
   unsigned int max_iterations = 100;
 
   // Tolerance value for the nonlinear solve
   double tolerance_value = 1.0e-10;
+
+  // Whether to form Jacobian-vector products by finite differences of the residual
+  bool jacobian_free = false;
+
+  // Relative finite difference step for Jacobian-free products. Zero picks sqrt(eps).
+  double finite_difference_step = 0.0;
+
+  // Whether to pick the linear tolerance with Eisenstat-Walker forcing terms
+  bool eisenstat_walker = false;
+
+  // Forcing term of the first Newton iteration
+  double initial_forcing_term = 0.5;
+
+  // Upper bound for the forcing term
+  double max_forcing_term = 0.9;
+
+  // Eisenstat-Walker (choice 2) gamma and alpha parameters
+  double forcing_term_gamma = 0.9;
+
+  double forcing_term_alpha = 2.0;
 };
 
 /**
@@ -201,4 +299,80 @@ struct NonlinearSolveParameters : public ParameterBase
   std::map<Types::Index, NonlinearSolverParameters> nonlinear_solvers;
 };
 
+/**
+ * @brief Struct that stores the parameters of the fixed-point coupling iterations of a
+ * group of solve blocks.
+ */
+struct CouplingParameters : public ParameterBase
+{
+  /**
+   * @brief Declare the parameters to be read from file.
+   */
+  static void
+  declare(dealii::ParameterHandler &parameter_handler,
+          unsigned int              n_subsections = Numbers::default_subsections);
+
+  /**
+   * @brief Assign the parameters from file.
+   */
+  void
+  assign(dealii::ParameterHandler &parameter_handler,
+         unsigned int              n_subsections = Numbers::default_subsections) override;
+
+  /**
+   * @brief Validate.
+   */
+  void
+  validate(const std::vector<FieldAttributes> &field_attributes,
+           const std::vector<SolveBlock>      &solve_blocks) const override;
+
+  // Ids of the coupled solve blocks
+  std::vector<int> solver_ids;
+
+  // Max number of passes over the coupled solve blocks per increment
+  unsigned int max_iterations = 10;
+
+  // Tolerance of the change of the coupled fields over one pass
+  double tolerance = 1.0e-8;
+
+  // Tolerance type
+  SolverToleranceType tolerance_type = SolverToleranceType::AbsoluteResidual;
+
+  // Number of previous iterates of the Anderson acceleration. Zero disables it.
+  unsigned int anderson_depth = 5;
+
+  // Relaxation of the fixed-point update
+  double relaxation = 1.0;
+};
+
+/**
+ * @brief Struct that holds the coupling parameters of the groups of solve blocks.
+ */
+struct CouplingSolveParameters : public ParameterBase
+{
+  /**
+   * @brief Declare the parameters to be read from file.
+   */
+  static void
+  declare(dealii::ParameterHandler &parameter_handler,
+          unsigned int              n_subsections = Numbers::default_subsections);
+
+  /**
+   * @brief Assign the parameters from file.
+   */
+  void
+  assign(dealii::ParameterHandler &parameter_handler,
+         unsigned int              n_subsections = Numbers::default_subsections) override;
+
+  /**
+   * @brief Validate.
+   */
+  void
+  validate(const std::vector<FieldAttributes> &field_attributes,
+           const std::vector<SolveBlock>      &solve_blocks) const override;
+
+  // Coupling groups with at least one solve block
+  std::vector<CouplingParameters> coupling_groups;
+};
+
 PRISMS_PF_END_NAMESPACE
@@ -7,6 +7,7 @@
 
 #include <prismspf/core/conditional_ostreams.h>
 #include <prismspf/core/solve_block.h>
+#include <prismspf/core/type_enums.h>
 
 #include <prismspf/user_inputs/parameter_base.h>
 
@@ -68,6 +69,24 @@ struct TemporalDiscretization : public ParameterBase
 
   // Total number of increments
   unsigned int n_increments = 0;
+
+  // Final time
+  double final_time = 0.0;
+
+  // Use of the estimated maximum stable timestep of explicit solve blocks
+  StableTimestepMode stable_timestep_mode = StableTimestepOff;
+
+  // Fraction of the estimated maximum stable timestep that the timestep is limited to
+  double stable_timestep_safety_factor = 0.8;
+
+  // Number of power iterations of the stable timestep estimate
+  unsigned int stable_timestep_power_iterations = 20;
+
+  // Number of times a failed increment is retried with a smaller timestep
+  unsigned int max_step_retries = 0;
+
+  // Factor that the timestep is multiplied with on each retry
+  double retry_timestep_factor = 0.5;
 };
 
 PRISMS_PF_END_NAMESPACE
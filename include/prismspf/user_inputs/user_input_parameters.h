@@ -63,6 +63,7 @@ struct UserInputParameters : public ParameterBase
 
     LinearSolveParameters::declare(parameter_handler, n_subsections);
     NonlinearSolveParameters::declare(parameter_handler, n_subsections);
+    CouplingSolveParameters::declare(parameter_handler, n_subsections);
 
     FieldOutputParameters::declare(parameter_handler, n_subsections);
     RestartOutputParameters::declare(parameter_handler, n_subsections);
@@ -87,6 +88,7 @@ struct UserInputParameters : public ParameterBase
 
     linear_solve_parameters.assign(parameter_handler, n_subsections);
     nonlinear_solve_parameters.assign(parameter_handler, n_subsections);
+    coupling_solve_parameters.assign(parameter_handler, n_subsections);
 
     const auto n_increments = temporal_discretization.n_increments;
 
@@ -115,6 +117,7 @@ struct UserInputParameters : public ParameterBase
 
     linear_solve_parameters.validate(field_attributes, solve_blocks);
     nonlinear_solve_parameters.validate(field_attributes, solve_blocks);
+    coupling_solve_parameters.validate(field_attributes, solve_blocks);
 
     output_parameters.validate(field_attributes, solve_blocks);
     restart_parameters.validate(field_attributes, solve_blocks);
@@ -130,6 +133,7 @@ struct UserInputParameters : public ParameterBase
 
   LinearSolveParameters    linear_solve_parameters;
   NonlinearSolveParameters nonlinear_solve_parameters;
+  CouplingSolveParameters  coupling_solve_parameters;
 
   FieldOutputParameters   output_parameters;
   RestartOutputParameters restart_parameters;
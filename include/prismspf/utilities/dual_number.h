@@ -0,0 +1,292 @@
+// SPDX-FileCopyrightText: © 2025 PRISMS Center at the University of Michigan
+// SPDX-License-Identifier: GNU Lesser General Public Version 2.1
+
+#pragma once
+
+#include <deal.II/base/vectorization.h>
+
+#include <prismspf/config.h>
+
+#include <cmath>
+#include <type_traits>
+
+PRISMS_PF_BEGIN_NAMESPACE
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes, hicpp-explicit-conversions)
+
+/**
+ * @brief Forward-mode dual number a + b epsilon with epsilon^2 = 0.
+ *
+ * The dual part carries the directional derivative of the value, so evaluating an
+ * expression with dual numbers gives its linearization in the direction of the dual
+ * parts of the inputs. The value type T is a dealii::VectorizedArray or a
+ * dealii::Tensor of them, so the quadrature point batches and the tensor operations of
+ * the equations are reused. Products and quotients with scalar dual numbers follow the
+ * product and quotient rules for any value types whose products are defined.
+ */
+template <typename T>
+struct DualNumber
+{
+  using ValueType = T;
+
+  /**
+   * @brief Constructor.
+   */
+  DualNumber() = default;
+
+  /**
+   * @brief Constructor.
+   */
+  DualNumber(const T &_value, const T &_derivative)
+    : value(_value)
+    , derivative(_derivative)
+  {}
+
+  DualNumber &
+  operator+=(const DualNumber &other)
+  {
+    value += other.value;
+    derivative += other.derivative;
+    return *this;
+  }
+
+  DualNumber &
+  operator-=(const DualNumber &other)
+  {
+    value -= other.value;
+    derivative -= other.derivative;
+    return *this;
+  }
+
+  template <typename Scalar>
+  DualNumber &
+  operator*=(const DualNumber<Scalar> &other)
+  {
+    derivative = derivative * other.value + value * other.derivative;
+    value      = value * other.value;
+    return *this;
+  }
+
+  template <typename Scalar>
+  DualNumber &
+  operator/=(const DualNumber<Scalar> &other)
+  {
+    derivative =
+      (derivative * other.value - value * other.derivative) / (other.value * other.value);
+    value = value / other.value;
+    return *this;
+  }
+
+  /**
+   * @brief Value.
+   */
+  T value;
+
+  /**
+   * @brief Dual part, i.e., the directional derivative of the value.
+   */
+  T derivative;
+};
+
+// NOLINTEND(misc-non-private-member-variables-in-classes, hicpp-explicit-conversions)
+
+/**
+ * @brief Whether a type is a dual number.
+ */
+template <typename T>
+struct IsDualNumber : std::false_type
+{};
+
+template <typename T>
+struct IsDualNumber<DualNumber<T>> : std::true_type
+{};
+
+/**
+ * @brief Types that enter expressions with dual numbers as constants.
+ */
+template <typename T>
+concept NonDual = !IsDualNumber<std::remove_cvref_t<T>>::value;
+
+template <typename A>
+inline DEAL_II_ALWAYS_INLINE DualNumber<A>
+operator-(const DualNumber<A> &a)
+{
+  return DualNumber<A>(-a.value, -a.derivative);
+}
+
+template <typename A, typename B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator+(const DualNumber<A> &a, const DualNumber<B> &b)
+{
+  using Result = decltype(a.value + b.value);
+  return DualNumber<Result>(a.value + b.value, a.derivative + b.derivative);
+}
+
+template <typename A, NonDual B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator+(const DualNumber<A> &a, const B &b)
+{
+  using Result = decltype(a.value + b);
+  return DualNumber<Result>(a.value + b, a.derivative);
+}
+
+template <NonDual B, typename A>
+inline DEAL_II_ALWAYS_INLINE auto
+operator+(const B &b, const DualNumber<A> &a)
+{
+  using Result = decltype(b + a.value);
+  return DualNumber<Result>(b + a.value, a.derivative);
+}
+
+template <typename A, typename B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator-(const DualNumber<A> &a, const DualNumber<B> &b)
+{
+  using Result = decltype(a.value - b.value);
+  return DualNumber<Result>(a.value - b.value, a.derivative - b.derivative);
+}
+
+template <typename A, NonDual B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator-(const DualNumber<A> &a, const B &b)
+{
+  using Result = decltype(a.value - b);
+  return DualNumber<Result>(a.value - b, a.derivative);
+}
+
+template <NonDual B, typename A>
+inline DEAL_II_ALWAYS_INLINE auto
+operator-(const B &b, const DualNumber<A> &a)
+{
+  using Result = decltype(b - a.value);
+  return DualNumber<Result>(b - a.value, -a.derivative);
+}
+
+template <typename A, typename B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator*(const DualNumber<A> &a, const DualNumber<B> &b)
+{
+  using Result = decltype(a.value * b.value);
+  return DualNumber<Result>(a.value * b.value,
+                            (a.derivative * b.value) + (a.value * b.derivative));
+}
+
+template <typename A, NonDual B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator*(const DualNumber<A> &a, const B &b)
+{
+  using Result = decltype(a.value * b);
+  return DualNumber<Result>(a.value * b, a.derivative * b);
+}
+
+template <NonDual B, typename A>
+inline DEAL_II_ALWAYS_INLINE auto
+operator*(const B &b, const DualNumber<A> &a)
+{
+  using Result = decltype(b * a.value);
+  return DualNumber<Result>(b * a.value, b * a.derivative);
+}
+
+template <typename A, typename B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator/(const DualNumber<A> &a, const DualNumber<B> &b)
+{
+  using Result = decltype(a.value / b.value);
+  return DualNumber<Result>(a.value / b.value,
+                            ((a.derivative * b.value) - (a.value * b.derivative)) /
+                              (b.value * b.value));
+}
+
+template <typename A, NonDual B>
+inline DEAL_II_ALWAYS_INLINE auto
+operator/(const DualNumber<A> &a, const B &b)
+{
+  using Result = decltype(a.value / b);
+  return DualNumber<Result>(a.value / b, a.derivative / b);
+}
+
+template <NonDual B, typename A>
+inline DEAL_II_ALWAYS_INLINE auto
+operator/(const B &b, const DualNumber<A> &a)
+{
+  using Result = decltype(b / a.value);
+  return DualNumber<Result>(b / a.value, -b * a.derivative / (a.value * a.value));
+}
+
+/**
+ * @brief Term of the Jacobian product that a linearized RHS term contributes to the LHS.
+ *
+ * The RHS of a newton solve block is the negative residual -R(u) and its LHS is the
+ * Jacobian product dR/du du, so the dual part of an RHS term is negated.
+ */
+template <typename T>
+inline DEAL_II_ALWAYS_INLINE T
+jacobian_term(const DualNumber<T> &rhs_term)
+{
+  return -rhs_term.derivative;
+}
+
+PRISMS_PF_END_NAMESPACE
+
+/**
+ * The elementary functions of scalar dual numbers. Like the operations on
+ * dealii::VectorizedArray in vectorized_operations.h, they are in the std namespace so
+ * that the equations call them the same way for plain and dual values.
+ */
+namespace std
+{
+  // NOLINTBEGIN(cert-dcl58-cpp, readability-identifier-naming,
+  // readability-identifier-length)
+
+  template <typename T>
+  inline ::prismspf::DualNumber<T>
+  sqrt(const ::prismspf::DualNumber<T> &x)
+  {
+    const T root = std::sqrt(x.value);
+    return ::prismspf::DualNumber<T>(root, x.derivative / (T(2.0) * root));
+  }
+
+  template <typename T>
+  inline ::prismspf::DualNumber<T>
+  exp(const ::prismspf::DualNumber<T> &x)
+  {
+    const T exponential = std::exp(x.value);
+    return ::prismspf::DualNumber<T>(exponential, exponential * x.derivative);
+  }
+
+  template <typename T>
+  inline ::prismspf::DualNumber<T>
+  log(const ::prismspf::DualNumber<T> &x)
+  {
+    return ::prismspf::DualNumber<T>(std::log(x.value), x.derivative / x.value);
+  }
+
+  template <typename T, typename Exponent>
+  inline ::prismspf::DualNumber<T>
+  pow(const ::prismspf::DualNumber<T> &x, const Exponent exponent)
+  {
+    return ::prismspf::DualNumber<T>(std::pow(x.value, exponent),
+                                     T(exponent) *
+                                       std::pow(x.value, exponent - Exponent(1)) *
+                                       x.derivative);
+  }
+
+  template <typename T>
+  inline ::prismspf::DualNumber<T>
+  sin(const ::prismspf::DualNumber<T> &x)
+  {
+    return ::prismspf::DualNumber<T>(std::sin(x.value), std::cos(x.value) * x.derivative);
+  }
+
+  template <typename T>
+  inline ::prismspf::DualNumber<T>
+  cos(const ::prismspf::DualNumber<T> &x)
+  {
+    return ::prismspf::DualNumber<T>(std::cos(x.value),
+                                     -std::sin(x.value) * x.derivative);
+  }
+
+  // NOLINTEND(cert-dcl58-cpp, readability-identifier-naming,
+  // readability-identifier-length)
+
+} // namespace std
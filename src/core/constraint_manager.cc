@@ -4,18 +4,19 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/function.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/component_mask.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/lac/affine_constraints.h>
-#include <deal.II/numerics/vector_tools_boundary.h>
 
 #include <prismspf/core/constraint_manager.h>
-#include <prismspf/core/dirichlet.h>
 #include <prismspf/core/dof_manager.h>
 #include <prismspf/core/exceptions.h>
 #include <prismspf/core/field_attributes.h>
+#include <prismspf/core/pde_operator_base.h>
 #include <prismspf/core/system_wide.h>
 #include <prismspf/core/type_enums.h>
 
@@ -24,6 +25,9 @@
 
 #include <prismspf/config.h>
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -40,13 +44,11 @@ ConstraintManager<dim, degree, number>::init(
   const PDEOperatorBase<dim, degree, number> &_pde_operator,
   const SimulationTimer                      &_sim_timer)
 {
-  boundary_parameters     = &_boundary_parameters;
-  spatial_discretization  = &_spatial_discretization;
-  dof_manager             = &_dof_manager;
-  pde_operator            = &_pde_operator;
-  sim_timer               = &_sim_timer;
-  unsigned int num_levels = dof_manager->has_mg() ? dof_manager->num_levels() : 0;
-  mg_generic_constraints.resize(num_levels);
+  boundary_parameters    = &_boundary_parameters;
+  spatial_discretization = &_spatial_discretization;
+  dof_manager            = &_dof_manager;
+  pde_operator           = &_pde_operator;
+  sim_timer              = &_sim_timer;
 }
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -143,6 +145,12 @@ ConstraintManager<dim, degree, number>::reinit(
   const std::vector<FieldAttributes> &field_attributes)
 {
   field_constraints.resize(field_attributes.size());
+  dirichlet_dofs.resize(field_attributes.size());
+  structural_constraints.resize(field_attributes.size());
+  inhomogeneity_only.assign(field_attributes.size(), true);
+  // The number of multigrid levels follows the coarsening sequence of the current mesh,
+  // so it can change with every refinement.
+  mg_generic_constraints.resize(dof_manager->num_levels());
   mg_field_constraints.resize(mg_generic_constraints.size());
   for (auto &constraint_level : mg_field_constraints)
     {
@@ -175,18 +183,18 @@ ConstraintManager<dim, degree, number>::reinit(
            relative_level < mg_generic_constraints.size();
            ++relative_level)
         {
+          const dealii::DoFHandler<dim> &mg_dof_handler =
+            dof_manager->get_mg_dof_handlers(relative_level).at(rank);
           dealii::AffineConstraints<number> &generic_constraint =
             mg_generic_constraints[relative_level].at(rank);
 
           generic_constraint.clear();
           // reinit
-          const unsigned int fine_level = dof_handler.get_triangulation().n_levels() - 1;
-          const unsigned int level      = fine_level - relative_level;
-          generic_constraint.reinit(
-            dof_handler.locally_owned_mg_dofs(level),
-            dealii::DoFTools::extract_locally_relevant_level_dofs(dof_handler, level));
+          generic_constraint.reinit(mg_dof_handler.locally_owned_dofs(),
+                                    dealii::DoFTools::extract_locally_relevant_dofs(
+                                      mg_dof_handler));
           // periodicity
-          spatial_discretization->mark_periodic(dof_handler, generic_constraint);
+          spatial_discretization->mark_periodic(mg_dof_handler, generic_constraint);
 
           // hanging node
           // dealii::DoFTools::make_hanging_node_constraints(dof_handler,
@@ -220,7 +228,7 @@ ConstraintManager<dim, degree, number>::reinit(
 
           make_constraints_for_single_field(
             constraint,
-            dof_handler,
+            dof_manager->get_mg_field_dof_handler(field_index, relative_level),
             field_attributes[field_index].boundary_conditions,
             field_attributes[field_index].field_type,
             field_index,
@@ -262,21 +270,12 @@ ConstraintManager<dim, degree, number>::make_constraints_for_single_field(
   Types::Index                       field_index,
   unsigned int                       relative_level)
 {
-  // 0. Reinitialize constraint with the correct dof numbering
+  // 0. Reinitialize constraint with the correct dof numbering. The multigrid levels
+  // have their own DoFHandlers on the coarsened triangulations, so they are numbered
+  // like the active level.
   constraint.clear();
-  if (relative_level == -1)
-    {
-      constraint.reinit(dof_handler.locally_owned_dofs(),
-                        dealii::DoFTools::extract_locally_relevant_dofs(dof_handler));
-    }
-  else
-    {
-      const unsigned int fine_level = dof_handler.get_triangulation().n_levels() - 1;
-      const unsigned int level      = fine_level - relative_level;
-      constraint.reinit(dof_handler.locally_owned_mg_dofs(level),
-                        dealii::DoFTools::extract_locally_relevant_level_dofs(dof_handler,
-                                                                              level));
-    }
+  constraint.reinit(dof_handler.locally_owned_dofs(),
+                    dealii::DoFTools::extract_locally_relevant_dofs(dof_handler));
 
   // 1. Make periodicity constraints. Note, this *does* have to be done to both the
   // triangulation and the constraints. Adding periodicity to the triangulation alone
@@ -284,22 +283,182 @@ ConstraintManager<dim, degree, number>::make_constraints_for_single_field(
   // right ghosts. The constraints have to be applied separately.
   spatial_discretization->mark_periodic(dof_handler, constraint);
 
-  // 2. Make hanging node constraints
-  // note: dealii step-37 doesn't add hanging node constraints. (probably because a single
-  // level doesn't have hanging nodes)
+  // 2. Make hanging node constraints. The coarsened triangulations of a locally refined
+  // mesh have hanging nodes too.
+  dealii::DoFTools::make_hanging_node_constraints(dof_handler, constraint);
+
+  // 3. Make boundary constraints. On the active level we cache the Dirichlet DoFs so
+  // time-dependent updates don't have to rebuild the constraints. The multigrid levels
+  // only need the homogeneous constraints.
   if (relative_level == -1)
     {
-      dealii::DoFTools::make_hanging_node_constraints(dof_handler, constraint);
+      make_dirichlet_dof_cache(constraint,
+                               dof_handler,
+                               _field_constraints,
+                               tensor_rank,
+                               field_index);
+      if (_field_constraints.time_dependent)
+        {
+          structural_constraints[field_index].copy_from(constraint);
+        }
+      else
+        {
+          structural_constraints[field_index].clear();
+        }
+      set_dirichlet_values(constraint, tensor_rank, field_index, true);
+    }
+  else
+    {
+      make_bc_constraints(constraint, dof_handler, _field_constraints, tensor_rank);
     }
 
-  // 3. Make boundary constraints
-  make_bc_constraints(constraint,
-                      dof_handler,
-                      _field_constraints,
-                      tensor_rank,
-                      field_index);
-
   constraint.close();
+
+  // The level constraints are never updated with the time-dependent Dirichlet values,
+  // which is only correct because they are homogeneous
+  Assert(relative_level == -1 || !constraint.has_inhomogeneities(),
+         dealii::ExcMessage("The multigrid level constraints must be homogeneous"));
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+ConstraintManager<dim, degree, number>::make_dirichlet_dof_cache(
+  const dealii::AffineConstraints<number> &structural_constraint,
+  const dealii::DoFHandler<dim>           &dof_handler,
+  const BoundaryConditionSet              &boundary_condition,
+  const TensorRank                         tensor_rank,
+  Types::Index                             field_index)
+{
+  const bool is_vector_field = tensor_rank == TensorRank::Vector;
+
+  std::vector<DirichletDoFs> &field_dirichlet_dofs = dirichlet_dofs[field_index];
+  field_dirichlet_dofs.clear();
+
+  std::map<dealii::types::global_dof_index, dealii::Point<dim>> support_points;
+  std::set<dealii::types::global_dof_index>                     claimed_dofs;
+  for (const auto &[comp, comp_bcs] : boundary_condition.component_constraints)
+    {
+      if (comp >= dim)
+        {
+          continue;
+        }
+      for (const auto &[boundary_id, boundary_type] : comp_bcs)
+        {
+          Assert(boundary_type != Condition::Neumann,
+                 FeatureNotImplemented("Neumann boundary conditions"));
+          if (boundary_type != Condition::Dirichlet)
+            {
+              continue;
+            }
+          if (support_points.empty())
+            {
+              dealii::DoFTools::map_dofs_to_support_points(SystemWide<dim, degree>::mapping,
+                                                           dof_handler,
+                                                           support_points);
+            }
+
+          const dealii::ComponentMask mask =
+            is_vector_field ? vector_component_mask.at(comp) : scalar_empty_mask;
+          const dealii::IndexSet boundary_dofs =
+            dealii::DoFTools::extract_boundary_dofs(dof_handler,
+                                                    mask,
+                                                    {static_cast<dealii::types::boundary_id>(
+                                                      boundary_id)});
+
+          DirichletDoFs entry;
+          entry.boundary_id = boundary_id;
+          entry.component   = is_vector_field ? comp : 0;
+          for (const auto dof : boundary_dofs)
+            {
+              if (!structural_constraint.can_store_line(dof) ||
+                  structural_constraint.is_constrained(dof) ||
+                  !claimed_dofs.insert(dof).second)
+                {
+                  continue;
+                }
+              const auto point = support_points.find(dof);
+              Assert(point != support_points.end(),
+                     dealii::ExcMessage("Missing support point for a Dirichlet DoF"));
+              entry.dof_indices.push_back(dof);
+              entry.support_points.push_back(point->second);
+            }
+          if (!entry.dof_indices.empty())
+            {
+              field_dirichlet_dofs.push_back(std::move(entry));
+            }
+        }
+    }
+
+  // If a periodic or hanging node constraint refers to a Dirichlet DoF, close() folds the
+  // Dirichlet value into that line, so overwriting the Dirichlet inhomogeneities alone
+  // would leave it stale.
+  inhomogeneity_only[field_index] = true;
+  for (const auto &line : structural_constraint.get_lines())
+    {
+      for (const auto &[dof, weight] : line.entries)
+        {
+          if (claimed_dofs.contains(dof))
+            {
+              inhomogeneity_only[field_index] = false;
+              return;
+            }
+        }
+    }
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+ConstraintManager<dim, degree, number>::set_dirichlet_values(
+  dealii::AffineConstraints<number> &constraint,
+  const TensorRank                   tensor_rank,
+  Types::Index                       field_index,
+  bool                               add_lines) const
+{
+  using SizeType = dealii::VectorizedArray<number>;
+
+  const bool is_vector_field = tensor_rank == TensorRank::Vector;
+  for (const DirichletDoFs &entry : dirichlet_dofs[field_index])
+    {
+      const unsigned int n_dofs = entry.dof_indices.size();
+      for (unsigned int start = 0; start < n_dofs; start += SizeType::size())
+        {
+          const unsigned int n_lanes =
+            std::min<unsigned int>(SizeType::size(), n_dofs - start);
+
+          // Unused lanes repeat the last point
+          dealii::Point<dim, SizeType> points;
+          for (unsigned int lane = 0; lane < SizeType::size(); ++lane)
+            {
+              const dealii::Point<dim> &point =
+                entry.support_points[start + std::min(lane, n_lanes - 1)];
+              for (unsigned int d = 0; d < dim; ++d)
+                {
+                  points[d][lane] = point[d];
+                }
+            }
+
+          SizeType scalar_value           = 0.0;
+          SizeType vector_component_value = 0.0;
+          pde_operator->set_vectorized_dirichlet(field_index,
+                                                 entry.boundary_id,
+                                                 entry.component,
+                                                 points,
+                                                 *sim_timer,
+                                                 scalar_value,
+                                                 vector_component_value);
+          const SizeType &value = is_vector_field ? vector_component_value : scalar_value;
+
+          for (unsigned int lane = 0; lane < n_lanes; ++lane)
+            {
+              const dealii::types::global_dof_index dof = entry.dof_indices[start + lane];
+              if (add_lines)
+                {
+                  constraint.add_line(dof);
+                }
+              constraint.set_inhomogeneity(dof, value[lane]);
+            }
+        }
+    }
 }
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -308,8 +467,7 @@ ConstraintManager<dim, degree, number>::make_bc_constraints(
   dealii::AffineConstraints<number> &constraint,
   const dealii::DoFHandler<dim>     &dof_handler,
   const BoundaryConditionSet        &boundary_condition,
-  const TensorRank                   tensor_rank,
-  Types::Index                       field_index)
+  const TensorRank                   tensor_rank)
 {
   for (const auto &[comp, comp_bcs] : boundary_condition.component_constraints)
     {
@@ -324,8 +482,7 @@ ConstraintManager<dim, degree, number>::make_bc_constraints(
                                        comp,
                                        boundary_type,
                                        dof_handler,
-                                       tensor_rank,
-                                       field_index);
+                                       tensor_rank);
         }
     }
 }
@@ -338,8 +495,7 @@ ConstraintManager<dim, degree, number>::make_one_boundary_constraint(
   unsigned int                       component,
   Condition                          boundary_type,
   const dealii::DoFHandler<dim>     &dof_handler,
-  TensorRank                         tensor_rank,
-  Types::Index                       field_index) const
+  TensorRank                         tensor_rank) const
 {
   const bool                  is_vector_field = tensor_rank == TensorRank::Vector;
   const dealii::ComponentMask mask =
@@ -356,12 +512,7 @@ ConstraintManager<dim, degree, number>::make_one_boundary_constraint(
         }
       case Condition::Dirichlet:
         {
-          make_dirichlet_constraints(_constraints,
-                                     dof_handler,
-                                     boundary_id,
-                                     field_index,
-                                     is_vector_field,
-                                     mask);
+          make_zero_dirichlet_constraints(_constraints, dof_handler, boundary_id, mask);
           break;
         }
       case Condition::Neumann:
@@ -384,62 +535,35 @@ ConstraintManager<dim, degree, number>::update_time_dependent_constraints(
   for (unsigned int field_index = 0; field_index < field_attributes.size(); field_index++)
     {
       const FieldAttributes &field = field_attributes[field_index];
-      if (field.boundary_conditions.time_dependent)
+      if (!field.boundary_conditions.time_dependent)
         {
-          const dealii::DoFHandler<dim> &dof_handler =
-            dof_manager->get_field_dof_handler(field_index);
-          {
-            dealii::AffineConstraints<number> &constraint =
-              field_constraints[field_index];
-            constraint.clear();
-
-            make_constraints_for_single_field(constraint,
-                                              dof_handler,
-                                              field.boundary_conditions,
-                                              field.field_type,
-                                              field_index,
-                                              -1);
-            constraint.close();
-          }
-          for (unsigned int relative_level = 0;
-               relative_level < mg_field_constraints.size();
-               ++relative_level)
-            {
-              dealii::AffineConstraints<number> &constraint =
-                mg_field_constraints[relative_level][field_index];
-              constraint.clear();
-
-              make_constraints_for_single_field(constraint,
-                                                dof_handler,
-                                                field.boundary_conditions,
-                                                field.field_type,
-                                                field_index,
-                                                relative_level);
-              constraint.close();
-            }
+          continue;
+        }
+      dealii::AffineConstraints<number> &constraint = field_constraints[field_index];
+      if (inhomogeneity_only[field_index])
+        {
+          set_dirichlet_values(constraint, field.field_type, field_index, false);
+        }
+      else
+        {
+          constraint.copy_from(structural_constraints[field_index]);
+          set_dirichlet_values(constraint, field.field_type, field_index, true);
+          constraint.close();
         }
     }
 }
 
 template <unsigned int dim, unsigned int degree, typename number>
 void
-ConstraintManager<dim, degree, number>::make_dirichlet_constraints(
+ConstraintManager<dim, degree, number>::make_zero_dirichlet_constraints(
   dealii::AffineConstraints<number> &_constraints,
   const dealii::DoFHandler<dim>     &dof_handler,
   const unsigned int                &boundary_id,
-  const unsigned int                &field_index,
-  const bool                        &is_vector_field,
   const dealii::ComponentMask       &mask) const
 {
-  dealii::VectorTools::interpolate_boundary_values(
-    SystemWide<dim, degree>::mapping,
+  dealii::DoFTools::make_zero_boundary_constraints(
     dof_handler,
-    boundary_id,
-    DirichletConditions<dim, degree, number>(field_index,
-                                             boundary_id,
-                                             *pde_operator,
-                                             *sim_timer,
-                                             is_vector_field ? dim : 1),
+    static_cast<dealii::types::boundary_id>(boundary_id),
     _constraints,
     mask);
 }
@@ -21,11 +21,59 @@ DoFManager<dim, degree>::reinit(const TriangulationManager<dim> &triangulation_m
       dealii::DoFHandler<dim> &dof_handler = level_dof_handlers.at(rank);
       dof_handler.reinit(triangulation_manager.get_triangulation());
       dof_handler.distribute_dofs(SystemWide<dim, degree>::fe_systems.at(rank));
-      if (init_mg)
+    }
+
+  // Multigrid levels live on the coarsened triangulations, so they are regular active
+  // DoFHandlers and work with hanging nodes in the same way as the active mesh.
+  // Relative level 0 is the active mesh itself. With p-coarsening, the linear elements
+  // on the active mesh are inserted as relative level 1, so the coarsened triangulations
+  // are shifted down by one level.
+  clear_mg();
+  if (init_mg)
+    {
+      const unsigned int n_p_levels = p_coarsening ? 1 : 0;
+      const unsigned int n_levels   = triangulation_manager.num_levels() + n_p_levels;
+      mg_dof_handlers.resize(n_levels);
+      for (unsigned int relative_level = 1; relative_level < n_levels; ++relative_level)
         {
-          dof_handler.distribute_mg_dofs();
+          mg_dof_handlers[relative_level] =
+            std::make_unique<std::array<dealii::DoFHandler<dim>, 2>>();
+          for (unsigned int rank = 0; rank < 2; ++rank)
+            {
+              dealii::DoFHandler<dim> &dof_handler =
+                mg_dof_handlers[relative_level]->at(rank);
+              dof_handler.reinit(
+                triangulation_manager.get_triangulation(relative_level - n_p_levels));
+              if (p_coarsening)
+                {
+                  dof_handler.distribute_dofs(SystemWide<dim, 1>::fe_systems.at(rank));
+                }
+              else
+                {
+                  dof_handler.distribute_dofs(
+                    SystemWide<dim, degree>::fe_systems.at(rank));
+                }
+            }
         }
     }
+  reinit_mg_mapping();
+}
+
+template <unsigned int dim, unsigned int degree>
+void
+DoFManager<dim, degree>::set_p_coarsening(bool _p_coarsening)
+{
+  AssertThrow(!_p_coarsening || degree > 1,
+              dealii::ExcMessage("p-multigrid requires an element degree above one"));
+  p_coarsening = _p_coarsening;
+}
+
+template <unsigned int dim, unsigned int degree>
+void
+DoFManager<dim, degree>::clear_mg()
+{
+  mg_field_dof_handlers.clear();
+  mg_dof_handlers.clear();
 }
 
 template <unsigned int dim, unsigned int degree>
@@ -34,10 +82,33 @@ DoFManager<dim, degree>::reinit_mapping(
   const std::vector<FieldAttributes> &field_attributes)
 {
   field_dof_handlers.resize(field_attributes.size(), nullptr);
+  field_ranks.resize(field_attributes.size());
   for (unsigned int field_index = 0; field_index < field_attributes.size(); ++field_index)
     {
-      field_dof_handlers[field_index] = &(level_dof_handlers.at(
-        static_cast<unsigned int>(field_attributes[field_index].field_type)));
+      field_ranks[field_index] =
+        static_cast<unsigned int>(field_attributes[field_index].field_type);
+      field_dof_handlers[field_index] =
+        &(level_dof_handlers.at(field_ranks[field_index]));
+    }
+  reinit_mg_mapping();
+}
+
+template <unsigned int dim, unsigned int degree>
+void
+DoFManager<dim, degree>::reinit_mg_mapping()
+{
+  mg_field_dof_handlers.resize(mg_dof_handlers.size());
+  for (unsigned int relative_level = 0; relative_level < mg_dof_handlers.size();
+       ++relative_level)
+    {
+      const std::array<dealii::DoFHandler<dim>, 2> &dof_handlers =
+        get_mg_dof_handlers(relative_level);
+      mg_field_dof_handlers[relative_level].resize(field_ranks.size(), nullptr);
+      for (unsigned int field_index = 0; field_index < field_ranks.size(); ++field_index)
+        {
+          mg_field_dof_handlers[relative_level][field_index] =
+            &(dof_handlers.at(field_ranks[field_index]));
+        }
     }
 }
 
@@ -83,18 +154,62 @@ DoFManager<dim, degree>::get_dof_handler(const unsigned int &rank) const
   return level_dof_handlers.at(rank);
 }
 
+template <unsigned int dim, unsigned int degree>
+const std::vector<const dealii::DoFHandler<dim> *> &
+DoFManager<dim, degree>::get_mg_field_dof_handlers(unsigned int relative_level) const
+{
+  Assert(relative_level < mg_field_dof_handlers.size(),
+         dealii::ExcIndexRange(relative_level, 0, mg_field_dof_handlers.size()));
+  return mg_field_dof_handlers[relative_level];
+}
+
+template <unsigned int dim, unsigned int degree>
+const dealii::DoFHandler<dim> &
+DoFManager<dim, degree>::get_mg_field_dof_handler(Types::Index field_index,
+                                                  unsigned int relative_level) const
+{
+  return *get_mg_field_dof_handlers(relative_level)[field_index];
+}
+
+template <unsigned int dim, unsigned int degree>
+const std::array<dealii::DoFHandler<dim>, 2> &
+DoFManager<dim, degree>::get_mg_dof_handlers(unsigned int relative_level) const
+{
+  Assert(relative_level < mg_dof_handlers.size(),
+         dealii::ExcIndexRange(relative_level, 0, mg_dof_handlers.size()));
+  if (relative_level == 0)
+    {
+      return level_dof_handlers;
+    }
+  return *mg_dof_handlers[relative_level];
+}
+
 template <unsigned int dim, unsigned int degree>
 bool
 DoFManager<dim, degree>::has_mg() const
 {
-  return level_dof_handlers[0].has_level_dofs();
+  return !mg_dof_handlers.empty();
 }
 
 template <unsigned int dim, unsigned int degree>
 unsigned int
 DoFManager<dim, degree>::num_levels() const
 {
-  return level_dof_handlers[0].get_triangulation().n_levels();
+  return mg_dof_handlers.size();
+}
+
+template <unsigned int dim, unsigned int degree>
+bool
+DoFManager<dim, degree>::has_p_coarsening() const
+{
+  return p_coarsening;
+}
+
+template <unsigned int dim, unsigned int degree>
+unsigned int
+DoFManager<dim, degree>::get_mg_degree(unsigned int relative_level) const
+{
+  return p_coarsening && relative_level > 0 ? 1 : degree;
 }
 
 template <unsigned int dim, unsigned int degree>
@@ -64,6 +64,21 @@ FieldContainer<dim, degree, number>::FieldContainer(
     }
 }
 
+template <unsigned int dim, unsigned int degree, typename number>
+void
+FieldContainer<dim, degree, number>::set_linearize(bool _linearize)
+{
+  linearize = _linearize;
+  linearized_fields.assign(field_attributes_ptr->size(), false);
+  if (linearize)
+    {
+      for (const unsigned int field_index : solve_block->field_indices)
+        {
+          linearized_fields[field_index] = true;
+        }
+    }
+}
+
 #include "core/field_container.inst"
 
 PRISMS_PF_END_NAMESPACE
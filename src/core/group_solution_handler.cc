@@ -101,6 +101,16 @@ GroupSolutionHandler<dim, number>::get_old_solution_vector(
   return primary_solutions.old_solutions[age].block(global_to_block_index[global_index]);
 }
 
+template <unsigned int dim, typename number>
+auto
+GroupSolutionHandler<dim, number>::get_stage_vector(unsigned int stage)
+  -> BlockVector<number> &
+{
+  Assert(stage < stage_solutions.size(),
+         dealii::ExcIndexRange(stage, 0, stage_solutions.size()));
+  return stage_solutions[stage];
+}
+
 template <unsigned int dim, typename number>
 SolutionLevel<dim, number> &
 GroupSolutionHandler<dim, number>::get_primary_solutions()
@@ -215,6 +225,11 @@ GroupSolutionHandler<dim, number>::reinit()
         old_solution.reinit(partitioners);
         old_solution.collect_sizes();
       }
+    for (BlockVector<number> &stage_solution : stage_solutions)
+      {
+        stage_solution.reinit(partitioners);
+        stage_solution.collect_sizes();
+      }
   }
   for (unsigned int relative_level = 0; relative_level < solution_levels.size();
        ++relative_level)
@@ -256,6 +271,10 @@ template <unsigned int dim, typename number>
 void
 GroupSolutionHandler<dim, number>::prepare_for_solution_transfer()
 {
+  // The multigrid levels are rebuilt after refinement, so drop the transfers that refer
+  // to the old ones.
+  clear_mg_transfer();
+
   unsigned int num_blocks = solve_block.field_indices.size();
 
   for (unsigned int block_index = 0; block_index < num_blocks; block_index++)
@@ -294,6 +313,17 @@ GroupSolutionHandler<dim, number>::execute_solution_transfer()
   apply_constraints_to_all();
 }
 
+template <unsigned int dim, typename number>
+void
+GroupSolutionHandler<dim, number>::init_stage_vectors(unsigned int n_stages)
+{
+  stage_solutions.resize(n_stages);
+  for (BlockVector<number> &stage_solution : stage_solutions)
+    {
+      stage_solution.reinit(primary_solutions.solutions, true);
+    }
+}
+
 // TODO (fractalsbyx): Check if this is necessary for all solutions
 template <unsigned int dim, typename number>
 void
@@ -403,6 +433,101 @@ GroupSolutionHandler<dim, number>::update()
     }
 }
 
+template <unsigned int dim, typename number>
+void
+GroupSolutionHandler<dim, number>::save_snapshot()
+{
+  // Assignment reuses the memory of the previous snapshot on the same mesh
+  snapshot.resize(1 + solution_levels.size());
+  snapshot[0].solutions     = primary_solutions.solutions;
+  snapshot[0].old_solutions = primary_solutions.old_solutions;
+  for (unsigned int level = 0; level < solution_levels.size(); ++level)
+    {
+      snapshot[level + 1].solutions     = solution_levels[level].solutions;
+      snapshot[level + 1].old_solutions = solution_levels[level].old_solutions;
+    }
+}
+
+template <unsigned int dim, typename number>
+void
+GroupSolutionHandler<dim, number>::restore_snapshot()
+{
+  Assert(snapshot.size() == 1 + solution_levels.size(),
+         dealii::ExcMessage("No snapshot was saved on the current mesh."));
+  const auto swap_level = [](SolutionLevel<dim, number> &level,
+                             SolutionLevel<dim, number> &saved_level)
+  {
+    level.solutions.swap(saved_level.solutions);
+    for (unsigned int age = 0; age < level.old_solutions.size(); ++age)
+      {
+        level.old_solutions[age].swap(saved_level.old_solutions[age]);
+      }
+  };
+  swap_level(primary_solutions, snapshot[0]);
+  for (unsigned int level = 0; level < solution_levels.size(); ++level)
+    {
+      swap_level(solution_levels[level], snapshot[level + 1]);
+    }
+  update_ghosts();
+}
+
+template <unsigned int dim, typename number>
+void
+GroupSolutionHandler<dim, number>::begin_substeps()
+{
+  substep_start.clear();
+  if (!primary_solutions.old_solutions.empty())
+    {
+      substep_start.push_back(primary_solutions.old_solutions[0]);
+    }
+  for (const auto &solution_level : solution_levels)
+    {
+      if (!solution_level.old_solutions.empty())
+        {
+          substep_start.push_back(solution_level.old_solutions[0]);
+        }
+    }
+}
+
+template <unsigned int dim, typename number>
+void
+GroupSolutionHandler<dim, number>::advance_substep()
+{
+  if (!primary_solutions.old_solutions.empty())
+    {
+      primary_solutions.old_solutions[0] = primary_solutions.solutions;
+    }
+  for (auto &solution_level : solution_levels)
+    {
+      if (!solution_level.old_solutions.empty())
+        {
+          solution_level.old_solutions[0] = solution_level.solutions;
+        }
+    }
+  update_ghosts();
+}
+
+template <unsigned int dim, typename number>
+void
+GroupSolutionHandler<dim, number>::end_substeps()
+{
+  // Same order as in begin_substeps()
+  auto start = substep_start.begin();
+  if (!primary_solutions.old_solutions.empty())
+    {
+      primary_solutions.old_solutions[0].swap(*start++);
+    }
+  for (auto &solution_level : solution_levels)
+    {
+      if (!solution_level.old_solutions.empty())
+        {
+          solution_level.old_solutions[0].swap(*start++);
+        }
+    }
+  substep_start.clear();
+  update_ghosts();
+}
+
 template <unsigned int dim, typename number>
 void
 GroupSolutionHandler<dim, number>::print_solution_full_vector(std::ostream &out) const
@@ -3,19 +3,28 @@
 
 #include <deal.II/base/function.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/filtered_iterator.h>
+#include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/vector.h>
 
 #include <prismspf/core/initial_conditions.h>
 #include <prismspf/core/pde_operator_base.h>
+#include <prismspf/core/system_wide.h>
 #include <prismspf/core/type_enums.h>
 
 #include <prismspf/field_input/read_field_factory.h>
 
 #include <prismspf/config.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 PRISMS_PF_BEGIN_NAMESPACE
 
@@ -65,6 +74,178 @@ InitialCondition<dim, degree, number>::vector_value(const dealii::Point<dim> &p,
 
 // NOLINTEND(readability-identifier-length)
 
+template <unsigned int dim, unsigned int degree, typename number>
+VectorizedInitialCondition<dim, degree, number>::VectorizedInitialCondition(
+  const unsigned int                         &_index,
+  const TensorRank                           &_field_type,
+  const PDEOperatorBase<dim, degree, number> &_pde_operator)
+  : index(_index)
+  , field_type(_field_type)
+  , pde_operator(&_pde_operator)
+{}
+
+namespace
+{
+  /**
+   * @brief Per-thread scratch for VectorizedInitialCondition.
+   */
+  template <unsigned int dim>
+  struct InitialConditionScratch
+  {
+    InitialConditionScratch(const dealii::Mapping<dim>       &mapping,
+                            const dealii::FiniteElement<dim> &fe,
+                            const dealii::Quadrature<dim>    &support_points)
+      : fe_values(mapping, fe, support_points, dealii::update_quadrature_points)
+    {}
+
+    InitialConditionScratch(const InitialConditionScratch &other)
+      : fe_values(other.fe_values.get_mapping(),
+                  other.fe_values.get_fe(),
+                  other.fe_values.get_quadrature(),
+                  other.fe_values.get_update_flags())
+    {}
+
+    dealii::FEValues<dim> fe_values;
+  };
+
+  /**
+   * @brief Per-cell values for VectorizedInitialCondition.
+   */
+  template <typename number>
+  struct InitialConditionCopy
+  {
+    std::vector<dealii::types::global_dof_index> dof_indices;
+    std::vector<number>                          values;
+  };
+} // namespace
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+VectorizedInitialCondition<dim, degree, number>::interpolate(
+  const dealii::DoFHandler<dim>                     &dof_handler,
+  dealii::LinearAlgebra::distributed::Vector<number> &dst) const
+{
+  using SizeType = dealii::VectorizedArray<number>;
+
+  const unsigned int n_components = (field_type == TensorRank::Vector) ? dim : 1;
+  const auto        &fe           = dof_handler.get_fe();
+  const auto        &support_points =
+    SystemWide<dim, degree>::get_support_point_quadrature();
+  const unsigned int n_support_points = support_points.size();
+  Assert(fe.n_dofs_per_cell() == n_components * n_support_points,
+         dealii::ExcMessage("The FE of the dof handler does not match SystemWide"));
+  const bool vectorized = pde_operator->has_vectorized_initial_condition(index);
+
+  auto worker = [&](const typename dealii::DoFHandler<dim>::active_cell_iterator &cell,
+                    InitialConditionScratch<dim>                                 &scratch,
+                    InitialConditionCopy<number>                                 &copy)
+  {
+    scratch.fe_values.reinit(cell);
+    const std::vector<dealii::Point<dim>> &q_points =
+      scratch.fe_values.get_quadrature_points();
+
+    copy.dof_indices.resize(fe.n_dofs_per_cell());
+    copy.values.resize(fe.n_dofs_per_cell());
+    cell->get_dof_indices(copy.dof_indices);
+
+    // Pointwise initial conditions are evaluated one support point at a time
+    if (!vectorized)
+      {
+        for (unsigned int q = 0; q < n_support_points; ++q)
+          {
+            for (unsigned int component = 0; component < n_components; ++component)
+              {
+                number scalar_value           = 0.0;
+                number vector_component_value = 0.0;
+                pde_operator->set_initial_condition(index,
+                                                    component,
+                                                    q_points[q],
+                                                    scalar_value,
+                                                    vector_component_value);
+                copy.values[fe.component_to_system_index(component, q)] =
+                  field_type == TensorRank::Vector ? vector_component_value
+                                                   : scalar_value;
+              }
+          }
+        return;
+      }
+
+    for (unsigned int start = 0; start < n_support_points; start += SizeType::size())
+      {
+        const unsigned int n_lanes =
+          std::min<unsigned int>(SizeType::size(), n_support_points - start);
+
+        // Pack the support points. Unused lanes repeat the last point so the user
+        // function is never evaluated somewhere arbitrary.
+        dealii::Point<dim, SizeType> points;
+        for (unsigned int lane = 0; lane < SizeType::size(); ++lane)
+          {
+            const unsigned int q = start + std::min(lane, n_lanes - 1);
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                points[d][lane] = q_points[q][d];
+              }
+          }
+
+        for (unsigned int component = 0; component < n_components; ++component)
+          {
+            SizeType scalar_value           = 0.0;
+            SizeType vector_component_value = 0.0;
+            pde_operator->set_vectorized_initial_condition(index,
+                                                           component,
+                                                           points,
+                                                           scalar_value,
+                                                           vector_component_value);
+            const SizeType &value =
+              field_type == TensorRank::Vector ? vector_component_value : scalar_value;
+            for (unsigned int lane = 0; lane < n_lanes; ++lane)
+              {
+                copy.values[fe.component_to_system_index(component, start + lane)] =
+                  value[lane];
+              }
+          }
+      }
+  };
+
+  auto copier = [&](const InitialConditionCopy<number> &copy)
+  {
+    for (unsigned int i = 0; i < copy.dof_indices.size(); ++i)
+      {
+        if (dst.in_local_range(copy.dof_indices[i]))
+          {
+            dst(copy.dof_indices[i]) = copy.values[i];
+          }
+      }
+  };
+
+  // Pointwise initial conditions may use shared state, e.g., a random number generator,
+  // so they are evaluated on a single thread in the order of the cells
+  if (!vectorized)
+    {
+      InitialConditionScratch<dim> scratch(SystemWide<dim, degree>::mapping,
+                                           fe,
+                                           support_points);
+      InitialConditionCopy<number> copy;
+      for (const auto &cell : dof_handler.active_cell_iterators())
+        {
+          if (cell->is_locally_owned())
+            {
+              worker(cell, scratch, copy);
+              copier(copy);
+            }
+        }
+      return;
+    }
+
+  dealii::WorkStream::run(
+    dealii::filter_iterators(dof_handler.active_cell_iterators(),
+                             dealii::IteratorFilters::LocallyOwnedCell()),
+    worker,
+    copier,
+    InitialConditionScratch<dim>(SystemWide<dim, degree>::mapping, fe, support_points),
+    InitialConditionCopy<number>());
+}
+
 template <unsigned int dim, typename number>
 ReadInitialCondition<dim, number>::ReadInitialCondition(
   std::string                       _field_name,
@@ -14,13 +14,18 @@
 #include <prismspf/core/timer.h>
 #include <prismspf/core/triangulation_manager.h>
 
+#include <prismspf/solvers/anderson_acceleration.h>
 #include <prismspf/solvers/solver_base.h>
 #include <prismspf/solvers/solvers.h>
 
 #include <prismspf/user_inputs/user_input_parameters.h>
 
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
 
 PRISMS_PF_BEGIN_NAMESPACE
 
@@ -133,7 +138,8 @@ Problem<dim, degree, number>::Problem(
   const std::vector<SolveBlock>        &_solve_blocks,
   const UserInputParameters<dim>       &_user_inputs,
   PhaseFieldTools<dim>                 &_pf_tools,
-  PDEOperatorBase<dim, degree, number> &_pde_operator)
+  PDEOperatorBase<dim, degree, number> &_pde_operator,
+  PDEOperatorBase<dim, 1, number>      *_coarse_pde_operator)
   : field_attributes(_field_attributes)
   , solve_blocks(validate_solve_blocks(_solve_blocks, _field_attributes))
   , user_inputs_ptr(&_user_inputs)
@@ -144,7 +150,8 @@ Problem<dim, degree, number>::Problem(
                   dof_manager,
                   constraint_manager,
                   solution_indexer,
-                  _pde_operator)
+                  _pde_operator,
+                  _coarse_pde_operator)
   , grid_refiner(solve_context)
 {
   // Override boundary condition parameters if they are specified in user inputs
@@ -198,6 +205,11 @@ Problem<dim, degree, number>::Problem(
           solve_block.nonlinear_solver_parameters = nonlin_param_it->second;
           nonlinear_solver_parameters_copy.erase(nonlin_param_it);
         }
+      solve_block.validate_jacobian();
+      if (solve_block.automatic_jacobian)
+        {
+          solve_block.dependencies_lhs = solve_block.automatic_jacobian_dependencies();
+        }
     }
   for (const auto &remaining_lin_params : linear_solver_parameters_copy)
     {
@@ -217,6 +229,61 @@ Problem<dim, degree, number>::Problem(
         << " which does not exist in the solve blocks. These parameters will be "
            "ignored.\n";
     }
+
+  assign_coupling_groups();
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+Problem<dim, degree, number>::assign_coupling_groups()
+{
+  const std::vector<CouplingParameters> &coupling_groups =
+    user_inputs_ptr->coupling_solve_parameters.coupling_groups;
+  coupling_group_indices.assign(solve_blocks.size(),
+                                dealii::numbers::invalid_unsigned_int);
+  for (unsigned int group_index = 0; group_index < coupling_groups.size(); ++group_index)
+    {
+      const CouplingParameters &coupling = coupling_groups[group_index];
+      coupling.validate(field_attributes, solve_blocks);
+
+      unsigned int first_position = solve_blocks.size();
+      unsigned int last_position  = 0;
+      for (const int solver_id : coupling.solver_ids)
+        {
+          const auto block_it =
+            std::find_if(solve_blocks.begin(),
+                         solve_blocks.end(),
+                         [&](const SolveBlock &solve_block)
+                         {
+                           return solve_block.id == solver_id;
+                         });
+          AssertThrow(block_it != solve_blocks.end(),
+                      dealii::ExcMessage("Coupling parameters provided for solve block " +
+                                         std::to_string(solver_id) +
+                                         ", which does not exist in the solve blocks."));
+          AssertThrow(block_it->solve_type != SolveType::Constant &&
+                        (block_it->solve_timing == SolveTiming::Primary ||
+                         block_it->solve_timing == SolveTiming::Secondary) &&
+                        block_it->n_substeps == 1 &&
+                        block_it->solve_policy == SolvePolicy::SolveEveryIncrement,
+                      dealii::ExcMessage(
+                        "The coupled solve block " + std::to_string(solver_id) +
+                        " must be a primary or secondary Explicit, Linear, or Newton "
+                        "solve block that is solved every increment without substeps."));
+
+          const unsigned int position = block_it - solve_blocks.begin();
+          AssertThrow(coupling_group_indices[position] ==
+                        dealii::numbers::invalid_unsigned_int,
+                      dealii::ExcMessage("The solve block " + std::to_string(solver_id) +
+                                         " appears in more than one coupling group."));
+          coupling_group_indices[position] = group_index;
+          first_position                   = std::min(first_position, position);
+          last_position                    = std::max(last_position, position);
+        }
+      AssertThrow(last_position + 1 - first_position == coupling.solver_ids.size(),
+                  dealii::ExcMessage("The solve blocks of a coupling group must be "
+                                     "consecutive in the order of the solve blocks."));
+    }
 }
 
 template <unsigned int dim, unsigned int degree, typename number>
@@ -251,6 +318,9 @@ Problem<dim, degree, number>::init_system()
   // Create the dof handlers.
   ConditionalOStreams::pout_base() << "Creating DoFHandlers...\n" << std::flush;
   Timer::start_section("reinitialize DoFHandlers");
+  // The p-multigrid levels need the PDE operator with linear elements
+  dof_manager.set_p_coarsening(use_mg && degree > 1 &&
+                               solve_context.has_coarse_pde_operator());
   dof_manager.reinit(triangulation_manager, use_mg);
   dof_manager.reinit_mapping(field_attributes);
   Timer::end_section("reinitialize DoFHandlers");
@@ -338,9 +408,21 @@ Problem<dim, degree, number>::solve()
   const UserInputParameters<dim> &user_inputs = *user_inputs_ptr;
   const TemporalDiscretization   &time_info   = user_inputs.temporal_discretization;
   SimulationTimer                &sim_timer   = solve_context.get_simulation_timer();
-  // Main time-stepping loop
+  // Main time-stepping loop. If the timestep can change, i.e., if it is limited by the
+  // stable timestep or reduced to retry failed increments, the increments continue until
+  // the end time.
+  const bool variable_timestep = time_info.stable_timestep_mode == StableTimestepLimit ||
+                                 time_info.max_step_retries > 0;
+  const auto before_end = [&]()
+  {
+    return sim_timer.get_increment() <= time_info.n_increments ||
+           (variable_timestep &&
+            sim_timer.get_time() - sim_timer.get_timestep() <
+              time_info.final_time - (1.0e-9 * sim_timer.get_timestep()));
+  };
+  max_timestep = time_info.dt;
   int exit_status = 0;
-  while (sim_timer.get_increment() <= time_info.n_increments && exit_status == 0)
+  while (before_end() && exit_status == 0)
     {
       // Solve a single increment
       // Includes nucleation, refinement, constraints, solve, output, and update
@@ -380,6 +462,12 @@ Problem<dim, degree, number>::solve()
       case 3: // exit triggered by user
         ConditionalOStreams::pout_base() << "\nExiting triggered by user.\n";
         break;
+      case 4: // exit early because every retry of an increment failed
+        AssertThrow(false,
+                    dealii::ExcMessage("The solvers failed at every retry of increment " +
+                                       std::to_string(sim_timer.get_increment()) +
+                                       ". Exiting early.\n"));
+        break;
       default:
         break;
     }
@@ -397,49 +485,133 @@ Problem<dim, degree, number>::solve_increment(SimulationTimer &sim_timer)
   bool is_nucleation_increment =
     user_inputs.nucleation_parameters.should_attempt_nucleation(increment);
 
-  // Update the time-dependent constraints
-  Timer::start_section("Update time-dependent constraints");
-  // TODO: Loop over levels, pass in current time
-  constraint_manager.update_time_dependent_constraints(field_attributes);
-  Timer::end_section("Update time-dependent constraints");
+  // Estimate the stable timestep on the first increment and after remeshing
+  const TemporalDiscretization &time_info = user_inputs.temporal_discretization;
+  if (increment > 0 && stable_timestep_outdated &&
+      time_info.stable_timestep_mode != StableTimestepOff)
+    {
+      update_stable_timestep(sim_timer);
+    }
 
-  // Solve a single increment
-  Timer::start_section("Solvers");
-  for (auto &solver : solvers)
+  // Keep the state at the start of the increment, so that a failed increment can be
+  // retried with a smaller timestep
+  const unsigned int max_attempts = increment > 0 ? time_info.max_step_retries + 1 : 1;
+  if (max_attempts > 1)
     {
-      SolveTiming solve_timing = solver->get_solve_block().solve_timing;
-      if ((solve_timing == PostProcess && !is_output_increment) ||
-          (solve_timing == NucleationRate &&
-           !(is_nucleation_increment || is_output_increment)))
+      for (auto &solver : solvers)
         {
-          continue;
+          solver->get_solution_manager().save_snapshot();
         }
-      solve_context.get_pde_operator().pre_solve_block(solve_context,
-                                                       solver->get_solve_block().id);
-      solver->solve();
-      solver->update_ghosts();
-      solve_context.get_pde_operator().post_solve_block(solve_context,
-                                                        solver->get_solve_block().id);
-    }
-  Timer::end_section("Solvers");
-
-  // Check for NaN. This isn't an exhaustive search. Just a quick check on specific
-  // values.
-  for (unsigned int field_index = 0;
-       field_index < solve_context.get_field_attributes().size();
-       ++field_index)
-    {
-      if (dealii::Utilities::MPI::logical_or(!dealii::numbers::is_finite(
-                                               solve_context.get_solution_indexer()
-                                                 .get_solution_vector(field_index)
-                                                 .local_element(0)),
-                                             MPI_COMM_WORLD))
+    }
+
+  bool         found_nan    = false;
+  bool         solve_failed = false;
+  unsigned int n_attempts   = 0;
+  for (unsigned int attempt = 0; attempt < max_attempts; ++attempt)
+    {
+      ++n_attempts;
+      if (attempt > 0)
+        {
+          for (auto &solver : solvers)
+            {
+              solver->roll_back();
+              if (attempt + 1 < max_attempts)
+                {
+                  solver->get_solution_manager().save_snapshot();
+                }
+            }
+          sim_timer.resize_last_step(sim_timer.get_timestep() *
+                                     time_info.retry_timestep_factor);
+          ConditionalOStreams::pout_base()
+            << "[Increment " << increment << "] Retrying with timestep "
+            << sim_timer.get_timestep() << "\n"
+            << std::flush;
+        }
+
+      // Update the time-dependent constraints
+      Timer::start_section("Update time-dependent constraints");
+      // TODO: Loop over levels, pass in current time
+      constraint_manager.update_time_dependent_constraints(field_attributes);
+      Timer::end_section("Update time-dependent constraints");
+
+      // Solve a single increment. Consecutive solvers with the same number of substeps
+      // are solved together, and the solvers of a coupling group are iterated together.
+      // Solvers with operator splitting compose their local reaction with their
+      // equations in each solve.
+      Timer::start_section("Solvers");
+      solve_failed             = false;
+      unsigned int group_begin = 0;
+      while (group_begin < solvers.size())
+        {
+          const unsigned int coupling_group = coupling_group_indices[group_begin];
+          const unsigned int n_substeps =
+            solvers[group_begin]->get_solve_block().n_substeps;
+          unsigned int group_end = group_begin + 1;
+          while (group_end < solvers.size() &&
+                 coupling_group_indices[group_end] == coupling_group &&
+                 solvers[group_end]->get_solve_block().n_substeps == n_substeps)
+            {
+              ++group_end;
+            }
+          const bool group_failed =
+            coupling_group == dealii::numbers::invalid_unsigned_int || increment == 0
+              ? solve_solvers(group_begin,
+                              group_end,
+                              sim_timer,
+                              is_output_increment,
+                              is_nucleation_increment)
+              : solve_coupled(group_begin,
+                              group_end,
+                              user_inputs.coupling_solve_parameters
+                                .coupling_groups[coupling_group],
+                              sim_timer,
+                              is_output_increment,
+                              is_nucleation_increment);
+          solve_failed = group_failed || solve_failed;
+          group_begin  = group_end;
+        }
+      Timer::end_section("Solvers");
+
+      // Check every locally owned entry of every field for NaN and infinity
+      found_nan = false;
+      for (unsigned int field_index = 0;
+           field_index < solve_context.get_field_attributes().size() && !found_nan;
+           ++field_index)
+        {
+          const SolutionVector<number> &solution =
+            solve_context.get_solution_indexer().get_solution_vector(field_index);
+          found_nan = std::any_of(solution.begin(),
+                                  solution.end(),
+                                  [](number value)
+                                  {
+                                    return !dealii::numbers::is_finite(value);
+                                  });
+        }
+      found_nan = dealii::Utilities::MPI::logical_or(found_nan, MPI_COMM_WORLD);
+      if (!found_nan && !solve_failed)
         {
-          exit_status  = 2;
-          force_output = true;
           break;
         }
     }
+  if (found_nan)
+    {
+      exit_status  = 2;
+      force_output = true;
+    }
+  else if (solve_failed && max_attempts > 1)
+    {
+      exit_status  = 4;
+      force_output = true;
+    }
+
+  // Let the timestep recover after increments that succeeded at the first attempt
+  if (max_attempts > 1 && n_attempts == 1 && !found_nan && !solve_failed &&
+      sim_timer.get_timestep() < max_timestep)
+    {
+      sim_timer.set_timestep(std::min(max_timestep,
+                                      sim_timer.get_timestep() /
+                                        time_info.retry_timestep_factor));
+    }
 
   // Check for user triggered stop
   if (dealii::Utilities::MPI::logical_or(solve_context.get_pde_operator().get_user_stop(),
@@ -466,6 +638,7 @@ Problem<dim, degree, number>::solve_increment(SimulationTimer &sim_timer)
       Timer::start_section("Grid refinement");
       grid_refiner.do_initial_refinement(solvers);
       Timer::end_section("Grid refinement");
+      stable_timestep_outdated = true;
     }
   else if (user_inputs.spatial_discretization.has_adaptivity &&
            (user_inputs.spatial_discretization.should_refine_mesh(increment) ||
@@ -477,6 +650,7 @@ Problem<dim, degree, number>::solve_increment(SimulationTimer &sim_timer)
       Timer::start_section("Grid refinement");
       grid_refiner.do_adaptive_refinement(solvers);
       Timer::end_section("Grid refinement");
+      stable_timestep_outdated = true;
       ConditionalOStreams::pout_base() << "\n" << std::flush;
     }
 
@@ -538,6 +712,266 @@ Problem<dim, degree, number>::solve_increment(SimulationTimer &sim_timer)
   return exit_status;
 }
 
+template <unsigned int dim, unsigned int degree, typename number>
+bool
+Problem<dim, degree, number>::solve_coupled(unsigned int              begin,
+                                            unsigned int              end,
+                                            const CouplingParameters &coupling,
+                                            SimulationTimer          &sim_timer,
+                                            bool                      is_output_increment,
+                                            bool is_nucleation_increment)
+{
+  // The first pass is the sequential solve. Its result is the first iterate.
+  bool failed =
+    solve_solvers(begin, end, sim_timer, is_output_increment, is_nucleation_increment);
+
+  // The coupled fields of the solvers are stacked in one block vector
+  unsigned int n_fields = 0;
+  for (unsigned int index = begin; index < end; ++index)
+    {
+      n_fields += solvers[index]->get_solve_block().field_indices.size();
+    }
+  const auto init_vector = [&](BlockVector<number> &vector)
+  {
+    vector.reinit(n_fields);
+    unsigned int block = 0;
+    for (unsigned int index = begin; index < end; ++index)
+      {
+        const BlockVector<number> &solution =
+          solvers[index]->get_solution_manager().get_solution_full_vector();
+        for (unsigned int field = 0; field < solution.n_blocks(); ++field, ++block)
+          {
+            vector.block(block).reinit(solution.block(field), true);
+          }
+      }
+    vector.collect_sizes();
+  };
+  const auto gather = [&](BlockVector<number> &vector)
+  {
+    unsigned int block = 0;
+    for (unsigned int index = begin; index < end; ++index)
+      {
+        const BlockVector<number> &solution =
+          solvers[index]->get_solution_manager().get_solution_full_vector();
+        for (unsigned int field = 0; field < solution.n_blocks(); ++field, ++block)
+          {
+            vector.block(block).copy_locally_owned_data_from(solution.block(field));
+          }
+      }
+  };
+  const auto scatter = [&](const BlockVector<number> &vector)
+  {
+    unsigned int block = 0;
+    for (unsigned int index = begin; index < end; ++index)
+      {
+        BlockVector<number> &solution =
+          solvers[index]->get_solution_manager().get_solution_full_vector();
+        for (unsigned int field = 0; field < solution.n_blocks(); ++field, ++block)
+          {
+            solution.block(field).copy_locally_owned_data_from(vector.block(block));
+          }
+        solvers[index]->update_ghosts();
+      }
+  };
+
+  // Norm of the change of the coupled fields over one pass. Like the residuals of the
+  // linear and Newton solvers, the change is measured in the L2 norm with the lumped
+  // mass, and normalized with the square root of the volume for the RMSE types and of
+  // the number of fields for the per field types.
+  std::vector<const SolutionVector<number> *> lumped_mass;
+  for (unsigned int index = begin; index < end; ++index)
+    {
+      const std::vector<const SolutionVector<number> *> solver_mass =
+        solve_context.get_invm_manager().get_jxw(
+          solve_context.get_field_attributes(),
+          solvers[index]->get_solve_block().field_indices);
+      lumped_mass.insert(lumped_mass.end(), solver_mass.begin(), solver_mass.end());
+    }
+  double normalization = 1.0;
+  if (coupling.tolerance_type == RMSEPerField || coupling.tolerance_type == RMSETotal)
+    {
+      normalization *= std::sqrt(triangulation_manager.get_volume());
+    }
+  if (coupling.tolerance_type == RMSEPerField ||
+      coupling.tolerance_type == IntegratedPerField)
+    {
+      normalization *= std::sqrt(double(n_fields));
+    }
+  const auto change_norm = [&](const BlockVector<number> &change)
+  {
+    if (coupling.tolerance_type == AbsoluteResidual)
+      {
+        return double(change.l2_norm());
+      }
+    double norm_sqr = 0.0;
+    for (unsigned int block = 0; block < change.n_blocks(); ++block)
+      {
+        const SolutionVector<number> &field_change = change.block(block);
+        const SolutionVector<number> &mass         = *lumped_mass[block];
+        for (unsigned int i = 0; i < field_change.locally_owned_size(); ++i)
+          {
+            norm_sqr += double(mass.local_element(i)) * field_change.local_element(i) *
+                        field_change.local_element(i);
+          }
+      }
+    norm_sqr = dealii::Utilities::MPI::sum(norm_sqr, MPI_COMM_WORLD);
+    return std::sqrt(norm_sqr) / normalization;
+  };
+
+  BlockVector<number> iterate;
+  BlockVector<number> image;
+  BlockVector<number> change;
+  init_vector(iterate);
+  init_vector(image);
+  init_vector(change);
+  gather(iterate);
+
+  AndersonAcceleration<BlockVector<number>> anderson(coupling.anderson_depth,
+                                                     coupling.relaxation);
+  bool                                      converged = coupling.max_iterations == 1;
+  double                                    norm      = 0.0;
+  for (unsigned int pass = 2; pass <= coupling.max_iterations; ++pass)
+    {
+      failed = solve_solvers(begin,
+                             end,
+                             sim_timer,
+                             is_output_increment,
+                             is_nucleation_increment);
+      gather(image);
+      change = image;
+      change -= iterate;
+      norm      = change_norm(change);
+      converged = norm <= coupling.tolerance;
+      if (converged || pass == coupling.max_iterations)
+        {
+          break;
+        }
+      anderson.update(iterate, image);
+      scatter(iterate);
+    }
+  if (!converged)
+    {
+      ConditionalOStreams::pout_base()
+        << "[Increment " << sim_timer.get_increment() << "] Warning: the coupling "
+        << "iterations of solve blocks " << solvers[begin]->get_solve_block().id
+        << " to " << solvers[end - 1]->get_solve_block().id << " did not converge in "
+        << coupling.max_iterations << " passes. Change: " << norm << "\n"
+        << std::flush;
+    }
+  return failed || !converged;
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+bool
+Problem<dim, degree, number>::solve_solvers(unsigned int     begin,
+                                            unsigned int     end,
+                                            SimulationTimer &sim_timer,
+                                            bool             is_output_increment,
+                                            bool             is_nucleation_increment)
+{
+  // The initial conditions are not subcycled
+  const unsigned int n_substeps =
+    sim_timer.get_increment() == 0 ? 1 : solvers[begin]->get_solve_block().n_substeps;
+  const double timestep = sim_timer.get_timestep();
+  const double end_time = sim_timer.get_time();
+  if (n_substeps > 1)
+    {
+      sim_timer.set_timestep(timestep / n_substeps);
+      for (unsigned int index = begin; index < end; ++index)
+        {
+          solvers[index]->get_solution_manager().begin_substeps();
+        }
+    }
+
+  bool failed = false;
+  for (unsigned int substep = 0; substep < n_substeps; ++substep)
+    {
+      if (n_substeps > 1)
+        {
+          sim_timer.set_time(end_time -
+                             (timestep * (n_substeps - substep - 1) / n_substeps));
+        }
+      for (unsigned int index = begin; index < end; ++index)
+        {
+          auto       &solver       = solvers[index];
+          SolveTiming solve_timing = solver->get_solve_block().solve_timing;
+          if ((solve_timing == PostProcess && !is_output_increment) ||
+              (solve_timing == NucleationRate &&
+               !(is_nucleation_increment || is_output_increment)))
+            {
+              continue;
+            }
+          if (substep > 0)
+            {
+              solver->get_solution_manager().advance_substep();
+            }
+          solve_context.get_pde_operator().pre_solve_block(solve_context,
+                                                           solver->get_solve_block().id);
+          solver->solve();
+          solver->update_ghosts();
+          solve_context.get_pde_operator().post_solve_block(solve_context,
+                                                            solver->get_solve_block().id);
+          failed = failed || solver->has_failed();
+        }
+    }
+
+  if (n_substeps > 1)
+    {
+      for (unsigned int index = begin; index < end; ++index)
+        {
+          solvers[index]->get_solution_manager().end_substeps();
+        }
+      sim_timer.set_timestep(timestep);
+      sim_timer.set_time(end_time);
+    }
+  return failed;
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+Problem<dim, degree, number>::update_stable_timestep(SimulationTimer &sim_timer)
+{
+  Timer::start_section("Stable timestep estimate");
+  const TemporalDiscretization &time_info = user_inputs_ptr->temporal_discretization;
+  double                        stable_timestep = std::numeric_limits<double>::max();
+  for (auto &solver : solvers)
+    {
+      // Subcycled solve blocks take several steps per increment
+      const unsigned int n_substeps = solver->get_solve_block().n_substeps;
+      stable_timestep =
+        std::min(stable_timestep, solver->estimate_stable_timestep() * n_substeps);
+    }
+  stable_timestep_outdated = false;
+  Timer::end_section("Stable timestep estimate");
+  if (stable_timestep == std::numeric_limits<double>::max())
+    {
+      return;
+    }
+
+  ConditionalOStreams::pout_summary()
+    << "[Increment " << sim_timer.get_increment()
+    << "] Estimated maximum stable timestep: " << stable_timestep
+    << " (timestep: " << sim_timer.get_timestep() << ")\n"
+    << std::flush;
+  if (time_info.stable_timestep_mode == StableTimestepLimit)
+    {
+      max_timestep =
+        std::min(time_info.dt, time_info.stable_timestep_safety_factor * stable_timestep);
+      // With retries, a timestep that was reduced after a failure recovers gradually
+      const double timestep = time_info.max_step_retries > 0
+                                ? std::min(sim_timer.get_timestep(), max_timestep)
+                                : max_timestep;
+      if (timestep != sim_timer.get_timestep())
+        {
+          ConditionalOStreams::pout_base()
+            << "[Increment " << sim_timer.get_increment()
+            << "] Timestep set to " << timestep << "\n"
+            << std::flush;
+          sim_timer.resize_last_step(timestep);
+        }
+    }
+}
+
 template <unsigned int dim, unsigned int degree, typename number>
 const SolveContext<dim, degree, number> &
 Problem<dim, degree, number>::get_solve_context() const
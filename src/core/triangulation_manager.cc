@@ -46,7 +46,8 @@ TriangulationManager<dim>::init_mg()
     dealii::MGTransferGlobalCoarseningTools::create_geometric_coarsening_sequence(
       triangulation);
   std::reverse(coarsened_triangulations.begin(), coarsened_triangulations.end());
-  // TODO (landinjm): p-multigrid
+  // The p-multigrid level reuses the active triangulation, so it is added by the
+  // DoFManager.
 }
 
 template <unsigned int dim>
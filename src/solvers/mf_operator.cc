@@ -4,6 +4,8 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/types.h>
 #include <deal.II/base/vectorization.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/vector_operation.h>
 
 #include <prismspf/core/exceptions.h>
 #include <prismspf/core/field_container.h>
@@ -19,6 +21,10 @@ MFOperator<dim, degree, number>::compute_operator(BlockVector<number>       &dst
                                                   const BlockVector<number> &src) const
 {
   data->cell_loop(&MFOperator::compute_local_operator, this, dst, src, true);
+  if (!lumped_mass.empty())
+    {
+      add_mass_terms(dst, src);
+    }
   if (scale_by_diagonal)
     {
       for (unsigned int block_index = 0; block_index < dst.n_blocks(); block_index++)
@@ -28,6 +34,36 @@ MFOperator<dim, degree, number>::compute_operator(BlockVector<number>       &dst
     }
 }
 
+template <unsigned int dim, unsigned int degree, typename number>
+void
+MFOperator<dim, degree, number>::add_mass_terms(BlockVector<number>       &dst,
+                                                const BlockVector<number> &src) const
+{
+  const bool   has_src     = src_weight != 0.0;
+  unsigned int block_index = 0;
+  for (unsigned int field_index : solve_block.field_indices)
+    {
+      SolutionVector<number>       &dst_block = dst.block(block_index);
+      const SolutionVector<number> &mass      = *(lumped_mass[block_index]);
+      for (unsigned int i = 0; i < dst_block.locally_owned_size(); ++i)
+        {
+          double term = has_src ? src_weight * src.block(block_index).local_element(i)
+                                : 0.0;
+          for (const auto &[weight, vector] : vector_terms)
+            {
+              term += weight * vector->block(block_index).local_element(i);
+            }
+          dst_block.local_element(i) += number(term) * mass.local_element(i);
+        }
+      // The cell loop leaves the constrained rows zero
+      for (const unsigned int i : data->get_constrained_dofs(field_index))
+        {
+          dst_block.local_element(i) = 0.0;
+        }
+      ++block_index;
+    }
+}
+
 template <unsigned int dim, unsigned int degree, typename number>
 void
 MFOperator<dim, degree, number>::compute_local_operator(
@@ -46,6 +82,7 @@ MFOperator<dim, degree, number>::compute_local_operator(
                                                     dependency_map,
                                                     solve_block,
                                                     _data);
+  variable_list.set_linearize(linearize);
 
   // Initialize, evaluate, and submit based on user function.
   for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
@@ -83,6 +120,24 @@ MFOperator<dim, degree, number>::compute_diagonal(BlockVector<number>       &dst
 {
   dst.reinit(src);
   data->cell_loop(&MFOperator::compute_local_diagonal, this, dst, src);
+  if (!lumped_mass.empty() && src_weight != 0.0)
+    {
+      unsigned int block_index = 0;
+      for (unsigned int field_index : solve_block.field_indices)
+        {
+          SolutionVector<number>       &dst_block = dst.block(block_index);
+          const SolutionVector<number> &mass      = *(lumped_mass[block_index]);
+          for (unsigned int i = 0; i < dst_block.locally_owned_size(); ++i)
+            {
+              dst_block.local_element(i) += number(src_weight) * mass.local_element(i);
+            }
+          for (const unsigned int i : data->get_constrained_dofs(field_index))
+            {
+              dst_block.local_element(i) = 0.0;
+            }
+          ++block_index;
+        }
+    }
   if (scale_by_diagonal)
     {
       for (unsigned int block_index = 0; block_index < dst.n_blocks(); block_index++)
@@ -111,6 +166,7 @@ MFOperator<dim, degree, number>::compute_local_diagonal(
                                                     dependency_map,
                                                     solve_block,
                                                     _data);
+  variable_list.set_linearize(linearize);
 
   for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
     {
@@ -266,17 +322,427 @@ MFOperator<dim, degree, number>::m() const
 
 template <unsigned int dim, unsigned int degree, typename number>
 number
-MFOperator<dim, degree, number>::el([[maybe_unused]] const unsigned int &row,
-                                    [[maybe_unused]] const unsigned int &col) const
+MFOperator<dim, degree, number>::el(const unsigned int &row,
+                                    const unsigned int &col) const
 {
-  AssertThrow(false, FeatureNotImplemented("el()"));
-  return 0.0;
+  AssertThrow(matrix_assembled, FeatureNotImplemented("el() without assembled matrix"));
+
+  // Convert the global index of the block system to the local index of the matrix
+  const auto to_local = [this](unsigned int index) -> unsigned int
+  {
+    unsigned int block_index = 0;
+    for (unsigned int field_index : solve_block.field_indices)
+      {
+        const auto &partitioner = data->get_vector_partitioner(field_index);
+        if (index < partitioner->size())
+          {
+            AssertThrow(partitioner->in_local_range(index) ||
+                          partitioner->is_ghost_entry(index),
+                        dealii::ExcMessage("The matrix entry is not locally relevant"));
+            return local_block_offsets[block_index] + partitioner->global_to_local(index);
+          }
+        index -= partitioner->size();
+        ++block_index;
+      }
+    AssertThrow(false, dealii::ExcIndexRange(index, 0, m()));
+    return 0;
+  };
+  return sparse_matrix.el(to_local(row), to_local(col));
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+MFOperator<dim, degree, number>::assemble_matrix(
+  const std::vector<const dealii::AffineConstraints<number> *> &constraints)
+{
+  Assert(data != nullptr, dealii::ExcNotInitialized());
+
+  // Local numbering: the owned and then the ghost DoFs of each block, in the layout of
+  // the vector storage
+  local_block_offsets.assign(1, 0);
+  for (unsigned int field_index : solve_block.field_indices)
+    {
+      const auto &partitioner = data->get_vector_partitioner(field_index);
+      local_block_offsets.push_back(local_block_offsets.back() +
+                                    partitioner->locally_owned_size() +
+                                    partitioner->n_ghost_indices());
+    }
+  const unsigned int n_local = local_block_offsets.back();
+
+  std::vector<std::vector<std::pair<unsigned int, number>>> resolved;
+
+  // The sparsity pattern only changes with the mesh
+  if (sparsity_pattern.empty())
+    {
+      dealii::DynamicSparsityPattern dynamic_pattern(n_local, n_local);
+      for (unsigned int cell = 0; cell < data->n_cell_batches(); ++cell)
+        {
+          for (unsigned int lane = 0; lane < data->n_active_entries_per_cell_batch(cell);
+               ++lane)
+            {
+              resolve_cell_dofs(cell, lane, constraints, resolved);
+              for (const auto &row_entries : resolved)
+                {
+                  for (const auto &row_entry : row_entries)
+                    {
+                      for (const auto &col_entries : resolved)
+                        {
+                          for (const auto &col_entry : col_entries)
+                            {
+                              dynamic_pattern.add(row_entry.first, col_entry.first);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+      sparse_matrix.clear();
+      sparsity_pattern.copy_from(dynamic_pattern);
+      sparse_matrix.reinit(sparsity_pattern);
+      local_src.reinit(n_local);
+      local_dst.reinit(n_local);
+    }
+  sparse_matrix = 0.0;
+
+  // Number of cell DoFs of all solved fields
+  constexpr static unsigned int dofs_per_component =
+    FieldContainer<dim, degree, number>::dofs_per_component;
+  const auto n_components = [this](unsigned int field_index) -> unsigned int
+  {
+    return field_attributes[field_index].field_type == TensorRank::Vector ? dim : 1;
+  };
+  unsigned int n_cell_dofs = 0;
+  for (unsigned int field_index : solve_block.field_indices)
+    {
+      n_cell_dofs += n_components(field_index) * dofs_per_component;
+    }
+
+  BlockVector<number> dummy_src;
+  if (relative_level == -1)
+    {
+      matrix_free_manager->initialize_block_vector(dummy_src, solve_block.field_indices);
+    }
+  else
+    {
+      matrix_free_manager->initialize_mg_block_vector(dummy_src,
+                                                      solve_block.field_indices,
+                                                      relative_level);
+    }
+
+  FieldContainer<dim, degree, number> variable_list(field_attributes,
+                                                    *solution_indexer,
+                                                    relative_level,
+                                                    dependency_map,
+                                                    solve_block,
+                                                    *data);
+  variable_list.set_linearize(linearize);
+
+  dealii::AlignedVector<ScalarValue> cell_matrix(n_cell_dofs * n_cell_dofs);
+  for (unsigned int cell = 0; cell < data->n_cell_batches(); ++cell)
+    {
+      variable_list.reinit_and_eval(cell, &dummy_src, false);
+
+      // Apply the operator to each unit vector of the cell DoFs, which gives the cell
+      // matrix one column at a time for all lanes of the batch
+      unsigned int col = 0;
+      for (unsigned int field_index : solve_block.field_indices)
+        {
+          for (unsigned int component = 0; component < n_components(field_index);
+               ++component)
+            {
+              for (unsigned int node = 0; node < dofs_per_component; ++node)
+                {
+                  for (unsigned int some_field_index : solve_block.field_indices)
+                    {
+                      for (unsigned int i = 0; i < dofs_per_component; ++i)
+                        {
+                          if (field_attributes[some_field_index].field_type ==
+                              TensorRank::Scalar)
+                            {
+                              variable_list.submit_dof_value(some_field_index,
+                                                             zero<TensorRank::Scalar>(),
+                                                             i);
+                            }
+                          else
+                            {
+                              variable_list.submit_dof_value(some_field_index,
+                                                             zero<TensorRank::Vector>(),
+                                                             i);
+                            }
+                        }
+                    }
+                  if (field_attributes[field_index].field_type == TensorRank::Scalar)
+                    {
+                      submit_unit_dof_value<TensorRank::Scalar>(variable_list,
+                                                                field_index,
+                                                                node,
+                                                                component);
+                    }
+                  else
+                    {
+                      submit_unit_dof_value<TensorRank::Vector>(variable_list,
+                                                                field_index,
+                                                                node,
+                                                                component);
+                    }
+
+                  variable_list.eval_without_read();
+                  for (unsigned int quad = 0; quad < variable_list.get_n_q_points();
+                       ++quad)
+                    {
+                      variable_list.set_q_point(quad);
+                      try
+                        {
+                          (pde_operator->*pde_op)(variable_list,
+                                                  *sim_timer,
+                                                  solve_block.id);
+                        }
+                      catch (...)
+                        {
+                          std::cerr << "Error: Exception thrown in equations during "
+                                       "solve block "
+                                    << solve_block.id << "!" << std::endl;
+                          throw;
+                        }
+                    }
+                  variable_list.integrate();
+
+                  unsigned int row = 0;
+                  for (unsigned int row_field_index : solve_block.field_indices)
+                    {
+                      for (unsigned int row_component = 0;
+                           row_component < n_components(row_field_index);
+                           ++row_component)
+                        {
+                          for (unsigned int row_node = 0; row_node < dofs_per_component;
+                               ++row_node)
+                            {
+                              cell_matrix[(row * n_cell_dofs) + col] =
+                                field_attributes[row_field_index].field_type ==
+                                    TensorRank::Scalar
+                                  ? get_dof_value_component<TensorRank::Scalar>(
+                                      variable_list,
+                                      row_field_index,
+                                      row_node,
+                                      row_component)
+                                  : get_dof_value_component<TensorRank::Vector>(
+                                      variable_list,
+                                      row_field_index,
+                                      row_node,
+                                      row_component);
+                              ++row;
+                            }
+                        }
+                    }
+                  ++col;
+                }
+            }
+        }
+
+      // Distribute the cell matrices of the lanes with the constraints resolved
+      for (unsigned int lane = 0; lane < data->n_active_entries_per_cell_batch(cell);
+           ++lane)
+        {
+          resolve_cell_dofs(cell, lane, constraints, resolved);
+          for (unsigned int i = 0; i < n_cell_dofs; ++i)
+            {
+              for (unsigned int j = 0; j < n_cell_dofs; ++j)
+                {
+                  const number value = cell_matrix[(i * n_cell_dofs) + j][lane];
+                  if (value == number(0.0))
+                    {
+                      continue;
+                    }
+                  for (const auto &[row, row_weight] : resolved[i])
+                    {
+                      for (const auto &[col, col_weight] : resolved[j])
+                        {
+                          sparse_matrix.add(row, col, row_weight * col_weight * value);
+                        }
+                    }
+                }
+            }
+        }
+    }
+  matrix_assembled = true;
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+MFOperator<dim, degree, number>::resolve_cell_dofs(
+  unsigned int                                                  cell,
+  unsigned int                                                  lane,
+  const std::vector<const dealii::AffineConstraints<number> *> &constraints,
+  std::vector<std::vector<std::pair<unsigned int, number>>>    &resolved) const
+{
+  resolved.clear();
+  std::vector<dealii::types::global_dof_index> dof_indices;
+  unsigned int                                 block_index = 0;
+  for (unsigned int field_index : solve_block.field_indices)
+    {
+      const auto &partitioner  = data->get_vector_partitioner(field_index);
+      const auto &constraint   = *(constraints[field_index]);
+      const auto  cell_pointer = data->get_cell_iterator(cell, lane, field_index);
+      dof_indices.resize(cell_pointer->get_fe().n_dofs_per_cell());
+      cell_pointer->get_dof_indices(dof_indices);
+
+      // FEEvaluation orders the cell DoFs lexicographically within each component
+      const std::vector<unsigned int> &lexicographic =
+        data->get_shape_info(field_index).lexicographic_numbering;
+      Assert(lexicographic.size() == dof_indices.size(),
+             dealii::ExcDimensionMismatch(lexicographic.size(), dof_indices.size()));
+
+      const auto to_local = [&](dealii::types::global_dof_index index) -> unsigned int
+      {
+        return local_block_offsets[block_index] + partitioner->global_to_local(index);
+      };
+      for (unsigned int i = 0; i < dof_indices.size(); ++i)
+        {
+          const dealii::types::global_dof_index index   = dof_indices[lexicographic[i]];
+          auto                                 &entries = resolved.emplace_back();
+          if (!constraint.is_constrained(index))
+            {
+              entries.emplace_back(to_local(index), number(1.0));
+            }
+          else if (const auto *constraint_entries =
+                     constraint.get_constraint_entries(index))
+            {
+              // Hanging nodes. Dirichlet DoFs have no entries and drop out.
+              for (const auto &[target, weight] : *constraint_entries)
+                {
+                  entries.emplace_back(to_local(target), weight);
+                }
+            }
+        }
+      ++block_index;
+    }
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+template <TensorRank Rank>
+void
+MFOperator<dim, degree, number>::submit_unit_dof_value(
+  FieldContainer<dim, degree, number> &variable_list,
+  unsigned int                         field_index,
+  unsigned int                         node,
+  [[maybe_unused]] unsigned int        component) const
+{
+  Value<Rank> value = zero<Rank>();
+  if constexpr (Rank == TensorRank::Scalar || dim == 1)
+    {
+      value = ScalarValue(1.0);
+    }
+  else
+    {
+      value[component] = ScalarValue(1.0);
+    }
+  variable_list.submit_dof_value(field_index, value, node);
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+template <TensorRank Rank>
+typename MFOperator<dim, degree, number>::ScalarValue
+MFOperator<dim, degree, number>::get_dof_value_component(
+  FieldContainer<dim, degree, number> &variable_list,
+  unsigned int                         field_index,
+  unsigned int                         node,
+  [[maybe_unused]] unsigned int        component) const
+{
+  Value<Rank> value = zero<Rank>();
+  variable_list.get_dof_value_to(value, field_index, node);
+  if constexpr (Rank == TensorRank::Scalar || dim == 1)
+    {
+      return value;
+    }
+  else
+    {
+      return value[component];
+    }
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+MFOperator<dim, degree, number>::clear_matrix()
+{
+  sparse_matrix.clear();
+  sparsity_pattern.reinit(0, 0, 0);
+  local_block_offsets.clear();
+  local_src.reinit(0);
+  local_dst.reinit(0);
+  matrix_assembled     = false;
+  use_assembled_matrix = false;
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+bool
+MFOperator<dim, degree, number>::is_matrix_assembled() const
+{
+  return matrix_assembled;
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+MFOperator<dim, degree, number>::set_use_assembled_matrix(bool use)
+{
+  Assert(!use || matrix_assembled, dealii::ExcNotInitialized());
+  use_assembled_matrix = use;
+}
+
+template <unsigned int dim, unsigned int degree, typename number>
+void
+MFOperator<dim, degree, number>::assembled_vmult(BlockVector<number>       &dst,
+                                                 const BlockVector<number> &src) const
+{
+  const bool src_has_ghosts = src.has_ghost_elements();
+  if (!src_has_ghosts)
+    {
+      src.update_ghost_values();
+    }
+  for (unsigned int block_index = 0; block_index < src.n_blocks(); block_index++)
+    {
+      const unsigned int offset = local_block_offsets[block_index];
+      for (unsigned int i = 0; i < local_block_offsets[block_index + 1] - offset; ++i)
+        {
+          local_src(offset + i) = src.block(block_index).local_element(i);
+        }
+    }
+  if (!src_has_ghosts)
+    {
+      src.zero_out_ghost_values();
+    }
+
+  sparse_matrix.vmult(local_dst, local_src);
+
+  // The ghost entries hold the contributions of the locally owned cells to DoFs owned by
+  // other processes
+  for (unsigned int block_index = 0; block_index < dst.n_blocks(); block_index++)
+    {
+      const unsigned int offset = local_block_offsets[block_index];
+      for (unsigned int i = 0; i < local_block_offsets[block_index + 1] - offset; ++i)
+        {
+          dst.block(block_index).local_element(i) = local_dst(offset + i);
+        }
+    }
+  dst.compress(dealii::VectorOperation::add);
+
+  if (!lumped_mass.empty())
+    {
+      add_mass_terms(dst, src);
+    }
+  if (scale_by_diagonal)
+    {
+      for (unsigned int block_index = 0; block_index < dst.n_blocks(); block_index++)
+        {
+          dst.block(block_index).scale(*(scaling_diagonal[block_index]));
+        }
+    }
 }
 
 template <unsigned int dim, unsigned int degree, typename number>
 void
 MFOperator<dim, degree, number>::clear()
 {
+  clear_matrix();
   data = nullptr;
   diagonal_entries.reset();
   inverse_diagonal_entries.reset();
@@ -303,7 +769,14 @@ void
 MFOperator<dim, degree, number>::vmult(BlockVector<number>       &dst,
                                        const BlockVector<number> &src) const
 {
-  compute_operator(dst, src);
+  if (use_assembled_matrix && !read_plain)
+    {
+      assembled_vmult(dst, src);
+    }
+  else
+    {
+      compute_operator(dst, src);
+    }
 }
 
 // NOLINTBEGIN(readability-identifier-naming)
@@ -8,11 +8,17 @@ void
 LinearSolverParameters::declare(dealii::ParameterHandler &parameter_handler,
                                 unsigned int              n_subsections)
 {
+  const std::string solver_names =
+    dealii::SolverSelector<>::get_solver_names() + "|pipelined_cg|s_step_cg|deflated_cg";
   parameter_handler.declare_entry(
     "solver type",
     "cg",
-    dealii::Patterns::Selection(dealii::SolverSelector<>::get_solver_names()),
-    "The type of iterative solver to use for linear solves.");
+    dealii::Patterns::Selection(solver_names),
+    "The type of iterative solver to use for linear solves. pipelined_cg overlaps the "
+    "global reductions of CG with the operator application and s_step_cg performs one "
+    "global reduction per s-step size iterations. Both are for symmetric positive "
+    "definite systems on many processes. deflated_cg recycles approximate eigenvectors "
+    "of the operator between the solves of slowly changing systems.");
   declare_aliases(parameter_handler,
                   "solver type",
                   std::vector {"solver_type",
@@ -22,6 +28,23 @@ LinearSolverParameters::declare(dealii::ParameterHandler &parameter_handler,
                                "linear_solver",
                                "type"});
 
+  parameter_handler.declare_entry("s-step size",
+                                  "4",
+                                  dealii::Patterns::Integer(1, 16),
+                                  "The number of CG steps per global reduction of the "
+                                  "s_step_cg solver.");
+  parameter_handler.declare_alias("s-step size", "s_step_size");
+  parameter_handler.declare_entry("deflation space size",
+                                  "8",
+                                  dealii::Patterns::Integer(0, INT_MAX),
+                                  "The number of approximate eigenvectors the "
+                                  "deflated_cg solver recycles between solves.");
+  parameter_handler.declare_entry("deflation harvest size",
+                                  "20",
+                                  dealii::Patterns::Integer(0, INT_MAX),
+                                  "The number of search directions of each deflated_cg "
+                                  "solve that are used to update the recycled vectors.");
+
   parameter_handler.declare_entry("tolerance type",
                                   "AbsoluteResidual",
                                   dealii::Patterns::Selection(
@@ -45,18 +68,146 @@ LinearSolverParameters::declare(dealii::ParameterHandler &parameter_handler,
   parameter_handler.declare_entry("mg depth",
                                   "1",
                                   dealii::Patterns::Integer(1, INT_MAX),
-                                  "The depth of the multigrid hierarchy.");
+                                  "The number of levels of the multigrid hierarchy, "
+                                  "including the active mesh. The levels are the "
+                                  "geometric coarsening sequence of the current mesh. "
+                                  "If the application supplies a PDE operator with "
+                                  "linear elements, the second level is the active mesh "
+                                  "with linear elements and the geometric levels below "
+                                  "it use linear elements too.");
   parameter_handler.declare_alias("mg depth", "mg_depth");
 
   parameter_handler.declare_entry(
     "preconditioner type",
     "None",
-    dealii::Patterns::Selection("None|Chebyshev|GMG|none|chebyshev|gmg|MG|mg|multigrid"),
-    "The preconditioner type for the linear solver.");
+    dealii::Patterns::Selection(
+      "None|Chebyshev|GMG|Block|none|chebyshev|gmg|MG|mg|multigrid|block"),
+    "The preconditioner type for the linear solver. Block is meant for solve blocks with "
+    "several coupled fields and is configured by the block parameters. If the LHS only "
+    "depends on the solved fields, the preconditioner is built once and reused until "
+    "the time step or the mesh changes.");
   declare_aliases(parameter_handler,
                   "preconditioner type",
                   std::vector {"preconditioner_type", "preconditioner"});
 
+  parameter_handler.declare_entry(
+    "mg coarse solver",
+    "Smoother",
+    dealii::Patterns::Selection("Smoother|CG|Direct|smoother|cg|direct"),
+    "The coarse grid solver of the multigrid preconditioner. Smoother applies the level "
+    "smoother once, CG iterates Chebyshev-preconditioned CG to the coarse tolerance, and "
+    "Direct factorizes the assembled coarse matrix whenever the preconditioner is "
+    "rebuilt, which is limited to coarse problems of at most 4000 degrees of "
+    "freedom.");
+  parameter_handler.declare_alias("mg coarse solver", "mg_coarse_solver");
+  parameter_handler.declare_entry("mg coarse tolerance",
+                                  "1.0e-3",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The relative tolerance of the CG coarse grid solver.");
+  parameter_handler.declare_entry(
+    "mg coarse max iterations",
+    "100",
+    dealii::Patterns::Integer(1, INT_MAX),
+    "The maximum number of iterations of the CG coarse grid solver.");
+  parameter_handler.declare_entry(
+    "mg smoother",
+    "Chebyshev",
+    dealii::Patterns::Selection("Chebyshev|FDMChebyshev|Schwarz|chebyshev|"
+                                "fdm_chebyshev|schwarz"),
+    "The level smoother of the multigrid preconditioner. Chebyshev is preconditioned "
+    "with the inverse diagonal, FDMChebyshev with cell-wise fast diagonalization, and "
+    "Schwarz is a damped additive Schwarz iteration with the same cell inverses. The "
+    "fast diagonalization smoothers are meant for Laplace-like operators, particularly "
+    "for degree 2 and higher.");
+  parameter_handler.declare_alias("mg smoother", "mg_smoother");
+  parameter_handler.declare_entry("schwarz damping",
+                                  "0.7",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The damping of the additive Schwarz smoother.");
+  parameter_handler.declare_entry("schwarz smoothing steps",
+                                  "2",
+                                  dealii::Patterns::Integer(1, INT_MAX),
+                                  "The number of additive Schwarz smoothing steps.");
+
+  parameter_handler.declare_entry(
+    "block form",
+    "LowerTriangular",
+    dealii::Patterns::Selection("Diagonal|LowerTriangular|UpperTriangular|Schur|diagonal|"
+                                "lower_triangular|upper_triangular|schur"),
+    "The form of the block preconditioner. Schur solves an approximate Schur complement "
+    "with a few GMRES iterations, so it is a variable preconditioner and should be used "
+    "with FGMRES.");
+  parameter_handler.declare_alias("block form", "block_form");
+  parameter_handler.declare_entry(
+    "block inner solve",
+    "Chebyshev",
+    dealii::Patterns::Selection("Chebyshev|GMG|chebyshev|gmg|MG|mg|multigrid"),
+    "The approximate inverse of each diagonal block of the block preconditioner. "
+    "Chebyshev iterates on the diagonal of the block and GMG applies one multigrid "
+    "V-cycle on the block, with mg depth levels that are smoothed with the same "
+    "Chebyshev iteration.");
+  parameter_handler.declare_alias("block inner solve", "block_inner_solve");
+  parameter_handler.declare_entry("block split",
+                                  "1",
+                                  dealii::Patterns::Integer(1, INT_MAX),
+                                  "The number of fields of the solve block, in order of "
+                                  "their index, that form the first diagonal block. The "
+                                  "remaining fields form the second diagonal block.");
+  parameter_handler.declare_alias("block split", "block_split");
+  parameter_handler.declare_entry(
+    "schur inner iterations",
+    "2",
+    dealii::Patterns::Integer(1, INT_MAX),
+    "The number of GMRES iterations on the approximate Schur complement.");
+
+  parameter_handler.declare_entry(
+    "operator backend",
+    "MatrixFree",
+    dealii::Patterns::Selection("MatrixFree|Assembled|Auto|matrix_free|assembled|auto"),
+    "How the LHS operator is applied. MatrixFree evaluates the operator on the fly. "
+    "Assembled builds a sparse matrix from the operator, once per mesh and timestep if "
+    "the LHS only depends on the solved fields and otherwise, e.g., for Newton "
+    "Jacobians, before every linear solve. An LHS that depends on the time explicitly "
+    "has to declare a field dependency to be reassembled. Auto times both on the first "
+    "solve after each mesh change and keeps the faster one. Assembly pays off mostly "
+    "for degree 1 elements.");
+  parameter_handler.declare_alias("operator backend", "operator_backend");
+
+  parameter_handler.declare_entry(
+    "autotune",
+    "false",
+    dealii::Patterns::Bool(),
+    "Whether to time a sweep of preconditioner settings on a representative linear "
+    "system and use the fastest converging one for the rest of the run. Newton blocks "
+    "use the linear system of their first Newton iteration. The sweep covers no "
+    "preconditioner, Chebyshev degrees and smoothing ranges, and, with the GMG "
+    "preconditioner, multigrid depths. The choice is written to the summary log.");
+  parameter_handler.declare_entry("autotune increment",
+                                  "0",
+                                  dealii::Patterns::Integer(0, INT_MAX),
+                                  "The increment whose linear system is used for the "
+                                  "autotune sweep. The first linear solve at or after "
+                                  "this increment is used.");
+  parameter_handler.declare_entry(
+    "autotune solver types",
+    "",
+    dealii::Patterns::List(dealii::Patterns::Selection(solver_names), 0, UINT_MAX, ","),
+    "The solver types that are included in the autotune sweep. Empty keeps the solver "
+    "type.");
+
+  parameter_handler.declare_entry(
+    "initial guess extrapolation order",
+    "0",
+    dealii::Patterns::Integer(0, 3),
+    "The order of the polynomial extrapolation in time of the previous solutions that "
+    "is used as the initial guess. Zero uses the previous solution.");
+  parameter_handler.declare_entry(
+    "initial guess projection size",
+    "0",
+    dealii::Patterns::Integer(0, 8),
+    "The number of previous solutions the initial guess of a linear solve is projected "
+    "onto, by minimizing the residual in their span. Zero disables the projection.");
+
   // Now declare parameters for each of the solver's AdditionalData structures.
   parameter_handler.enter_subsection("Chebyshev");
   {
@@ -86,6 +237,11 @@ LinearSolverParameters::assign(dealii::ParameterHandler &parameter_handler,
 {
   // Set the linear solver type
   solver_type = parameter_handler.get("solver type");
+  s_step_size = (unsigned int) (parameter_handler.get_integer("s-step size"));
+  deflation_space_size =
+    (unsigned int) (parameter_handler.get_integer("deflation space size"));
+  deflation_harvest_size =
+    (unsigned int) (parameter_handler.get_integer("deflation harvest size"));
 
   // Set the tolerance type
   static const std::map<std::string, SolverToleranceType> tolerance_types = {
@@ -120,10 +276,91 @@ LinearSolverParameters::assign(dealii::ParameterHandler &parameter_handler,
     {"gmg",       GMG      },
     {"MG",        GMG      },
     {"mg",        GMG      },
-    {"multigrid", GMG      }
+    {"multigrid", GMG      },
+    {"Block",     Block    },
+    {"block",     Block    }
   };
   preconditioner = preconditioner_map.at(parameter_handler.get("preconditioner type"));
 
+  // Set the multigrid coarse grid solver
+  static const std::map<std::string, MGCoarseSolverType> coarse_solver_map = {
+    {"Smoother", CoarseSmoother   },
+    {"smoother", CoarseSmoother   },
+    {"CG",       CoarseChebyshevCG},
+    {"cg",       CoarseChebyshevCG},
+    {"Direct",   CoarseDirect     },
+    {"direct",   CoarseDirect     }
+  };
+  mg_coarse_solver    = coarse_solver_map.at(parameter_handler.get("mg coarse solver"));
+  mg_coarse_tolerance = parameter_handler.get_double("mg coarse tolerance");
+  mg_coarse_max_iterations =
+    (unsigned int) (parameter_handler.get_integer("mg coarse max iterations"));
+
+  // Set the multigrid smoother
+  static const std::map<std::string, MGSmootherType> smoother_map = {
+    {"Chebyshev",     SmootherJacobiChebyshev},
+    {"chebyshev",     SmootherJacobiChebyshev},
+    {"FDMChebyshev",  SmootherFDMChebyshev   },
+    {"fdm_chebyshev", SmootherFDMChebyshev   },
+    {"Schwarz",       SmootherFDMSchwarz     },
+    {"schwarz",       SmootherFDMSchwarz     }
+  };
+  mg_smoother     = smoother_map.at(parameter_handler.get("mg smoother"));
+  schwarz_damping = parameter_handler.get_double("schwarz damping");
+  schwarz_steps =
+    (unsigned int) (parameter_handler.get_integer("schwarz smoothing steps"));
+
+  // Set the block preconditioner
+  static const std::map<std::string, BlockPreconditionerForm> block_form_map = {
+    {"Diagonal",         BlockDiagonal       },
+    {"diagonal",         BlockDiagonal       },
+    {"LowerTriangular",  BlockLowerTriangular},
+    {"lower_triangular", BlockLowerTriangular},
+    {"UpperTriangular",  BlockUpperTriangular},
+    {"upper_triangular", BlockUpperTriangular},
+    {"Schur",            BlockSchurComplement},
+    {"schur",            BlockSchurComplement}
+  };
+  block_form  = block_form_map.at(parameter_handler.get("block form"));
+  static const std::map<std::string, BlockInnerSolveType> block_inner_solve_map = {
+    {"Chebyshev", BlockInnerChebyshev},
+    {"chebyshev", BlockInnerChebyshev},
+    {"GMG",       BlockInnerGMG      },
+    {"gmg",       BlockInnerGMG      },
+    {"MG",        BlockInnerGMG      },
+    {"mg",        BlockInnerGMG      },
+    {"multigrid", BlockInnerGMG      }
+  };
+  block_inner_solve =
+    block_inner_solve_map.at(parameter_handler.get("block inner solve"));
+  block_split = (unsigned int) (parameter_handler.get_integer("block split"));
+  schur_inner_iterations =
+    (unsigned int) (parameter_handler.get_integer("schur inner iterations"));
+
+  // Set the operator backend
+  static const std::map<std::string, OperatorBackend> backend_map = {
+    {"MatrixFree",  BackendMatrixFree},
+    {"matrix_free", BackendMatrixFree},
+    {"Assembled",   BackendAssembled },
+    {"assembled",   BackendAssembled },
+    {"Auto",        BackendAuto      },
+    {"auto",        BackendAuto      }
+  };
+  operator_backend = backend_map.at(parameter_handler.get("operator backend"));
+
+  // Set the autotune parameters
+  autotune = parameter_handler.get_bool("autotune");
+  autotune_increment =
+    (unsigned int) (parameter_handler.get_integer("autotune increment"));
+  autotune_solver_types =
+    dealii::Utilities::split_string_list(parameter_handler.get("autotune solver types"));
+
+  // Set the initial guess parameters
+  extrapolation_order =
+    (unsigned int) (parameter_handler.get_integer("initial guess extrapolation order"));
+  projection_size =
+    (unsigned int) (parameter_handler.get_integer("initial guess projection size"));
+
   parameter_handler.enter_subsection("Chebyshev");
   {
     assign_chebyshev(parameter_handler);
@@ -368,24 +605,44 @@ NonlinearSolverParameters::declare(dealii::ParameterHandler &parameter_handler,
                                   "The value of for the nonlinear solver tolerance.");
   parameter_handler.declare_alias("tolerance value", "tolerance");
 
-  /*         parameter_handler.declare_entry(
-        "use backtracking line search",
-        "true",
-        dealii::Patterns::Bool(),
-        "Whether to use a backtracking line-search to find the best "
-        "choice of the damping coefficient.");
-      parameter_handler.declare_entry(
-        "step size modifier",
-        "0.5",
-        dealii::Patterns::Double(0.0, 1.0),
-        "The constant that determines how much the step size decreases "
-        "per backtrack. The 'tau' parameter.");
-      parameter_handler.declare_entry(
-        "residual decrease coefficient",
-        "0.5",
-        dealii::Patterns::Double(0.0, 1.0),
-        "The constant that determines how much the residual must "
-        "decrease to be accepted as sufficient. The 'c' parameter."); */
+  parameter_handler.declare_entry(
+    "globalization",
+    "None",
+    dealii::Patterns::Selection("None|Backtracking|CriticalPoint|TrustRegion|none|"
+                                "backtracking|Armijo|armijo|critical point|cp|"
+                                "trust region|Dogleg|dogleg"),
+    "The globalization strategy of the Newton solver. None applies the constant step "
+    "size, Backtracking reduces the step until the Armijo condition holds, "
+    "CriticalPoint searches for a critical point of the residual norm along the Newton "
+    "direction, and TrustRegion takes dogleg steps. TrustRegion requires a symmetric "
+    "Jacobian, solved with a CG linear solver.");
+  declare_aliases(parameter_handler,
+                  "globalization",
+                  std::vector {"line search", "line_search"});
+  parameter_handler.declare_entry(
+    "step size modifier",
+    "0.5",
+    dealii::Patterns::Double(0.0, 1.0),
+    "The constant that determines how much the step size decreases "
+    "per backtrack. The 'tau' parameter.");
+  parameter_handler.declare_entry(
+    "residual decrease coefficient",
+    "1.0e-4",
+    dealii::Patterns::Double(0.0, 1.0),
+    "The constant that determines how much the residual must "
+    "decrease to be accepted as sufficient. The 'c' parameter.");
+  parameter_handler.declare_entry(
+    "max line search iterations",
+    "10",
+    dealii::Patterns::Integer(1, INT_MAX),
+    "The maximum number of line search iterations, or trust region reductions, per "
+    "Newton step.");
+  parameter_handler.declare_entry(
+    "initial trust region radius",
+    "0.0",
+    dealii::Patterns::Double(0.0, DBL_MAX),
+    "The initial trust region radius in the l2 norm of the update. Zero uses the length "
+    "of the first Newton update.");
 
   parameter_handler.declare_entry(
     "step size",
@@ -393,6 +650,48 @@ NonlinearSolverParameters::declare(dealii::ParameterHandler &parameter_handler,
     dealii::Patterns::Double(0.0),
     "The constant damping value to be used if the backtrace "
     "line-search approach isn't used.");
+
+  parameter_handler.declare_entry(
+    "jacobian free",
+    "false",
+    dealii::Patterns::Bool(),
+    "Whether to approximate the Jacobian-vector products by finite differences of the "
+    "residual (JFNK). The LHS equations are then only used by the preconditioner.");
+  declare_aliases(parameter_handler, "jacobian free", std::vector {"jacobian_free", "jfnk"});
+  parameter_handler.declare_entry(
+    "finite difference step",
+    "0.0",
+    dealii::Patterns::Double(0.0, 1.0),
+    "The relative step of the Jacobian-free finite differences. Zero uses the square "
+    "root of the machine epsilon.");
+
+  parameter_handler.declare_entry(
+    "use eisenstat walker",
+    "false",
+    dealii::Patterns::Bool(),
+    "Whether to set the linear solver tolerance of each Newton iteration with "
+    "Eisenstat-Walker forcing terms instead of the fixed linear tolerance.");
+  declare_aliases(parameter_handler,
+                  "use eisenstat walker",
+                  std::vector {"use_eisenstat_walker", "eisenstat walker"});
+  parameter_handler.declare_entry("initial forcing term",
+                                  "0.5",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The forcing term of the first Newton iteration.");
+  parameter_handler.declare_entry("max forcing term",
+                                  "0.9",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The upper bound of the forcing terms.");
+  parameter_handler.declare_entry("forcing term gamma",
+                                  "0.9",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The gamma parameter of the Eisenstat-Walker forcing "
+                                  "terms.");
+  parameter_handler.declare_entry("forcing term alpha",
+                                  "2.0",
+                                  dealii::Patterns::Double(1.0, 2.0),
+                                  "The alpha parameter of the Eisenstat-Walker forcing "
+                                  "terms.");
 }
 
 void
@@ -403,7 +702,39 @@ NonlinearSolverParameters::assign(dealii::ParameterHandler &parameter_handler,
 
   step_length = parameter_handler.get_double("step size");
 
+  static const std::map<std::string, NewtonGlobalization> globalization_map = {
+    {"None",           FixedStep    },
+    {"none",           FixedStep    },
+    {"Backtracking",   Backtracking },
+    {"backtracking",   Backtracking },
+    {"Armijo",         Backtracking },
+    {"armijo",         Backtracking },
+    {"CriticalPoint",  CriticalPoint},
+    {"critical point", CriticalPoint},
+    {"cp",             CriticalPoint},
+    {"TrustRegion",    TrustRegion  },
+    {"trust region",   TrustRegion  },
+    {"Dogleg",         TrustRegion  },
+    {"dogleg",         TrustRegion  }
+  };
+  globalization = globalization_map.at(parameter_handler.get("globalization"));
+  step_size_modifier = parameter_handler.get_double("step size modifier");
+  residual_decrease_coefficient =
+    parameter_handler.get_double("residual decrease coefficient");
+  max_line_search_iterations =
+    (unsigned int) (parameter_handler.get_integer("max line search iterations"));
+  initial_trust_region_radius = parameter_handler.get_double("initial trust region radius");
+
   tolerance_value = parameter_handler.get_double("tolerance value");
+
+  jacobian_free          = parameter_handler.get_bool("jacobian free");
+  finite_difference_step = parameter_handler.get_double("finite difference step");
+
+  eisenstat_walker     = parameter_handler.get_bool("use eisenstat walker");
+  initial_forcing_term = parameter_handler.get_double("initial forcing term");
+  max_forcing_term     = parameter_handler.get_double("max forcing term");
+  forcing_term_gamma   = parameter_handler.get_double("forcing term gamma");
+  forcing_term_alpha   = parameter_handler.get_double("forcing term alpha");
 }
 
 void
@@ -476,4 +807,138 @@ NonlinearSolveParameters::validate(const std::vector<FieldAttributes> &field_att
     }
 }
 
+void
+CouplingParameters::declare(dealii::ParameterHandler &parameter_handler,
+                            unsigned int              n_subsections)
+{
+  parameter_handler.declare_entry("max iterations",
+                                  "10",
+                                  dealii::Patterns::Integer(1, INT_MAX),
+                                  "The maximum number of passes over the coupled solve "
+                                  "blocks per increment.");
+
+  parameter_handler.declare_entry("tolerance type",
+                                  "AbsoluteResidual",
+                                  dealii::Patterns::Selection(
+                                    "AbsoluteResidual|RMSEPerField|IntegratedPerField|"
+                                    "RMSETotal|IntegratedTotal"),
+                                  "The tolerance type for the change of the coupled "
+                                  "fields over one pass, normalized like the residual "
+                                  "of the linear and nonlinear solvers. The change is "
+                                  "measured in the L2 norm, which the RMSE types divide "
+                                  "by the square root of the domain volume.");
+
+  parameter_handler.declare_entry("tolerance value",
+                                  "1.0e-8",
+                                  dealii::Patterns::Double(0.0, DBL_MAX),
+                                  "The value of the coupling tolerance.");
+  parameter_handler.declare_alias("tolerance value", "tolerance");
+
+  parameter_handler.declare_entry(
+    "anderson depth",
+    "5",
+    dealii::Patterns::Integer(0, INT_MAX),
+    "The number of previous iterates that the Anderson acceleration of the coupling "
+    "iterations combines. Zero gives a relaxed fixed-point iteration.");
+  declare_aliases(parameter_handler,
+                  "anderson depth",
+                  std::vector {"anderson_depth", "diis depth", "diis_depth"});
+
+  parameter_handler.declare_entry("relaxation",
+                                  "1.0",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The relaxation of the fixed-point update of the "
+                                  "coupled fields.");
+}
+
+void
+CouplingParameters::assign(dealii::ParameterHandler &parameter_handler,
+                           unsigned int              n_subsections)
+{
+  max_iterations = (unsigned int) (parameter_handler.get_integer("max iterations"));
+
+  static const std::map<std::string, SolverToleranceType> tolerance_types = {
+    {"AbsoluteResidual",   AbsoluteResidual  },
+    {"RMSEPerField",       RMSEPerField      },
+    {"IntegratedPerField", IntegratedPerField},
+    {"RMSETotal",          RMSETotal         },
+    {"IntegratedTotal",    IntegratedTotal   },
+  };
+  tolerance_type = tolerance_types.at(parameter_handler.get("tolerance type"));
+  tolerance      = parameter_handler.get_double("tolerance value");
+
+  anderson_depth = (unsigned int) (parameter_handler.get_integer("anderson depth"));
+  relaxation     = parameter_handler.get_double("relaxation");
+}
+
+void
+CouplingParameters::validate(const std::vector<FieldAttributes> &field_attributes,
+                             const std::vector<SolveBlock>      &solve_blocks) const
+{
+  AssertThrow(relaxation > 0.0,
+              dealii::ExcMessage("The coupling relaxation must be greater than 0."));
+}
+
+void
+CouplingSolveParameters::declare(dealii::ParameterHandler &parameter_handler,
+                                 unsigned int              n_subsections)
+{
+  for (unsigned int criterion_id = 0; criterion_id < n_subsections; criterion_id++)
+    {
+      std::string subsection_text =
+        "coupling parameters: " + std::to_string(criterion_id);
+      parameter_handler.enter_subsection(subsection_text);
+      {
+        parameter_handler.declare_entry(
+          "solver_ids",
+          "",
+          dealii::Patterns::List(dealii::Patterns::Anything(), 0, INT_MAX, ","),
+          "The ids of the solvers that are iterated together within each increment. "
+          "They must be consecutive in the order of the solve blocks.");
+        declare_aliases(parameter_handler,
+                        "solver_ids",
+                        std::vector {"solve blocks",
+                                     "solve_blocks",
+                                     "solve block ids",
+                                     "solve_block_ids",
+                                     "solver ids"});
+        CouplingParameters::declare(parameter_handler);
+      }
+      parameter_handler.leave_subsection();
+    }
+}
+
+void
+CouplingSolveParameters::assign(dealii::ParameterHandler &parameter_handler,
+                                unsigned int              n_subsections)
+{
+  for (unsigned int criterion_id = 0; criterion_id < n_subsections; criterion_id++)
+    {
+      std::string subsection_text =
+        "coupling parameters: " + std::to_string(criterion_id);
+      parameter_handler.enter_subsection(subsection_text);
+      {
+        CouplingParameters coupling_group;
+        coupling_group.solver_ids = dealii::Utilities::string_to_int(
+          dealii::Utilities::split_string_list(parameter_handler.get("solver_ids")));
+        if (!coupling_group.solver_ids.empty())
+          {
+            coupling_group.assign(parameter_handler);
+            coupling_groups.push_back(coupling_group);
+          }
+      }
+      parameter_handler.leave_subsection();
+    }
+}
+
+void
+CouplingSolveParameters::validate(const std::vector<FieldAttributes> &field_attributes,
+                                  const std::vector<SolveBlock>      &solve_blocks) const
+{
+  for (const auto &coupling_group : coupling_groups)
+    {
+      coupling_group.validate(field_attributes, solve_blocks);
+    }
+}
+
 PRISMS_PF_END_NAMESPACE
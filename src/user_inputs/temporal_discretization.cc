@@ -5,6 +5,9 @@
 
 #include <prismspf/config.h>
 
+#include <map>
+#include <string>
+
 PRISMS_PF_BEGIN_NAMESPACE
 
 TemporalDiscretization::TemporalDiscretization(double       _dt,
@@ -13,6 +16,7 @@ TemporalDiscretization::TemporalDiscretization(double       _dt,
   : dt(_dt)
   , initial_time(_initial_time)
   , n_increments(_n_increments)
+  , final_time(_initial_time + (_n_increments * _dt))
 {}
 
 TemporalDiscretization::TemporalDiscretization(double _dt,
@@ -23,6 +27,7 @@ TemporalDiscretization::TemporalDiscretization(double _dt,
   , n_increments(_final_time == _initial_time
                    ? 0
                    : (unsigned int) std::ceil((_final_time - _initial_time) / _dt))
+  , final_time(_final_time)
 {
   AssertThrow(initial_time <= _final_time,
               dealii::ExcMessage(
@@ -83,6 +88,44 @@ TemporalDiscretization::declare(dealii::ParameterHandler &parameter_handler,
   declare_aliases(parameter_handler,
                   "end time",
                   std::vector {"end_time", "t_f", "tf", "final time", "final_time"});
+
+  parameter_handler.declare_entry(
+    "stable timestep",
+    "Off",
+    dealii::Patterns::Selection("Off|Report|Limit|off|report|limit"),
+    "Whether the maximum stable timestep of the explicit solve blocks is estimated, "
+    "with power iterations on the linearization of their RHS, on the first increment "
+    "and after every remeshing. Report writes the estimate to the summary. Limit also "
+    "reduces the timestep to the safety factor times the estimate, and then continues "
+    "the increments until the end time. Outputs are still scheduled in increments of "
+    "the time step from the input file.");
+  parameter_handler.declare_alias("stable timestep", "stable_timestep");
+  parameter_handler.declare_entry("stable timestep safety factor",
+                                  "0.8",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The fraction of the estimated maximum stable "
+                                  "timestep that the timestep is limited to.");
+  parameter_handler.declare_entry("stable timestep power iterations",
+                                  "20",
+                                  dealii::Patterns::Integer(1, INT_MAX),
+                                  "The number of power iterations of the estimate of "
+                                  "the largest eigenvalue of each explicit solve block.");
+
+  parameter_handler.declare_entry(
+    "max step retries",
+    "0",
+    dealii::Patterns::Integer(0, INT_MAX),
+    "The number of times an increment is rolled back and retried with a smaller timestep "
+    "when a Newton solve does not converge or the solution contains NaN. With retries, "
+    "the increments continue until the end time and the timestep grows back by the "
+    "inverse of the retry factor after every increment that succeeds at once. The "
+    "simulation stops if every retry of an increment fails.");
+  parameter_handler.declare_alias("max step retries", "max_step_retries");
+  parameter_handler.declare_entry("retry timestep factor",
+                                  "0.5",
+                                  dealii::Patterns::Double(0.0, 1.0),
+                                  "The factor that the timestep is multiplied with on "
+                                  "each retry of an increment.");
 }
 
 void
@@ -92,7 +135,7 @@ TemporalDiscretization::assign(dealii::ParameterHandler &parameter_handler,
   n_increments      = (unsigned int) parameter_handler.get_integer("final increment");
   dt                = parameter_handler.get_double("time step");
   initial_time      = parameter_handler.get_double("start time");
-  double final_time = parameter_handler.get_double("end time");
+  final_time        = parameter_handler.get_double("end time");
 
   if (final_time > 0.0)
     {
@@ -101,6 +144,26 @@ TemporalDiscretization::assign(dealii::ParameterHandler &parameter_handler,
                     "Initial time must be less than or equal to final time."));
       n_increments = std::ceil((final_time - initial_time) / dt);
     }
+  else
+    {
+      final_time = initial_time + (n_increments * dt);
+    }
+
+  static const std::map<std::string, StableTimestepMode> stable_timestep_map = {
+    {"Off",    StableTimestepOff   },
+    {"off",    StableTimestepOff   },
+    {"Report", StableTimestepReport},
+    {"report", StableTimestepReport},
+    {"Limit",  StableTimestepLimit },
+    {"limit",  StableTimestepLimit }
+  };
+  stable_timestep_mode = stable_timestep_map.at(parameter_handler.get("stable timestep"));
+  stable_timestep_safety_factor =
+    parameter_handler.get_double("stable timestep safety factor");
+  stable_timestep_power_iterations =
+    parameter_handler.get_integer("stable timestep power iterations");
+  max_step_retries      = parameter_handler.get_integer("max step retries");
+  retry_timestep_factor = parameter_handler.get_double("retry timestep factor");
 }
 
 void
@@ -111,6 +174,9 @@ TemporalDiscretization::validate(
   AssertThrow(n_increments == 0 || dt > 0.0,
               dealii::ExcMessage(
                 "Time step must be greater than 0 for transient problems."));
+  AssertThrow(max_step_retries == 0 || retry_timestep_factor > 0.0,
+              dealii::ExcMessage(
+                "The retry timestep factor must be greater than 0 to retry increments."));
 }
 
 PRISMS_PF_END_NAMESPACE
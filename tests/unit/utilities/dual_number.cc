@@ -0,0 +1,122 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <prismspf/utilities/dual_number.h>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+
+template <typename Number, std::size_t width = dealii::VectorizedArray<Number>::size()>
+void
+check_all_lanes_rel(const dealii::VectorizedArray<Number, width> &result,
+                    const Number                                  expected,
+                    const Number                                  tol)
+{
+  for (std::size_t i = 0; i < width; ++i)
+    {
+      CHECK_THAT(result[i], Catch::Matchers::WithinRel(expected, tol));
+    }
+}
+
+TEMPLATE_TEST_CASE("DualNumber follows the differentiation rules",
+                   "[vectorized][dual_number]",
+                   float,
+                   double)
+{
+  using VecArray     = dealii::VectorizedArray<TestType>;
+  using Dual     = prismspf::DualNumber<VecArray>;
+
+  constexpr auto tol = TestType(1e-5);
+
+  const TestType a  = TestType(0.7);
+  const TestType b  = TestType(1.3);
+  const TestType da = TestType(0.4);
+  const TestType db = TestType(-0.9);
+  const Dual     x(VecArray(a), VecArray(da));
+  const Dual     y(VecArray(b), VecArray(db));
+
+  SECTION("arithmetic")
+  {
+    const Dual product = x * y;
+    check_all_lanes_rel(product.value, a * b, tol);
+    check_all_lanes_rel(product.derivative, (da * b) + (a * db), tol);
+
+    const Dual quotient = x / y;
+    check_all_lanes_rel(quotient.value, a / b, tol);
+    check_all_lanes_rel(quotient.derivative, ((da * b) - (a * db)) / (b * b), tol);
+
+    const Dual reciprocal = VecArray(2.0) / y;
+    check_all_lanes_rel(reciprocal.derivative, TestType(-2.0) * db / (b * b), tol);
+
+    const Dual difference = VecArray(1.0) - x;
+    check_all_lanes_rel(difference.value, TestType(1.0) - a, tol);
+    check_all_lanes_rel(difference.derivative, -da, tol);
+  }
+
+  SECTION("elementary functions")
+  {
+    check_all_lanes_rel(std::sqrt(x).derivative,
+                        da / (TestType(2.0) * std::sqrt(a)),
+                        tol);
+    check_all_lanes_rel(std::exp(x).derivative, std::exp(a) * da, tol);
+    check_all_lanes_rel(std::log(x).derivative, da / a, tol);
+    check_all_lanes_rel(std::pow(x, TestType(3.0)).derivative,
+                        TestType(3.0) * a * a * da,
+                        tol);
+    check_all_lanes_rel(std::sin(x).derivative, std::cos(a) * da, tol);
+    check_all_lanes_rel(std::cos(x).derivative, -std::sin(a) * da, tol);
+  }
+}
+
+TEMPLATE_TEST_CASE("jacobian_term of a Newton residual matches the hand-written LHS",
+                   "[vectorized][dual_number][jacobian]",
+                   float,
+                   double)
+{
+  // The implicit Allen-Cahn equation of applications/allen_cahn/implicit. compute_rhs
+  // submits the negative residual and compute_lhs the Jacobian product by hand.
+  constexpr unsigned int dim = 2;
+
+  using VecArray     = dealii::VectorizedArray<TestType>;
+  using Gradient     = dealii::Tensor<1, dim, VecArray>;
+  using DualValue    = prismspf::DualNumber<VecArray>;
+  using DualGradient = prismspf::DualNumber<Gradient>;
+
+  constexpr auto tol      = TestType(1e-5);
+  const VecArray timestep = TestType(0.01);
+  const VecArray m_well   = TestType(1.2);
+  const VecArray kappa    = TestType(2.0);
+
+  const VecArray n        = TestType(0.3);
+  const VecArray old_n    = TestType(0.25);
+  const VecArray change_n = TestType(0.7);
+  Gradient       nx;
+  Gradient       change_nx;
+  nx[0]        = TestType(0.4);
+  nx[1]        = TestType(-0.1);
+  change_nx[0] = TestType(1.5);
+  change_nx[1] = TestType(0.5);
+
+  // Residual with dual numbers, seeded with the change like a linearized FieldContainer
+  const DualValue    dual_n(n, change_n);
+  const DualGradient dual_nx(nx, change_nx);
+  const DualValue    f_well =
+    VecArray(4.0) * dual_n * (dual_n - VecArray(1.0)) * (dual_n - VecArray(0.5));
+  const DualValue    eq_n  = old_n - dual_n - (timestep * m_well * f_well);
+  const DualGradient eqx_n = -timestep * kappa * m_well * dual_nx;
+
+  // Hand-written Jacobian product
+  const VecArray df_well = (TestType(12.0) * n * (n - TestType(1.0))) + TestType(2.0);
+  const VecArray eq_change_n =
+    change_n * (TestType(1.0) + (timestep * m_well * df_well));
+  const Gradient eqx_change_n = timestep * kappa * m_well * change_nx;
+
+  check_all_lanes_rel(prismspf::jacobian_term(eq_n), eq_change_n[0], tol);
+  const Gradient gradient_term = prismspf::jacobian_term(eqx_n);
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      check_all_lanes_rel(gradient_term[d], eqx_change_n[d][0], tol);
+    }
+}
@@ -0,0 +1,63 @@
+#include <prismspf/core/simulation_timer.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <vector>
+
+void
+check_coefficients(const std::vector<double> &result,
+                   const std::vector<double> &expected,
+                   const double               tol)
+{
+  REQUIRE(result.size() == expected.size());
+  for (std::size_t j = 0; j < expected.size(); ++j)
+    {
+      CHECK_THAT(result[j], Catch::Matchers::WithinRel(expected[j], tol));
+    }
+}
+
+TEST_CASE("SimulationTimer::get_bdf_coefficients matches the BDF formulas",
+          "[simulation_timer][bdf]")
+{
+  constexpr double tol = 1e-12;
+
+  SECTION("constant step")
+  {
+    const double              dt = 0.1;
+    prismspf::SimulationTimer timer(dt);
+    for (unsigned int step = 0; step < 3; ++step)
+      {
+        timer.increment();
+      }
+    REQUIRE(timer.get_n_previous_timesteps() == 3);
+
+    check_coefficients(timer.get_bdf_coefficients(1), {1.0 / dt, -1.0 / dt}, tol);
+    check_coefficients(timer.get_bdf_coefficients(2),
+                       {3.0 / (2.0 * dt), -2.0 / dt, 1.0 / (2.0 * dt)},
+                       tol);
+    check_coefficients(timer.get_bdf_coefficients(3),
+                       {11.0 / (6.0 * dt),
+                        -3.0 / dt,
+                        3.0 / (2.0 * dt),
+                        -1.0 / (3.0 * dt)},
+                       tol);
+  }
+
+  SECTION("variable step BDF2")
+  {
+    // Step ratio omega = dt_n / dt_{n-1}
+    const double              dt_old = 0.2;
+    const double              dt_new = 0.1;
+    const double              omega  = dt_new / dt_old;
+    prismspf::SimulationTimer timer;
+    timer.increment(dt_old);
+    timer.increment(dt_new);
+    REQUIRE(timer.get_n_previous_timesteps() == 2);
+
+    check_coefficients(timer.get_bdf_coefficients(2),
+                       {(1.0 + 2.0 * omega) / ((1.0 + omega) * dt_new),
+                        -(1.0 + omega) / dt_new,
+                        omega * omega / ((1.0 + omega) * dt_new)},
+                       tol);
+  }
+}